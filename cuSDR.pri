@@ -7,6 +7,7 @@ HEADERS += \
 	./src/Util/cusdr_led.h \
 	./src/Util/cusdr_painter.h \
 	./src/Util/cusdr_queue.h \
+	./src/Util/cusdr_frameRing.h \
 	./src/Util/cusdr_splash.h \
 	./src/Util/cusdr_styles.h \
 	./src/Util/cusdr_cpuUsage.h \
@@ -23,21 +24,28 @@ HEADERS += \
 	./src/DataEngine/cusdr_chirpProcessor.h \
 	./src/DataEngine/cusdr_dataEngine.h \
 	./src/DataEngine/cusdr_dataIO.h \
+	./src/DataEngine/cusdr_iqUnpacker.h \
 	./src/DataEngine/cusdr_discoverer.h \
 	./src/DataEngine/cusdr_receiver.h \
 	./src/QtDSP/fftw3.h \
 	./src/QtDSP/qtdsp_demodulation.h \
 	./src/QtDSP/qtdsp_dspEngine.h \
-	./src/QtDSP/qtdsp_dualModeAverager.h \
 	./src/QtDSP/qtdsp_fft.h \
 	./src/QtDSP/qtdsp_filter.h \
 	./src/QtDSP/qtdsp_powerSpectrum.h \
 	./src/QtDSP/qtdsp_invsinc_coeff.h \
 	./src/QtDSP/qtdsp_qComplex.h \
 	./src/QtDSP/qtdsp_signalMeter.h \
+	./src/QtDSP/qtdsp_simd.h \
+	./src/QtDSP/qtdsp_envelope.h \
+	./src/QtDSP/qtdsp_powerAverager.h \
+	./src/QtDSP/qtdsp_kernels.h \
+	./src/QtDSP/qtdsp_decimator.h \
+	./src/QtDSP/qtdsp_nco.h \
 	./src/QtDSP/qtdsp_wpagc.h \
 	./src/GL/cusdr_oglDisplayPanel.h \
 	./src/GL/cusdr_oglDistancePanel.h \
+	./src/GL/cusdr_oglDisplayPrep.h \
 	./src/GL/cusdr_oglInfo.h \
 	./src/GL/cusdr_oglReceiverPanel.h \
 	./src/GL/cusdr_oglText.h \
@@ -92,18 +100,25 @@ SOURCES += \
 	./src/DataEngine/cusdr_chirpProcessor.cpp \
 	./src/DataEngine/cusdr_dataEngine.cpp \
 	./src/DataEngine/cusdr_dataIO.cpp \
+	./src/DataEngine/cusdr_iqUnpacker.cpp \
 	./src/DataEngine/cusdr_discoverer.cpp \
 	./src/DataEngine/cusdr_receiver.cpp \
 	./src/QtDSP/qtdsp_demodulation.cpp \
 	./src/QtDSP/qtdsp_dspEngine.cpp \
-	./src/QtDSP/qtdsp_dualModeAverager.cpp \
+	./src/QtDSP/qtdsp_decimator.cpp \
+	./src/QtDSP/qtdsp_nco.cpp \
 	./src/QtDSP/qtdsp_fft.cpp \
 	./src/QtDSP/qtdsp_filter.cpp \
 	./src/QtDSP/qtdsp_powerSpectrum.cpp \
 	./src/QtDSP/qtdsp_signalMeter.cpp \
+	./src/QtDSP/qtdsp_simd.cpp \
+	./src/QtDSP/qtdsp_envelope.cpp \
+	./src/QtDSP/qtdsp_powerAverager.cpp \
+	./src/QtDSP/qtdsp_kernels.cpp \
 	./src/QtDSP/qtdsp_wpagc.cpp \
 	./src/GL/cusdr_oglDisplayPanel.cpp \
 	./src/GL/cusdr_oglDistancePanel.cpp \
+	./src/GL/cusdr_oglDisplayPrep.cpp \
 	./src/GL/cusdr_oglInfo.cpp \
 	./src/GL/cusdr_oglReceiverPanel.cpp \
 	./src/GL/cusdr_oglText.cpp \
@@ -37,6 +37,10 @@ ChirpProcessor::ChirpProcessor(THPSDRParameter *ioData)
 	, m_specMin(0.0f)
 	, m_sampleRate(set->getSampleRate())
 	, m_downRate(set->getChirpDownSampleRate())
+	, m_blockSize(BUFFERSIZE / m_downRate)
+	, m_chirpLength(1)
+	, m_historyPos(0)
+	, m_frameLags(0)
 	, m_specAvgLength(1)
 	, m_filterLowerFrequency((float)set->getChirpFilterLowerFrequency())
 	, m_filterUpperFrequency((float)set->getChirpFilterUpperFrequency())
@@ -44,6 +48,8 @@ ChirpProcessor::ChirpProcessor(THPSDRParameter *ioData)
 	, m_showChirpFFT(false)
 	, m_chirpBufferLength(set->getChirpBufferLength())
 	, m_chirpSidebandFactor(1.0f)
+	, m_nextPosition(-1)
+	, m_frame(-1)
 {
 	/*m_QCPXin = initQCPX(BUFFERSIZE);
 	m_temp0  = initQCPX(BUFFERSIZE);
@@ -68,16 +74,13 @@ ChirpProcessor::ChirpProcessor(THPSDRParameter *ioData)
 	*/
 	m_cpxIn.resize(BUFFERSIZE);
 	m_tmp0.resize(BUFFERSIZE);
-	m_tmp2.resize(BUFFERSIZE/m_downRate);
+	m_tmp1.resize(m_blockSize);
+	m_tmp2.resize(m_blockSize);
 
 	m_cpxInFilt.resize(FULL_BUFFERSIZE);
 	m_cpxRxFFT.resize(FULL_BUFFERSIZE);
-	m_tmp1.resize(FULL_BUFFERSIZE);
 	m_tmp3.resize(FULL_BUFFERSIZE);
-	m_cpxChirpIn.resize(FULL_BUFFERSIZE);
-	m_cpxChirpOut.resize(FULL_BUFFERSIZE);
-	m_cpxChirpTmp.resize(FULL_BUFFERSIZE);
-	m_cpxOut.resize(FULL_BUFFERSIZE);
+	m_cpxOut.resize(CHIRP_LAGS);
 
 
 	/*
@@ -95,8 +98,8 @@ ChirpProcessor::ChirpProcessor(THPSDRParameter *ioData)
 	memset(m_cpxChirpTmp, 0, FULL_BUFFERSIZE * sizeof(CPX));
 	*/
 
-	// FFTs by fftw
-	m_chirpFFT = new QFFT(FULL_BUFFERSIZE);
+	// FFT of the received signal, shown instead of the distance if
+	// m_showChirpFFT is set
 	m_matchedFFT = new QFFT(FULL_BUFFERSIZE);
 
 	// FIR band pass filter
@@ -108,6 +111,11 @@ ChirpProcessor::ChirpProcessor(THPSDRParameter *ioData)
 	m_filter->setFilter(500.0f, 2500.0f);
 	m_filter->setStreamMode(true);
 
+	// matched filter at the decimated rate; generateLocalChirp() loads the taps
+	m_matchedFilter = new QFilter(this, m_blockSize, 3, 12);
+	m_matchedFilter->setMaxFilterLength(FULL_BUFFERSIZE);
+	m_matchedFilter->setStreamMode(true);
+
 	setupConnections();
 }
 
@@ -138,13 +146,14 @@ ChirpProcessor::~ChirpProcessor() {
 	delete m_tmp1;
 	*/
 	
-	delete m_chirpFFT;
 	delete m_matchedFFT;
 }
 
 void ChirpProcessor::stop() {
 
+	m_mutex.lock();
 	m_stopped = true;
+	m_mutex.unlock();
 }
 
 void ChirpProcessor::setupConnections() {
@@ -203,8 +212,17 @@ void ChirpProcessor::processChirpData() {
 
 	forever {
 
-		//matchedFilter(io->chirp_queue.dequeue());
-		matchedFilterFIRFilter(io->chirp_queue.dequeue());
+		// blocks until a block is in or stop() releases the ring
+		int length = 0;
+		const char *block = io->chirp_queue.readSlot(&length);
+
+		if (block) {
+
+			if (length == BUFFERSIZE * 2 * (int) sizeof(float))
+				processBlock((const float *) block, io->chirp_queue.readTimestamp());
+
+			io->chirp_queue.commitRead();
+		}
 		
 		m_mutex.lock();
 		if (m_stopped) {
@@ -216,131 +234,116 @@ void ChirpProcessor::processChirpData() {
 	}
 }
 
-void ChirpProcessor::matchedFilterFIRFilter(QList<qreal> data) {
-
-	int dataLength = data.length();
-	int dataIdx = 0;
-	int buffer = 0;
-	int newsize = (int)(BUFFERSIZE / m_downRate);
+void ChirpProcessor::processBlock(const float *iq, qint64 position) {
 
-	CHIRP_PROCESSOR_DEBUG << "start matched filter - samples:" << dataLength;
+	// a gap (a block dropped by a full ring) spoils the frame in progress
+	if (position != m_nextPosition)
+		m_frameLags = 0;
 
-	// filtering to 2kHz by constant-overlap-add (COLA)
-	while (dataIdx < dataLength) {
-		
-		dataIdx = 2 * buffer * BUFFERSIZE;
-		for (int i = 0; i < 2 * BUFFERSIZE; i += 2) {
-	
-			if (dataIdx + i + 1 < dataLength) {
-				
-				m_cpxIn[i/2].re = data.at(dataIdx + i);
-				m_cpxIn[i/2].im = data.at(dataIdx + i + 1);
-			}
-			else {
-
-				dataIdx = dataLength;
-				break;
-			}
-		}
-		
-		// BPF 2.5 kHz
-		m_filter->ProcessFilter(m_cpxIn, m_tmp0, BUFFERSIZE);
+	m_nextPosition = position + BUFFERSIZE;
 
-		// decimate by 4
-		decimate(m_tmp0, m_tmp2, BUFFERSIZE, m_downRate);
+	for (int i = 0; i < BUFFERSIZE; i++) {
 
-		for (int i = 0; i < newsize; i++) {
-
-			m_cpxInFilt[buffer * newsize + i].re = m_tmp2[i].re;
-			m_cpxInFilt[buffer * newsize + i].im = m_tmp2[i].im;
-		}
-		buffer++;
+		m_cpxIn[i].re = iq[2*i];
+		m_cpxIn[i].im = iq[2*i + 1];
 	}
 
-	// Due to the COLA method the filter output gets shifet by BUFFERSIZE/2 bytes.
-	// In order to have a buffer in full chirp length, we save the last newsize/2 bytes
-	// (due to decimation by downrate) and add it to the beginning of the newbuffer.
-	for (int i = 0; i < FULL_BUFFERSIZE - newsize/2; i++) {
+	// BPF 2.5 kHz
+	m_filter->ProcessFilter(m_cpxIn, m_tmp0, BUFFERSIZE);
 
-		if (i < newsize/2) {
+	// decimate by m_downRate
+	decimate(m_tmp0, m_tmp2, BUFFERSIZE, m_downRate);
 
-			m_cpxInFilt[i].re = m_tmp3[i].re;
-			m_cpxInFilt[i].im = m_tmp3[i].im;
-		}
-		else {
+	// keep the last FULL_BUFFERSIZE samples for the spectrum view
+	for (int i = 0; i < m_blockSize; i++) {
 
-			m_cpxInFilt[i].re = m_cpxInFilt[i + newsize/2].re;
-			m_cpxInFilt[i].im = m_cpxInFilt[i + newsize/2].im;
-		}
-		
+		m_cpxInFilt[m_historyPos] = m_tmp2.at(i);
+		m_historyPos = (m_historyPos + 1) & (FULL_BUFFERSIZE - 1);
 	}
 
-	// save the last buffer
-	for (int i = 0; i < newsize/2; i++) {
+	// correlation with the local chirp
+	m_matchedFilter->ProcessFilter(m_tmp2, m_tmp1, m_blockSize);
 
-		m_tmp3[i].re = m_tmp2[i].re;
-		m_tmp3[i].im = m_tmp2[i].im;
+	// a new chirp was faded in over this block; the lags of the frame in
+	// progress do not line up any more
+	int chirpLength = m_matchedFilter->activeLength();
+	if (chirpLength != m_chirpLength) {
+
+		m_chirpLength = chirpLength;
+		m_frameLags = 0;
 	}
 
-	// map rx signal to the frequency domain
-	m_matchedFFT->DoFFTWForward(m_cpxInFilt, m_cpxRxFFT, FULL_BUFFERSIZE);
-	
-	// multiply the chirp signal with the complex conjugate of the received signal
-	for (int i = 0; i < FULL_BUFFERSIZE; i++) {
-		
-		// f * ~g
-		m_tmp1[i].re = (m_cpxChirpOut[i].re * m_cpxRxFFT[i].re) + (m_cpxChirpOut[i].im * m_cpxRxFFT[i].im);
-		m_tmp1[i].im = (m_cpxChirpOut[i].im * m_cpxRxFFT[i].re) - (m_cpxChirpOut[i].re * m_cpxRxFFT[i].im);
+	// output sample i is lag q mod rate of the frame starting at the
+	// second q / rate, with q its decimated position minus the delays of
+	// the band pass (half its length) and of the matched filter (chirp
+	// length - 1)
+	const qint64 rate = m_sampleRate / m_downRate;
+	qint64 start = position / m_downRate
+		- m_filter->activeLength() / (2 * m_downRate)
+		- (m_chirpLength - 1);
+
+	for (int i = 0; i < m_blockSize; i++) {
+
+		qint64 q = start + i;
+		if (q < 0) continue;
+
+		qint64 frame = q / rate;
+		int lag = (int)(q - frame * rate);
 
-		// ~f * g
-		//m_tmp1[i].re = (m_cpxRxFFT[i].re * m_cpxChirpOut[i].re) + (m_cpxRxFFT[i].im * m_cpxChirpOut[i].im);
-		//m_tmp1[i].im = (m_cpxRxFFT[i].im * m_cpxChirpOut[i].re) - (m_cpxRxFFT[i].re * m_cpxChirpOut[i].im);
+		if (lag >= CHIRP_LAGS) continue;
 
-		// f * g
-		//m_tmp1[i].re = (m_cpxChirpOut[i].re * m_cpxRxFFT[i].re) - (m_cpxChirpOut[i].im * m_cpxRxFFT[i].im);
-		//m_tmp1[i].im = (m_cpxChirpOut[i].re * m_cpxRxFFT[i].im) + (m_cpxChirpOut[i].im * m_cpxRxFFT[i].re);
+		// a frame is shown only if all its lags came in without a gap
+		if (frame != m_frame) {
+
+			m_frame = frame;
+			m_frameLags = 0;
+		}
+
+		m_cpxOut[lag] = m_tmp1.at(i);
+		m_frameLags++;
+
+		if (lag == CHIRP_LAGS - 1 && m_frameLags == CHIRP_LAGS)
+			finishFrame();
 	}
-	
-	// map back to time domain
-	m_matchedFFT->DoFFTWInverse(m_tmp1, m_cpxOut, FULL_BUFFERSIZE);
-	
+}
+
+void ChirpProcessor::finishFrame() {
+
 	float max = -1000;
 	float min = 1000;
 	float mean = 0.0f;
 	float oneOverNorm = 1.0f / FULL_BUFFERSIZE;
 	
-	for (int i = 0; i < FULL_BUFFERSIZE; i++) {
-	
-		if (!m_showChirpFFT) {
-			
-			m_spectrumBufferFull[i] = (float)(10.0 * log10(MagCPX(ScaleCPX(m_cpxOut[i], oneOverNorm)) + 1.5E-45));
-			
-			if (m_spectrumBufferFull[i] > max) max = m_spectrumBufferFull[i];
-			if (m_spectrumBufferFull[i] < min) min = m_spectrumBufferFull[i];
-			mean += m_spectrumBufferFull[i];
-		}
-		else {
-			//m_spectrumBufferFull[i] = (float)(10.0 * log10(SqrMagCPX(m_tmp1[i]) + 1.5E-45));
-			//m_spectrumBufferFull[i] = (float)(10.0 * log10(SqrMagCPX(ScaleCPX(m_tmp1[i], oneOverNorm)) + 1.5E-45));
-			m_spectrumBufferFull[i] = (float)(10.0 * log10(MagCPX(m_cpxRxFFT[i]) + 1.5E-45));
-			//m_spectrumBufferFull[i] = (float)(10.0 * log10(SqrMagCPX(m_cpxChirpOut[i]) + 1.5E-45) + 50.0f);
-			//m_spectrumBufferFull[i] = (float)(10.0 * log10(SqrMagCPX(SubCPX(m_cpxChirpOut[i], m_cpxRxFFT[i])) + 1.5E-45) + 50.0f);
-			//m_spectrumBufferFull[i] = (float)(10.0 * log10(MagCPX(m_cpxInFilt[i]) + 1.5E-45));
-			//m_spectrumBufferFull[i] = (float)(10.0 * log10(MagCPX(m_cpxIn[i]) + 1.5E-45));
+	if (!m_showChirpFFT) {
+
+		// |x/N|^2 + eps in dB = |x|^2 + eps*N^2 in dB - 20 log10(N)
+		QtDSP::magnitudeDb(m_cpxOut.constData(), m_spectrumBuffer, CHIRP_LAGS,
+			1.5E-45f / (oneOverNorm * oneOverNorm), 2.0f * QtDSP::fastDb(oneOverNorm));
+
+		max = QtDSP::maxValue(m_spectrumBuffer, CHIRP_LAGS);
+
+		for (int i = 0; i < CHIRP_LAGS; i++) {
+
+			if (m_spectrumBuffer[i] < min) min = m_spectrumBuffer[i];
+			mean += m_spectrumBuffer[i];
 		}
+
+		mean *= 1.0f/CHIRP_LAGS;
+		CHIRP_PROCESSOR_DEBUG << "dist min" << min << "max" << max << "mean" << mean;
+		CHIRP_PROCESSOR_DEBUG << "dist delta" << max - mean;
 	}
+	else {
 
-	mean *= 1.0f/FULL_BUFFERSIZE;
-	CHIRP_PROCESSOR_DEBUG << "dist min" << min << "max" << max << "mean" << mean;
-	CHIRP_PROCESSOR_DEBUG << "dist delta" << max - mean;
+		// the last FULL_BUFFERSIZE decimated samples, oldest first
+		int tail = FULL_BUFFERSIZE - m_historyPos;
+		memcpy(m_tmp3.data(), m_cpxInFilt.constData() + m_historyPos, tail * sizeof(cpx));
+		memcpy(m_tmp3.data() + tail, m_cpxInFilt.constData(), m_historyPos * sizeof(cpx));
 
-	// we take the first half of the matched filter output to display
-	memcpy(m_spectrumBuffer, m_spectrumBufferFull, (FULL_BUFFERSIZE/2) * sizeof(float));
-	
-	// we take the full length for the frequency spectrum, 
-	// because we want to see positive as well as negative spectras
-	if (m_showChirpFFT) {
+		m_matchedFFT->DoFFTWForward(m_tmp3, m_cpxRxFFT, FULL_BUFFERSIZE);
+		QtDSP::magnitudeDb(m_cpxRxFFT.constData(), m_spectrumBufferFull, FULL_BUFFERSIZE, 1.5E-45f, 0.0f);
 
+		// we take the full length for the frequency spectrum, 
+		// because we want to see positive as well as negative spectras
 		int topsize = FULL_BUFFERSIZE - 1;
 		
 		// reorder the RX FFT buffer
@@ -350,6 +353,7 @@ void ChirpProcessor::matchedFilterFIRFilter(QList<qreal> data) {
 			m_fftSpectrumBuffer[FULL_BUFFERSIZE/2 - i] = m_spectrumBufferFull[i];
 		}
 	}
+
 	setSpectras(m_spectrumBuffer, m_fftSpectrumBuffer);
 }
 
@@ -425,94 +429,68 @@ void ChirpProcessor::generateLocalChirp() {
 
 	const int sampleRate = m_sampleRate / m_downRate;
     
-	//memset(m_cpxChirpIn, 0, FULL_BUFFERSIZE * sizeof(CPX));
-	//memset(m_cpxChirpOut, 0, FULL_BUFFERSIZE * sizeof(CPX));
-	m_cpxChirpIn.resize(FULL_BUFFERSIZE);
-	m_cpxChirpOut.resize(FULL_BUFFERSIZE);
-
-
 	qreal time =  set->getChirpBufferDurationUs() / 1.0E6;
 	qint64 length = (qint64)(sampleRate * time);
 	
+	// the matched filter spans at most one frame (one second)
+	int taps = (int) qBound((qint64) 1, length, (qint64) qMin(sampleRate, FULL_BUFFERSIZE));
+
+	// local, since this runs on the thread of the signal's emitter
+	CPX chirp(taps);
+
 	qreal a = ONEPI * (set->getUpperChirpFreq() - set->getLowerChirpFreq()) / time;
 	qreal b = TWOPI * set->getLowerChirpFreq();
 
-	for (int i = 0; i < length; i++) {
+	for (int i = 0; i < taps; i++) {
 
 		// forward chirp
 		qreal t = (qreal)(1.0f * i/length);
 		// backward chirp
 		//qreal t = (qreal)(1.0f * (length-i)/length);
 		
-		// complex chirp signal
-		m_cpxChirpIn[i].re = qSin(a * t * t + b * t);
-		m_cpxChirpIn[i].im = qCos(a * t * t + b * t);
-
-		//m_cpxChirpTmp[i].re = qSin(a * t * t + b * t);
-		//m_cpxChirpTmp[i].im = qCos(a * t * t + b * t);
-
-		//m_cpxChirpIn[i].re = qCos(a * t * t + b * t);
-		//m_cpxChirpIn[i].im = qSin(a * t * t + b * t);
-
-		//m_cpxChirpIn[i].re = qSin(a * t * t + b * t);
-		//m_cpxChirpIn[i].im = -qCos(a * t * t + b * t);
+		// complex chirp signal sin + j cos; the matched filter takes it
+		// conjugate and time reversed
+		chirp[taps - 1 - i].re = qSin(a * t * t + b * t);
+		chirp[taps - 1 - i].im = -qCos(a * t * t + b * t);
 	}
 
 	//m_specBufferSize = setSpectrumBufferSize(length);
 	
-	// BPF 2.5 kHz
-	//m_filter->ProcessFilter(m_cpxChirpTmp, m_cpxChirpIn, FULL_BUFFERSIZE);
-
-	// transform chirp signal to frequency domain
-	m_chirpFFT->DoFFTWForward(m_cpxChirpIn, m_cpxChirpOut, FULL_BUFFERSIZE);
+	// the partition spectra are built by the filter's design thread and
+	// taken over, with their length, at the next block
+	m_matchedFilter->loadTaps(chirp, taps);
 
 	float dur = set->getChirpBufferDurationUs() / 1000.0f;
 
 	CHIRP_PROCESSOR_DEBUG	<< "chirp buffer changed:";
 	CHIRP_PROCESSOR_DEBUG	<< "  bufferLength" << length;
-	//CHIRP_PROCESSOR_DEBUG	<< "  spectrum buffer size" << m_specBufferSize;
+	CHIRP_PROCESSOR_DEBUG	<< "  matched filter taps" << taps;
 	CHIRP_PROCESSOR_DEBUG	<< "  start frequency (Hz)" << set->getLowerChirpFreq();
 	CHIRP_PROCESSOR_DEBUG	<< "  end frequency (Hz)" << set->getUpperChirpFreq();
 	CHIRP_PROCESSOR_DEBUG	<< "  duration (ms)" << dur;
 }
 
-//void ChirpProcessor::decimate(CPX *in, CPX *out, int size, int downrate) {
+// sums each group of downrate samples
 void ChirpProcessor::decimate(const CPX &in, CPX &out, int size, int downrate) {
 
 	int newsize = size / downrate;
 
-	//memset(out, 0, newsize * sizeof(CPX));
-	out.resize(newsize);
-
-	for (int j = 0; j < newsize; j++) {
-		for (int k = 0; k < downrate; k++) {
-		
-			if (j * downrate + k < size) {
+	const cpx *x = in.constData();
+	cpx *y = out.data();
 
-				/*out[j].re += m_tmpDec[j * downrate + k].re;
-				out[j].im += m_tmpDec[j * downrate + k].im;*/
-				out[j].re += in[j * downrate + k].re;
-				out[j].im += in[j * downrate + k].im;
-			}
-		}
-	}
-}
+	for (int j = 0; j < newsize; j++, x += downrate) {
 
-//void ChirpProcessor::decimate(QList<qreal> data, CPX *out, int downrate) {
-void ChirpProcessor::decimate(const QList<qreal> &data, CPX &out, int downrate) {
+		float re = 0.0f;
+		float im = 0.0f;
 
-	//memset(out, 0, 16 * BUFFER_SIZE * sizeof(CPX));
-	out.resize(16 * BUFFER_SIZE);
-	
-	for (int j = 0; j < data.length()/4; j += 2) {
 		for (int k = 0; k < downrate; k++) {
-		
-			if (j * downrate + 2*k < data.length()) {
 
-				out[j/2].re += data.at(j * downrate + 2*k);
-				out[j/2].im += data.at(j * downrate + 2*k + 1);
-			}
+			re += x[k].re;
+			im += x[k].im;
 		}
+
+		y[j].re = re;
+		y[j].im = im;
 	}
 }
 
@@ -40,6 +40,7 @@
 #include "QtDSP/qtdsp_qComplex.h"
 #include "QtDSP/qtdsp_filter.h"
 #include "QtDSP/qtdsp_fft.h"
+#include "QtDSP/qtdsp_kernels.h"
 
 #ifdef LOG_CHIRP_PROCESSOR
 #   define CHIRP_PROCESSOR_DEBUG qDebug().nospace() << "ChirpProcessor::\t"
@@ -50,8 +51,31 @@
 
 #define FULL_BUFFERSIZE		16384//65536
 #define HALF_BUFFERSIZE		32768
-#define BUFFERSIZE			2048
-
+#define BUFFERSIZE			CHIRP_BLOCK_SIZE
+
+// lags of the distance display
+#define CHIRP_LAGS			(FULL_BUFFERSIZE/2)
+
+/*!
+	\class ChirpProcessor
+	\brief Matched filter of the chirp sounder, streaming block by block.
+
+	The blocks of BUFFERSIZE complex samples come through io->chirp_queue,
+	each time stamped with its sample position; the 1PPS frames start at
+	every multiple of the sample rate. A block is band pass filtered,
+	decimated by m_downRate and correlated with the local chirp by a
+	uniformly partitioned overlap-save QFilter whose taps are the time
+	reversed, conjugate chirp. The correlation at lag k of a frame is the
+	filter output chirp length - 1 + k samples after the frame start, so
+	a frame is complete, and shown, with the block that holds lag
+	CHIRP_LAGS - 1: the latency is one block and the memory does not
+	depend on the chirp or frame length.
+
+	generateLocalChirp() may run on any thread; it only posts the taps.
+	The chirp length used for the lags is the one the matched filter
+	reports with the taps it applied, and the frame in progress when a
+	new chirp comes in is dropped.
+*/
 class ChirpProcessor : public QObject {
 
     Q_OBJECT
@@ -66,7 +90,6 @@ public slots:
 	void	generateLocalChirp();
 	
 private slots:
-	void	matchedFilterFIRFilter(QList<qreal> data);
 	void	samplingRateChanged(QObject *sender, int value);
 	void	setSpectras(const float *distance, const float *chirpfft);
 	void	setDistSpectrumAvgLength(int value);
@@ -81,23 +104,19 @@ private:
 	QMutex		m_mutex;
 	QString		m_message;
 
-	QFFT		*m_chirpFFT;
 	QFFT		*m_matchedFFT;
 	QFilter		*m_filter;
+	QFilter		*m_matchedFilter;
 
 	CPX			m_tmp0;
 	CPX			m_tmp1;
 	CPX			m_tmp2;
 	CPX			m_tmp3;
-	CPX			m_tmpDec;
 
 	CPX			m_cpxRxFFT;
-	CPX			m_cpxChirpIn;
-	CPX			m_cpxChirpTmp;
-	CPX			m_cpxChirpOut;
 	CPX			m_cpxIn;
-	CPX			m_cpxInFilt;
-	CPX			m_cpxOut;
+	CPX			m_cpxInFilt;		// the last FULL_BUFFERSIZE decimated samples
+	CPX			m_cpxOut;			// correlation of the current frame
 	
 	THPSDRParameter	*io;
 
@@ -119,6 +138,13 @@ private:
 	int			m_sampleRate;
 	int			m_downSampleRate;
 	int			m_downRate;
+	int			m_blockSize;		// decimated
+	int			m_chirpLength;		// matched filter taps, processing thread only
+	int			m_historyPos;
+	int			m_frameLags;		// lags of the current frame so far
+
+	qint64		m_nextPosition;		// expected position of the next block
+	qint64		m_frame;			// second of the current frame
 	int			m_specBufferSize;
 	int			m_specAvgLength;
 	float		m_filterLowerFrequency;
@@ -132,8 +158,9 @@ private:
 	qreal		m_chirpSidebandFactor;
 
 	void		setupConnections();
+	void		processBlock(const float *iq, qint64 position);
+	void		finishFrame();
 	void		decimate(const CPX &in, CPX &out, int size, int downrate);
-	void		decimate(const QList<qreal> &data, CPX &out, int downrate);
 	void		spectrumAveraging(qint64 length, const float *buffer);
 
 	int			setSpectrumBufferSize(int size);
@@ -87,7 +87,9 @@ DataEngine::DataEngine(QObject *parent)
 	, m_RxFrequencyChange(0)
 	, m_forwardPower(0)
 	, m_rxSamples(0)
-	, m_chirpSamples(0)
+	, m_chirpSlot(0)
+	, m_chirpFill(0)
+	, m_chirpPosition(0)
 	, m_spectrumSize(set->getSpectrumSize())
 	, m_sendState(0)
 	, m_sMeterCalibrationOffset(0.0f)//(35.0f)
@@ -475,7 +477,9 @@ bool DataEngine::startDataEngineWithoutConnection() {
 				set->setRxList(RX);
 
 				m_rxSamples = 0;
-				m_chirpSamples = 0;
+				m_chirpSlot = 0;
+				m_chirpFill = 0;
+				m_chirpPosition = 0;
 
 				break;
 		}
@@ -916,24 +920,25 @@ bool DataEngine::start() {
 
 			setFrequency(this, true, i, set->getCtrFrequencies().at(i));
 
-			CHECKED_CONNECT(
+			// the data processor thread never returns to its event loop, so the
+			// output is handed over directly in the receiver's thread.
+			CHECKED_CONNECT_OPT(
 				RX.at(i),
-				SIGNAL(outputBufferSignal(int, const CPX &)),
+				SIGNAL(outputBufferSignal(int, const qVectorFloat &, int)),
 				m_dataProcessor,
-				SLOT(setOutputBuffer(int, const CPX &)));
+				SLOT(setOutputBuffer(int, const qVectorFloat &, int)),
+				Qt::DirectConnection);
 
-			CHECKED_CONNECT(
-				RX.at(i),
-				SIGNAL(spectrumBufferChanged(int, const qVectorFloat&)),
-				set,
-				SLOT(setSpectrumBuffer(int, const qVectorFloat&)));
-
-			CHECKED_CONNECT(
+			// Settings only re-emits the notifications; done in the receiver's thread
+			// they go straight to the panels' threads, not via the GUI.
+			CHECKED_CONNECT_OPT(
 				RX.at(i),
-				SIGNAL(sMeterValueChanged(int, float)),
+				SIGNAL(spectrumBufferChanged(int)),
 				set,
-				SLOT(setSMeterValue(int, float)));
+				SLOT(setSpectrumBuffer(int)),
+				Qt::DirectConnection);
 		
+			pinReceiverThread(i);
 			m_dspThreadList.at(i)->start(QThread::NormalPriority);//QThread::TimeCriticalPriority);
 				
 			if (m_dspThreadList.at(i)->isRunning()) {
@@ -1058,22 +1063,16 @@ void DataEngine::stop() {
 			if (m_dataProcessor) {
 				disconnect(
 					rx,
-					SIGNAL(outputBufferSignal(int, const CPX &)),
+					SIGNAL(outputBufferSignal(int, const qVectorFloat &, int)),
 					m_dataProcessor,
-					SLOT(setOutputBuffer(int, const CPX &)));
+					SLOT(setOutputBuffer(int, const qVectorFloat &, int)));
 			}
 
 			disconnect(
 				rx,
-				SIGNAL(spectrumBufferChanged(int, const qVectorFloat&)),
+				SIGNAL(spectrumBufferChanged(int)),
 				set,
-				SLOT(setSpectrumBuffer(int, const qVectorFloat&)));
-
-			disconnect(
-				rx,
-				SIGNAL(sMeterValueChanged(int, float)),
-				set,
-				SLOT(setSMeterValue(int, float)));
+				SLOT(setSpectrumBuffer(int)));
 		}
 		DATA_ENGINE_DEBUG << "receiver threads stopped.";
 		set->setSystemMessage("Data engine shut down.", 4000);
@@ -1082,7 +1081,9 @@ void DataEngine::stop() {
 	}
 
 	m_rxSamples = 0;
-	m_chirpSamples = 0;
+	m_chirpSlot = 0;
+	m_chirpFill = 0;
+	m_chirpPosition = 0;
 	m_restart = true;
 	m_found = 0;
 	m_hpsdrDevices = 0;
@@ -1360,6 +1361,17 @@ void DataEngine::setHPSDRConfig() {
 	}
 }
 
+void DataEngine::pinReceiverThread(int rx) {
+
+	// keep core 0 for the network and GUI threads and spread the
+	// receiver DSP threads over the remaining cores.
+	int cores = QThread::idealThreadCount();
+	if (cores > 2)
+		m_dspThreadList.at(rx)->setCpuAffinity(1 + (rx % (cores - 1)));
+	else
+		m_dspThreadList.at(rx)->setCpuAffinity(-1);
+}
+
 void DataEngine::connectDSPSlots() {
 
 	CHECKED_CONNECT(
@@ -1540,12 +1552,9 @@ void DataEngine::stopDataIO() {
 		delete m_dataIOThread;
 		delete m_dataIO;
 		m_dataIO = 0;
-		
-		if (m_serverMode == QSDR::ChirpWSPRFile) {
 
-			while (!io.chirp_queue.isEmpty())
-				io.chirp_queue.dequeue();
-		}
+		// the chirp ring is cleared when the chirp processor has stopped,
+		// see stopChirpDataProcessor()
 
 		DATA_ENGINE_DEBUG << "data IO thread deleted.";
 	}
@@ -1662,10 +1671,8 @@ void DataEngine::stopDataProcessor() {
 		
 		if (m_serverMode == QSDR::SDRMode || m_serverMode == QSDR::ChirpWSPR) {
 			
-			if (io.iq_queue.isEmpty()) {
-				io.iq_queue.enqueue(QByteArray(BUFFER_SIZE, 0x0));
-				//io.iq_queue.enqueue(QByteArray(2*BUFFER_SIZE, 0x0));
-			}
+			// wake up the data processor if it waits for a frame
+			io.iq_queue.releaseWaiting();
 		}
 		else if (m_serverMode == QSDR::ChirpWSPRFile) {
 
@@ -1685,8 +1692,8 @@ void DataEngine::stopDataProcessor() {
 
 		if (m_serverMode == QSDR::SDRMode || m_serverMode == QSDR::ChirpWSPR) {
 
-			while (!io.iq_queue.isEmpty())
-				io.iq_queue.dequeue();
+			io.iq_queue.clear();
+			io.iq_queue.resetCounters();
 
 			DATA_ENGINE_DEBUG << "iq_queue empty.";
 		}
@@ -1696,7 +1703,10 @@ void DataEngine::stopDataProcessor() {
 				io.data_queue.dequeue();
 
 			DATA_ENGINE_DEBUG << "data_queue empty.";
-			chirpData.clear();
+
+			// an unfinished chirp ring slot is given up
+			m_chirpSlot = 0;
+			m_chirpFill = 0;
 		}
 
 		m_dataProcThreadRunning = false;
@@ -1794,11 +1804,12 @@ void DataEngine::createWideBandDataProcessor() {
 		m_wbDataProcessor, 
 		SLOT(setWbSpectrumAveraging(QObject*, int, bool)));
 
-	CHECKED_CONNECT(
+	CHECKED_CONNECT_OPT(
 		m_wbDataProcessor,
-		SIGNAL(wbSpectrumBufferChanged(const qVectorFloat&)),
+		SIGNAL(wbSpectrumBufferChanged()),
 		set,
-		SLOT(setWidebandSpectrumBuffer(const qVectorFloat&)));
+		SLOT(setWidebandSpectrumBuffer()),
+		Qt::DirectConnection);
 }
 
 bool DataEngine::startWideBandDataProcessor(QThread::Priority prio) {
@@ -1827,8 +1838,7 @@ void DataEngine::stopWideBandDataProcessor() {
 	if (m_wbDataProcThread->isRunning()) {
 					
 		m_wbDataProcessor->stop();
-		if (io.wb_queue.isEmpty())
-			io.wb_queue.enqueue(m_datagram);
+		io.wb_queue.releaseWaiting();
 
 		m_wbDataProcThread->quit();
 		m_wbDataProcThread->wait();
@@ -1865,6 +1875,10 @@ void DataEngine::createChirpDataProcessor() {
 		DATA_ENGINE_DEBUG << "audio chirp signal initialization failed";*/
 
 
+	// nothing of a former run is left in the ring; its consumer is not running
+	io.chirp_queue.clear();
+	io.chirp_queue.resetCounters();
+
 	m_chirpDataProcThread = new QThreadEx();
 	m_chirpProcessor->moveToThread(m_chirpDataProcThread);
 	m_chirpProcessor->connect(
@@ -1901,13 +1915,9 @@ void DataEngine::stopChirpDataProcessor() {
 
 	if (m_chirpInititalized) {
 
+		// wakes the processor if it waits for a block
 		m_chirpProcessor->stop();
-		if (io.chirp_queue.isEmpty()) {
-				
-			QList<qreal> buf;
-			for (int i = 0; i < 128; i++) buf << 0.0f;
-				io.chirp_queue.enqueue(buf);
-			}
+		io.chirp_queue.releaseWaiting();
 
 			m_chirpDataProcThread->quit();
 			m_chirpDataProcThread->wait();
@@ -1915,15 +1925,15 @@ void DataEngine::stopChirpDataProcessor() {
 			delete m_chirpProcessor;
 			m_chirpProcessor = 0;
 
+			DATA_ENGINE_DEBUG << "chirp ring overruns: " << io.chirp_queue.overruns();
+			io.chirp_queue.clear();
+
 			if (m_hwInterface == QSDR::NoInterfaceMode) {
 
 				//freeCPX(io.cpxIn);
 				//freeCPX(io.cpxOut);
 				delete m_chirpDspEngine;
 
-				while (!io.chirp_queue.isEmpty())
-					io.chirp_queue.dequeue();
-
 				DATA_ENGINE_DEBUG << "io.cpxIn, io.cpxOut, fft deleted, io.chirp_queue empty.";
 			}
 
@@ -1978,32 +1988,49 @@ void DataEngine::processFileBuffer(const QList<qreal> buffer) {
 
 		cpxIn[i + m_rxSamples].re = buffer.at(2*i);
 		cpxIn[i + m_rxSamples].im = buffer.at(2*i+1);
+	}
+	m_rxSamples += 64;
+
+	// the chirp processor gets the samples in place in the slots of the
+	// chirp ring, CHIRP_BLOCK_SIZE at a time; a slot is time stamped with
+	// the file position of its first sample, from which the processor
+	// derives the 1PPS boundaries. A full ring drops the block.
+	for (int k = 0; k < 64; ) {
 
-		chirpData << buffer.at(2*i);
-		chirpData << buffer.at(2*i+1);
+		if (m_chirpFill == 0)
+			m_chirpSlot = (float *) io.chirp_queue.writeSlot();
 
-		m_chirpSamples++;
-		if (m_chirpSamples == io.samplerate) {
+		int n = qMin(64 - k, CHIRP_BLOCK_SIZE - m_chirpFill);
 
-			io.chirp_queue.enqueue(chirpData);
-			chirpData.clear();
-			m_chirpSamples = 0;
+		if (m_chirpSlot) {
+
+			float *dst = m_chirpSlot + 2 * m_chirpFill;
+			for (int j = 0; j < 2 * n; j++)
+				dst[j] = (float) buffer.at(2 * k + j);
+		}
+
+		m_chirpFill += n;
+		k += n;
+
+		if (m_chirpFill == CHIRP_BLOCK_SIZE) {
+
+			if (m_chirpSlot)
+				io.chirp_queue.commitWrite(CHIRP_BLOCK_SIZE * 2 * sizeof(float), m_chirpPosition);
+
+			m_chirpPosition += CHIRP_BLOCK_SIZE;
+			m_chirpSlot = 0;
+			m_chirpFill = 0;
 		}
 	}
-	m_rxSamples += 64;
 
 	if (m_rxSamples == 2*BUFFER_SIZE) {
 
 		m_chirpDspEngine->fft->DoFFTWForward(cpxIn, cpxOut, 2*BUFFER_SIZE);
 
-		// reorder the spectrum buffer
-		for (int i = 0; i < BUFFER_SIZE; i++) {
-
-			m_spectrumBuffer[topsize - i] =
-				(float)(10.0 * log10(MagCPX(cpxOut[i+BUFFER_SIZE]) + 1.5E-45));
-			m_spectrumBuffer[BUFFER_SIZE - i] =
-				(float)(10.0 * log10(MagCPX(cpxOut[i]) + 1.5E-45));
-		}
+		// reorder the spectrum buffer: both halves reversed, the upper one
+		// ending at topsize, the lower one at BUFFER_SIZE
+		QtDSP::magnitudeDbReversed(cpxOut.constData() + BUFFER_SIZE, m_spectrumBuffer + topsize - BUFFER_SIZE + 1, BUFFER_SIZE, 1.5E-45f, 0.0f);
+		QtDSP::magnitudeDbReversed(cpxOut.constData(), m_spectrumBuffer + 1, BUFFER_SIZE, 1.5E-45f, 0.0f);
 
 		/*float specMean = 0.0f;
 		for (int i = BUFFER_SIZE+20; i < BUFFER_SIZE+105; i++) {
@@ -2103,21 +2130,15 @@ void DataEngine::setNumberOfRx(QObject *sender, int numberOfRx, int lastChanged,
 
 			disconnect(
 				rx,
-				SIGNAL(outputBufferSignal(int, const CPX &)),
+				SIGNAL(outputBufferSignal(int, const qVectorFloat &, int)),
 				m_dataProcessor,
-				SLOT(setOutputBuffer(int, const CPX &)));
-
-			disconnect(
-				rx,
-				SIGNAL(spectrumBufferChanged(int, const qVectorFloat&)),
-				set,
-				SLOT(setSpectrumBuffer(int, const qVectorFloat&)));
+				SLOT(setOutputBuffer(int, const qVectorFloat &, int)));
 
 			disconnect(
 				rx,
-				SIGNAL(sMeterValueChanged(int, float)),
+				SIGNAL(spectrumBufferChanged(int)),
 				set,
-				SLOT(setSMeterValue(int, float)));
+				SLOT(setSpectrumBuffer(int)));
 		}
 		DATA_ENGINE_DEBUG << "receiver threads stopped.";
 
@@ -2166,24 +2187,25 @@ void DataEngine::setNumberOfRx(QObject *sender, int numberOfRx, int lastChanged,
 
 				setFrequency(this, true, i, set->getCtrFrequencies().at(i));
 
-				CHECKED_CONNECT(
+				// the data processor thread never returns to its event loop, so the
+				// output is handed over directly in the receiver's thread.
+				CHECKED_CONNECT_OPT(
 					RX.at(i),
-					SIGNAL(outputBufferSignal(int, const CPX &)),
+					SIGNAL(outputBufferSignal(int, const qVectorFloat &, int)),
 					m_dataProcessor,
-					SLOT(setOutputBuffer(int, const CPX &)));
-
-				CHECKED_CONNECT(
-					RX.at(i),
-					SIGNAL(spectrumBufferChanged(int, const qVectorFloat&)),
-					set,
-					SLOT(setSpectrumBuffer(int, const qVectorFloat&)));
+					SLOT(setOutputBuffer(int, const qVectorFloat &, int)),
+					Qt::DirectConnection);
 
-				CHECKED_CONNECT(
+				// Settings only re-emits the notifications; done in the receiver's thread
+				// they go straight to the panels' threads, not via the GUI.
+				CHECKED_CONNECT_OPT(
 					RX.at(i),
-					SIGNAL(sMeterValueChanged(int, float)),
+					SIGNAL(spectrumBufferChanged(int)),
 					set,
-					SLOT(setSMeterValue(int, float)));
+					SLOT(setSpectrumBuffer(int)),
+					Qt::DirectConnection);
 		
+				pinReceiverThread(i);
 				m_dspThreadList.at(i)->start(QThread::NormalPriority);//QThread::TimeCriticalPriority);
 			}
 		}
@@ -2697,6 +2719,7 @@ DataProcessor::DataProcessor(
 	, m_rxSamples(0)
 	, m_chirpSamples(0)
 	, m_chirpStartSample(0)
+	, m_allocations(0)
 	, m_idx(IO_HEADER_SIZE)
 	, m_sendState(0)
 	, m_stopped(false)
@@ -2722,11 +2745,26 @@ DataProcessor::DataProcessor(
 
 	//socket = new QUdpSocket();
 	m_deviceAddress = set->getCurrentHPSDRDevice().ip_address;
+
+	DATA_PROCESSOR_DEBUG << "IQ frame unpacker uses " << QtDSP::simdLevelName(m_unpacker.simdLevel());
 }
 
 DataProcessor::~DataProcessor() {
 }
 
+void DataProcessor::checkAllocations() {
+
+	int allocations = de->io.frameAllocations.load();
+	for (int r = 0; r < de->io.maxReceiverNo; r++)
+		allocations += de->RX.at(r)->getBlockAllocations();
+
+	if (allocations != m_allocations) {
+
+		DATA_PROCESSOR_DEBUG << "heap allocations on the frame path: " << allocations;
+		m_allocations = allocations;
+	}
+}
+
 void DataProcessor::stop() {
 
 	m_stopped = true;
@@ -2772,13 +2810,18 @@ void DataProcessor::processDeviceData() {
 	forever {
 
 		//DATA_PROCESSOR_DEBUG << "iq_queue empty? " << de->io.iq_queue.isEmpty();
-		QByteArray buf = de->io.iq_queue.dequeue();
-		
-		processInputBuffer(buf.left(BUFFER_SIZE/2));
-		processInputBuffer(buf.right(BUFFER_SIZE/2));
-		
-		if (de->io.iq_queue.isFull()) { 
-			DATA_PROCESSOR_DEBUG << "IQ queue full!";
+		// the datagram is decoded in the ring slot it was received into and
+		// the slot is released afterwards; non-IQ datagrams leave empty slots.
+		int length;
+		const char *buf = de->io.iq_queue.readSlot(&length);
+		if (buf) {
+
+			if (length == METIS_DATA_SIZE) {
+
+				processInputBuffer(buf + METIS_HEADER_SIZE);
+				processInputBuffer(buf + METIS_HEADER_SIZE + BUFFER_SIZE/2);
+			}
+			de->io.iq_queue.commitRead();
 		}
 		
 		QMutexLocker locker(&m_mutex);
@@ -2930,109 +2973,54 @@ void DataProcessor::externalDspProcessingBig(int rx) {
 	m_IQDatagram.resize(0);
 }
 
-void DataProcessor::processInputBuffer(const QByteArray &buffer) {
+void DataProcessor::processInputBuffer(const char *buffer) {
 	
 	//DATA_PROCESSOR_DEBUG << "processInputBuffer: " << this->thread();
 	int s = 0;
 
-	if (buffer.at(s++) == SYNC && buffer.at(s++) == SYNC && buffer.at(s++) == SYNC)	{
+	if (buffer[s++] == SYNC && buffer[s++] == SYNC && buffer[s++] == SYNC)	{
 
 		// extract C&C bytes
-        decodeCCBytes(buffer.mid(3, 5));
+        decodeCCBytes(buffer + 3);
         s += 5;
 
-        switch (de->io.maxReceiverNo) {
+        // convert all samples of the frame at once into per-receiver buffers
+        int samples = m_unpacker.unpack(buffer + s, de->io.maxReceiverNo);
+        int k = 0;
 
-            case 1: m_maxSamples = 512-0;  break;
-            case 2: m_maxSamples = 512-0;  break;
-            case 3: m_maxSamples = 512-4;  break;
-            case 4: m_maxSamples = 512-10; break;
-            case 5: m_maxSamples = 512-24; break;
-            case 6: m_maxSamples = 512-10; break;
-            case 7: m_maxSamples = 512-20; break;
-            case 8: m_maxSamples = 512-4;  break;
-        }
+        while (k < samples) {
 
-        // extract the samples
-        while (s < m_maxSamples) {
+			// copy up to the end of the current DSP block
+			int n = qMin(samples - k, BUFFER_SIZE - m_rxSamples);
 
-            // extract each of the receivers
             for (int r = 0; r < de->io.maxReceiverNo; r++) {
 
-                m_leftSample   = (int)((  signed char) buffer.at(s++)) << 16;
-                m_leftSample  += (int)((unsigned char) buffer.at(s++)) << 8;
-                m_leftSample  += (int)((unsigned char) buffer.at(s++));
-                m_rightSample  = (int)((  signed char) buffer.at(s++)) << 16;
-                m_rightSample += (int)((unsigned char) buffer.at(s++)) << 8;
-                m_rightSample += (int)((unsigned char) buffer.at(s++));
-
-				m_lsample = (float)(m_leftSample / 8388607.0f);
-				m_rsample = (float)(m_rightSample / 8388607.0f);
+				if (de->RX.at(r)->qtdsp) {
 
-				/*if (m_serverMode == QSDR::ChirpWSPR &&
-					m_chirpInititalized &&
-					m_chirpSamples < io.samplerate)
-				{
-					chirpData << m_lsample;
-					chirpData << m_rsample;
-				}*/
+					const float *iBuf = m_unpacker.i(r) + k;
+					const float *qBuf = m_unpacker.q(r) + k;
+					cpx *dst = de->RX[r]->inputBlock() + m_rxSamples;
 
-				if (de->RX.at(r)->qtdsp) {
+					for (int j = 0; j < n; j++) {
 
-					de->RX[r]->inBuf[m_rxSamples].re = m_lsample; // 24 bit sample
-					de->RX[r]->inBuf[m_rxSamples].im = m_rsample; // 24 bit sample
+						dst[j].re = iBuf[j]; // 24 bit sample
+						dst[j].im = qBuf[j]; // 24 bit sample
+					}
 				}
             }
 
-            m_micSample = (int)((signed char) buffer.at(s++)) << 8;
-
-			// extract chirp signal time stamp
-			//m_chirpBit = (buffer.at(s) & 0x01);// == 0x01;
-
-			m_micSample += (int)((unsigned char) buffer.at(s++));
-    		m_micSample_float = (float) m_micSample / 32767.0f * de->io.mic_gain; // 16 bit sample
-
-            // add to buffer
-            de->io.mic_left_buffer[m_rxSamples]  = m_micSample_float;
-            de->io.mic_right_buffer[m_rxSamples] = 0.0f;
-
-			////m_chirpSamples++;
-
-			//if (m_serverMode == QSDR::ChirpWSPR && m_chirpInititalized)
-			//{
-			//	if (m_chirpBit)
-			//	{
-			//		if (m_chirpGateBit)
-			//		{
-			//			// we've found the rising edge of the GPS 1PPS signal, so we set the samples
-			//			// counter back to zero in order to have a simple and precise synchronisation
-			//			// with the local chirp.
-			//			io.networkIOMutex.lock();
-			//			DATA_ENGINE_DEBUG << "GPS 1 PPS";
-			//			io.networkIOMutex.unlock();
-
-			//			// remove the last sample (real and imag) and enqueue the buffer
-			//			chirpData.removeLast();
-			//			chirpData.removeLast();
-			//			io.chirp_queue.enqueue(chirpData);
-
-			//			// empty the buffer and add the last sample, which is the starting point of the chirp
-			//			m_chirpSamples = 0;
-			//			chirpData.clear();
-
-			//			chirpData << m_lsample;
-			//			chirpData << m_rsample;
-
-			//			m_chirpStart = true;
-			//			m_chirpStartSample = m_rxSamples;
-			//			m_chirpGateBit = false;
-			//		}
-			//	}
-			//	else
-			//		m_chirpGateBit = true;
-			//}
-			m_rxSamples++;
-			m_chirpSamples++;
+			const float *mic = m_unpacker.mic() + k;
+			for (int j = 0; j < n; j++) {
+
+				de->io.mic_left_buffer[m_rxSamples + j]  = mic[j] * de->io.mic_gain; // 16 bit sample
+				de->io.mic_right_buffer[m_rxSamples + j] = 0.0f;
+			}
+
+			// the GPS 1PPS chirp time stamp in the mic LSB is not evaluated yet.
+
+			m_rxSamples += n;
+			m_chirpSamples += n;
+			k += n;
 
 			// when we have enough rx samples we start the DSP processing.
             if (m_rxSamples == BUFFER_SIZE) {
@@ -3041,10 +3029,14 @@ void DataProcessor::processInputBuffer(const QByteArray &buffer) {
 	
 					if (de->rxDisplayList.at(r)) {
 						
-						QMetaObject::invokeMethod(de->RX.at(r), "dspProcessing", Qt::DirectConnection);// Qt::QueuedConnection);
+						// hand the block over to the receiver's own DSP thread
+						if (de->RX.at(r)->commitInputBlock())
+							QMetaObject::invokeMethod(de->RX.at(r), "dspProcessing", Qt::QueuedConnection);
 					}
 				}
 				m_rxSamples = 0;
+
+				checkAllocations();
             }
         }
     }
@@ -3058,14 +3050,14 @@ void DataProcessor::processInputBuffer(const QByteArray &buffer) {
 	}
 }
 
-void DataProcessor::decodeCCBytes(const QByteArray &buffer) {
+void DataProcessor::decodeCCBytes(const char *buffer) {
 
-	de->io.ccRx.ptt    = (bool)((buffer.at(0) & 0x01) == 0x01);
-	de->io.ccRx.dash   = (bool)((buffer.at(0) & 0x02) == 0x02);
-	de->io.ccRx.dot    = (bool)((buffer.at(0) & 0x04) == 0x04);
-	de->io.ccRx.lt2208 = (bool)((buffer.at(1) & 0x01) == 0x01);
+	de->io.ccRx.ptt    = (bool)((buffer[0] & 0x01) == 0x01);
+	de->io.ccRx.dash   = (bool)((buffer[0] & 0x02) == 0x02);
+	de->io.ccRx.dot    = (bool)((buffer[0] & 0x04) == 0x04);
+	de->io.ccRx.lt2208 = (bool)((buffer[1] & 0x01) == 0x01);
 
-	de->io.ccRx.roundRobin = (uchar)(buffer.at(0) >> 3);
+	de->io.ccRx.roundRobin = (uchar)(buffer[0] >> 3);
 	
     switch (de->io.ccRx.roundRobin) // cycle through C0
 	{
@@ -3083,10 +3075,10 @@ void DataProcessor::decodeCCBytes(const QByteArray &buffer) {
 			//qDebug() << "CC: " << io.ccRx.roundRobin;
 			if (m_hwInterface == QSDR::Hermes)
 			{
-				de->io.ccRx.hermesI01 = (bool)((buffer.at(1) & 0x02) == 0x02);
-				de->io.ccRx.hermesI02 = (bool)((buffer.at(1) & 0x04) == 0x04);
-				de->io.ccRx.hermesI03 = (bool)((buffer.at(1) & 0x08) == 0x08);
-				de->io.ccRx.hermesI04 = (bool)((buffer.at(1) & 0x10) == 0x10);
+				de->io.ccRx.hermesI01 = (bool)((buffer[1] & 0x02) == 0x02);
+				de->io.ccRx.hermesI02 = (bool)((buffer[1] & 0x04) == 0x04);
+				de->io.ccRx.hermesI03 = (bool)((buffer[1] & 0x08) == 0x08);
+				de->io.ccRx.hermesI04 = (bool)((buffer[1] & 0x10) == 0x10);
 				//qDebug()	<< "Hermes IO 1: " << io.ccRx.hermesI01 
 				//			<< "2: " << io.ccRx.hermesI02 
 				//			<< "3: " << io.ccRx.hermesI03 
@@ -3097,43 +3089,43 @@ void DataProcessor::decodeCCBytes(const QByteArray &buffer) {
 			{
 				if (m_hwInterface == QSDR::Metis)
 				{
-					if (de->io.ccRx.devices.mercuryFWVersion != buffer.at(2))
+					if (de->io.ccRx.devices.mercuryFWVersion != buffer[2])
 					{
-						de->io.ccRx.devices.mercuryFWVersion = buffer.at(2);
+						de->io.ccRx.devices.mercuryFWVersion = buffer[2];
 						set->setMercuryVersion(de->io.ccRx.devices.mercuryFWVersion);
 						de->io.networkIOMutex.lock();
-						DATA_PROCESSOR_DEBUG << "Mercury firmware version: " << qPrintable(QString::number(buffer.at(2)));
+						DATA_PROCESSOR_DEBUG << "Mercury firmware version: " << qPrintable(QString::number(buffer[2]));
 						de->io.networkIOMutex.unlock();
 					}
 
-					if (de->io.ccRx.devices.penelopeFWVersion != buffer.at(3))
+					if (de->io.ccRx.devices.penelopeFWVersion != buffer[3])
 					{
-						de->io.ccRx.devices.penelopeFWVersion = buffer.at(3);
-						de->io.ccRx.devices.pennylaneFWVersion = buffer.at(3);
+						de->io.ccRx.devices.penelopeFWVersion = buffer[3];
+						de->io.ccRx.devices.pennylaneFWVersion = buffer[3];
 						set->setPenelopeVersion(de->io.ccRx.devices.penelopeFWVersion);
 						set->setPennyLaneVersion(de->io.ccRx.devices.penelopeFWVersion);
 						de->io.networkIOMutex.lock();
-						DATA_PROCESSOR_DEBUG << "Penelope/Pennylane firmware version: " << qPrintable(QString::number(buffer.at(3)));
+						DATA_PROCESSOR_DEBUG << "Penelope/Pennylane firmware version: " << qPrintable(QString::number(buffer[3]));
 						de->io.networkIOMutex.unlock();
 					}
 
-					if (de->io.ccRx.devices.metisFWVersion != buffer.at(4))
+					if (de->io.ccRx.devices.metisFWVersion != buffer[4])
 					{
-						de->io.ccRx.devices.metisFWVersion = buffer.at(4);
+						de->io.ccRx.devices.metisFWVersion = buffer[4];
 						set->setMetisVersion(de->io.ccRx.devices.metisFWVersion);
 						de->io.networkIOMutex.lock();
-						DATA_PROCESSOR_DEBUG << "Metis firmware version: " << qPrintable(QString::number(buffer.at(4)));
+						DATA_PROCESSOR_DEBUG << "Metis firmware version: " << qPrintable(QString::number(buffer[4]));
 						de->io.networkIOMutex.unlock();
 					}
 				}
 				else if (set->getHWInterface() == QSDR::Hermes) {
 
-					if (de->io.ccRx.devices.hermesFWVersion != buffer.at(4)) {
+					if (de->io.ccRx.devices.hermesFWVersion != buffer[4]) {
 
-						de->io.ccRx.devices.hermesFWVersion = buffer.at(4);
+						de->io.ccRx.devices.hermesFWVersion = buffer[4];
 						set->setHermesVersion(de->io.ccRx.devices.hermesFWVersion);
 						de->io.networkIOMutex.lock();
-						DATA_ENGINE_DEBUG << "firmware version: " << qPrintable(QString::number(buffer.at(4)));
+						DATA_ENGINE_DEBUG << "firmware version: " << qPrintable(QString::number(buffer[4]));
 						de->io.networkIOMutex.unlock();
 					}
 				}
@@ -3147,7 +3139,7 @@ void DataProcessor::decodeCCBytes(const QByteArray &buffer) {
 			// forward power
 			if (set->getPenelopePresence() || (m_hwInterface == QSDR::Hermes)) { // || set->getPennyLanePresence()
 
-				de->io.ccRx.ain5 = (quint16)((quint16)(buffer.at(1) << 8) + (quint16)buffer.at(2));
+				de->io.ccRx.ain5 = (quint16)((quint16)(buffer[1] << 8) + (quint16)buffer[2]);
 
 				de->io.penelopeForwardVolts = (qreal)(3.3 * (qreal)de->io.ccRx.ain5 / 4095.0);
 				de->io.penelopeForwardPower = (qreal)(de->io.penelopeForwardVolts * de->io.penelopeForwardVolts / 0.09);
@@ -3156,7 +3148,7 @@ void DataProcessor::decodeCCBytes(const QByteArray &buffer) {
 
 			if (set->getAlexPresence()) { //|| set->getApolloPresence()) {
 
-				de->io.ccRx.ain1 = (quint16)((quint16)(buffer.at(3) << 8) + (quint16)buffer.at(4));
+				de->io.ccRx.ain1 = (quint16)((quint16)(buffer[3] << 8) + (quint16)buffer[4]);
 
 				de->io.alexForwardVolts = (qreal)(3.3 * (qreal)de->io.ccRx.ain1 / 4095.0);
 				de->io.alexForwardPower = (qreal)(de->io.alexForwardVolts * de->io.alexForwardVolts / 0.09);
@@ -3170,7 +3162,7 @@ void DataProcessor::decodeCCBytes(const QByteArray &buffer) {
 			// reverse power
 			if (set->getAlexPresence()) { //|| set->getApolloPresence()) {
 
-				de->io.ccRx.ain2 = (quint16)((quint16)(buffer.at(1) << 8) + (quint16)buffer.at(2));
+				de->io.ccRx.ain2 = (quint16)((quint16)(buffer[1] << 8) + (quint16)buffer[2]);
 
 				de->io.alexReverseVolts = (qreal)(3.3 * (qreal)de->io.ccRx.ain2 / 4095.0);
 				de->io.alexReversePower = (qreal)(de->io.alexReverseVolts * de->io.alexReverseVolts / 0.09);
@@ -3179,7 +3171,7 @@ void DataProcessor::decodeCCBytes(const QByteArray &buffer) {
 
 			if (set->getPenelopePresence() || (m_hwInterface == QSDR::Hermes)) { // || set->getPennyLanePresence() {
 
-				de->io.ccRx.ain3 = (quint16)((quint16)(buffer.at(3) << 8) + (quint16)buffer.at(4));
+				de->io.ccRx.ain3 = (quint16)((quint16)(buffer[3] << 8) + (quint16)buffer[4]);
 				de->io.ain3Volts = (qreal)(3.3 * (double)de->io.ccRx.ain3 / 4095.0);
 			}
 			//qDebug() << "ain3Volts: " << io.ain3Volts;
@@ -3191,8 +3183,8 @@ void DataProcessor::decodeCCBytes(const QByteArray &buffer) {
 
 			if (set->getPenelopePresence() || (m_hwInterface == QSDR::Hermes)) { // || set->getPennyLanePresence() {
 
-				de->io.ccRx.ain4 = (quint16)((quint16)(buffer.at(1) << 8) + (quint16)buffer.at(2));
-				de->io.ccRx.ain6 = (quint16)((quint16)(buffer.at(3) << 8) + (quint16)buffer.at(4));
+				de->io.ccRx.ain4 = (quint16)((quint16)(buffer[1] << 8) + (quint16)buffer[2]);
+				de->io.ccRx.ain6 = (quint16)((quint16)(buffer[3] << 8) + (quint16)buffer[4]);
 
 				de->io.ain4Volts = (qreal)(3.3 * (qreal)de->io.ccRx.ain4 / 4095.0);
 
@@ -3209,29 +3201,29 @@ void DataProcessor::decodeCCBytes(const QByteArray &buffer) {
 			//switch (io.receivers) {
 
 			//	case 1:
-			//		io.ccRx.mercury1_LT2208 = (bool)((buffer.at(1) & 0x02) == 0x02);
+			//		io.ccRx.mercury1_LT2208 = (bool)((buffer[1] & 0x02) == 0x02);
 			//		//qDebug() << "mercury1_LT2208: " << io.ccRx.mercury1_LT2208;
 			//		break;
 
 			//	case 2:
-			//		io.ccRx.mercury1_LT2208 = (bool)((buffer.at(1) & 0x02) == 0x02);
-			//		io.ccRx.mercury2_LT2208 = (bool)((buffer.at(2) & 0x02) == 0x02);
+			//		io.ccRx.mercury1_LT2208 = (bool)((buffer[1] & 0x02) == 0x02);
+			//		io.ccRx.mercury2_LT2208 = (bool)((buffer[2] & 0x02) == 0x02);
 			//		//qDebug() << "mercury1_LT2208: " << io.ccRx.mercury1_LT2208 << "mercury2_LT2208" << io.ccRx.mercury2_LT2208;
 			//		break;
 
 			//	case 3:
-			//		io.ccRx.mercury1_LT2208 = (bool)((buffer.at(1) & 0x02) == 0x02);
-			//		io.ccRx.mercury2_LT2208 = (bool)((buffer.at(2) & 0x02) == 0x02);
-			//		io.ccRx.mercury3_LT2208 = (bool)((buffer.at(3) & 0x02) == 0x02);
+			//		io.ccRx.mercury1_LT2208 = (bool)((buffer[1] & 0x02) == 0x02);
+			//		io.ccRx.mercury2_LT2208 = (bool)((buffer[2] & 0x02) == 0x02);
+			//		io.ccRx.mercury3_LT2208 = (bool)((buffer[3] & 0x02) == 0x02);
 			//		//qDebug() << "mercury1_LT2208: " << io.ccRx.mercury1_LT2208 << "mercury2_LT2208" << io.ccRx.mercury2_LT2208;
 			//		//qDebug() << "mercury3_LT2208: " << io.ccRx.mercury3_LT2208;
 			//		break;
 
 			//	case 4:
-			//		io.ccRx.mercury1_LT2208 = (bool)((buffer.at(1) & 0x02) == 0x02);
-			//		io.ccRx.mercury2_LT2208 = (bool)((buffer.at(2) & 0x02) == 0x02);
-			//		io.ccRx.mercury3_LT2208 = (bool)((buffer.at(3) & 0x02) == 0x02);
-			//		io.ccRx.mercury4_LT2208 = (bool)((buffer.at(4) & 0x02) == 0x02);
+			//		io.ccRx.mercury1_LT2208 = (bool)((buffer[1] & 0x02) == 0x02);
+			//		io.ccRx.mercury2_LT2208 = (bool)((buffer[2] & 0x02) == 0x02);
+			//		io.ccRx.mercury3_LT2208 = (bool)((buffer[3] & 0x02) == 0x02);
+			//		io.ccRx.mercury4_LT2208 = (bool)((buffer[4] & 0x02) == 0x02);
 			//		//qDebug() << "mercury1_LT2208: " << io.ccRx.mercury1_LT2208 << "mercury2_LT2208" << io.ccRx.mercury2_LT2208;
 			//		//qDebug() << "mercury3_LT2208: " << io.ccRx.mercury3_LT2208 << "mercury4_LT2208" << io.ccRx.mercury4_LT2208;
 			//		break;
@@ -3240,14 +3232,17 @@ void DataProcessor::decodeCCBytes(const QByteArray &buffer) {
 	} // end switch cycle through C0
 }
 
-void DataProcessor::setOutputBuffer(int rx, const CPX &buffer) {
+void DataProcessor::setOutputBuffer(int rx, const qVectorFloat &buffer, int channels) {
 
 	if (rx == de->io.currentReceiver) {
-		processOutputBuffer(buffer);
+
+		QMutexLocker locker(&m_outputMutex);
+		processOutputBuffer(buffer, channels);
 	}
 }
 
-void DataProcessor::processOutputBuffer(const CPX &buffer) {
+// mono audio goes out on both channels, binaural audio is interleaved
+void DataProcessor::processOutputBuffer(const qVectorFloat &buffer, int channels) {
 
 	//DATA_PROCESSOR_DEBUG << "processOutputBuffer: " << this->thread();
 
@@ -3256,11 +3251,25 @@ void DataProcessor::processOutputBuffer(const CPX &buffer) {
     qint16 leftTXSample;
     qint16 rightTXSample;
 
+	// the receiver output is already decimated to 48 kHz: the first
+	// BUFFER_SIZE / outputMultiplier samples of the buffer are valid.
+	int samples = BUFFER_SIZE / de->io.outputMultiplier;
+
+	const float *audio = buffer.constData();
+
 	// process the output
-	for (int j = 0; j < BUFFER_SIZE; j += de->io.outputMultiplier) {
+	for (int j = 0; j < samples; j++) {
+
+		if (channels == 2) {
+
+			leftRXSample  = (qint16)(audio[2 * j] * 32767.0f);
+			rightRXSample = (qint16)(audio[2 * j + 1] * 32767.0f);
+		}
+		else {
 
-		leftRXSample  = (qint16)(buffer.at(j).re * 32767.0f);
-		rightRXSample = (qint16)(buffer.at(j).im * 32767.0f);
+			leftRXSample  = (qint16)(audio[j] * 32767.0f);
+			rightRXSample = leftRXSample;
+		}
 
 		leftTXSample = 0;
         rightTXSample = 0;
@@ -3733,6 +3742,8 @@ WideBandDataProcessor::WideBandDataProcessor(THPSDRParameter *ioData, QSDR::_Ser
 	: QObject()
 	, io(ioData)
 	, set(Settings::instance())
+	, wbFFT(0)
+	, wbAverager(0)
 	, m_serverMode(serverMode)
 	, m_size(size)
 	, m_bytes(0)
@@ -3755,7 +3766,8 @@ WideBandDataProcessor::WideBandDataProcessor(THPSDRParameter *ioData, QSDR::_Ser
 			
 			QFilter::MakeWindow(12, m_size, (float *)io->wbWindow.data()); // 12 = BLACKMANHARRIS_WINDOW
 
-			wbAverager = new DualModeAverager(-1, m_size/2);
+			wbAverager = new QPowerAverager(m_size/4);
+			m_wbPower.resize(m_size/4);
 
 			break;
 
@@ -3794,7 +3806,13 @@ void WideBandDataProcessor::processWideBandData() {
 
 	forever {
 
-		processWideBandInputBuffer(io->wb_queue.dequeue());
+		int length;
+		const char *buf = io->wb_queue.readSlot(&length);
+		if (buf) {
+
+			processWideBandInputBuffer(buf, length);
+			io->wb_queue.commitRead();
+		}
 		
 		QMutexLocker locker(&m_mutex);
 		if (m_stopped) {
@@ -3804,7 +3822,7 @@ void WideBandDataProcessor::processWideBandData() {
 	}
 }
 
-void WideBandDataProcessor::processWideBandInputBuffer(const QByteArray &buffer) {
+void WideBandDataProcessor::processWideBandInputBuffer(const char *buffer, int length) {
 
 	int size;
 
@@ -3813,8 +3831,7 @@ void WideBandDataProcessor::processWideBandInputBuffer(const QByteArray &buffer)
 	else
 		size = 2 * SMALLWIDEBANDSIZE;
 
-	qint64 length = buffer.length();
-	if (buffer.length() != size) {
+	if (length != size) {
 
 		//WIDEBAND_PROCESSOR_DEBUG << "wrong wide band buffer length: " << length;
 		return;
@@ -3826,8 +3843,8 @@ void WideBandDataProcessor::processWideBandInputBuffer(const QByteArray &buffer)
 
 	for (int i = 0; i < length; i += 2) {
 
-		s =  (int)((qint8 ) buffer.at(i+1)) << 8;
-		s += (int)((quint8) buffer.at(i));
+		s =  (int)((qint8 ) buffer[i+1]) << 8;
+		s += (int)((quint8) buffer[i]);
 		sample = (float)(s * norm);
 
 		cpxWBIn[i/2].re = sample * io->wbWindow.at(i/2);
@@ -3836,28 +3853,38 @@ void WideBandDataProcessor::processWideBandInputBuffer(const QByteArray &buffer)
 
 	wbFFT->DoFFTWForward(cpxWBIn, cpxWBOut, size/2);
 
-	// averaging
-	QVector<float> specBuf(size/4);
+	// averaging on the linear power, the dB conversion goes straight into
+	// the mailbox slot
+	QHMailbox<qVectorFloat> *box = set->widebandMailbox();
+	QVector<float> &specBuf = box->writeSlot();
+	specBuf.resize(size/4);
 
 	m_mutex.lock();
 	if (m_wbSpectrumAveraging) {
 
-		for (int i = 0; i < size/4; i++)
-			specBuf[i] = (float)(10.0 * log10(MagCPX(cpxWBOut.at(i)) + 1.5E-45));
+		// sized once per wide band buffer size
+		if (wbAverager->size() != size/4) {
+
+			wbAverager->setSize(size/4);
+			m_wbPower.resize(size/4);
+		}
+		wbAverager->setMode(ExponentialAveraging, set->getSpectrumAveragingCnt(-1));
 
-		wbAverager->ProcessDBAverager(specBuf, specBuf);
+		QtDSP::magnitudeSquared(cpxWBOut.constData(), m_wbPower.data(), size/4);
+		wbAverager->ProcessPower(m_wbPower.constData());
+		QtDSP::powerDb(wbAverager->result(), specBuf.data(), size/4, 1.5E-45f, 0.0f);
 		m_mutex.unlock();
 	}
 	else {
 
-		for (int i = 0; i < size/4; i++)
-			specBuf[i] = (float)(10.0 * log10(MagCPX(cpxWBOut.at(i)) + 1.5E-45));
+		QtDSP::magnitudeDb(cpxWBOut.constData(), specBuf.data(), size/4, 1.5E-45f, 0.0f);
 
 		m_mutex.unlock();
 	}
 
-	//set->setWidebandSpectrumBuffer(specBuf);
-	emit wbSpectrumBufferChanged(specBuf);
+	// the panel is only notified if it has taken the previous spectrum
+	if (box->commitWrite())
+		emit wbSpectrumBufferChanged();
 }
 
 void WideBandDataProcessor::setWbSpectrumAveraging(QObject* sender, int rx, bool value) {
@@ -3868,5 +3895,6 @@ void WideBandDataProcessor::setWbSpectrumAveraging(QObject* sender, int rx, bool
 
 	m_mutex.lock();
 	m_wbSpectrumAveraging = value;
+	if (wbAverager) wbAverager->reset();
 	m_mutex.unlock();
 }
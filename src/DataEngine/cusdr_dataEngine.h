@@ -45,10 +45,12 @@
 
 #include "cusdr_settings.h"
 #include "cusdr_dataIO.h"
+#include "cusdr_iqUnpacker.h"
 #include "Util/qcircularbuffer.h"
 #include "QtDSP/qtdsp_fft.h"
+#include "QtDSP/qtdsp_kernels.h"
 #include "QtDSP/qtdsp_filter.h"
-#include "QtDSP/qtdsp_dualModeAverager.h"
+#include "QtDSP/qtdsp_powerAverager.h"
 #include "cusdr_receiver.h"
 //#include "AudioEngine/cusdr_audio_engine.h"
 #include "AudioEngine/cusdr_audioEngine.h"
@@ -100,7 +102,6 @@ public:
 
     QList<Receiver *>		RX;
 	QList<bool>				rxDisplayList;
-	QList<qreal>			chirpData;
 
 	bool	clientConnected;
 	bool	dataIOThreadRunning;
@@ -176,6 +177,7 @@ private:
 	void	createAudioReceiver();
 
 	bool	addReceiver(int rx);
+	void	pinReceiverThread(int rx);
 	void	initIOData();
 	bool	start();
 	bool	startDataEngineWithoutConnection();
@@ -278,7 +280,11 @@ private:
 	int		m_offset;
 
 	int		m_rxSamples;
-	int		m_chirpSamples;
+
+	// chirp ring slot being filled by processFileBuffer()
+	float*	m_chirpSlot;
+	int		m_chirpFill;
+	qint64	m_chirpPosition;	// samples since the start of the file
 
 	int		m_leftSample;
 	int		m_rightSample;
@@ -374,11 +380,11 @@ public slots:
 private slots:
 	void	initDataProcessorSocket();
 	void	displayDataProcessorSocketError(QAbstractSocket::SocketError error);
-	void	processInputBuffer(const QByteArray &buffer);
-	void	processOutputBuffer(const CPX &buffer);
-	void	decodeCCBytes(const QByteArray &buffer);
+	void	processInputBuffer(const char *buffer);
+	void	processOutputBuffer(const qVectorFloat &buffer, int channels);
+	void	decodeCCBytes(const char *buffer);
 	void	encodeCCBytes();
-	void	setOutputBuffer(int rx, const CPX &buffer);
+	void	setOutputBuffer(int rx, const qVectorFloat &buffer, int channels);
 	void	writeData();
 	
 private:
@@ -387,6 +393,12 @@ private:
 	//QUdpSocket*		socket;
 	QUdpSocket*		m_dataProcessorSocket;
 
+	IQFrameUnpacker	m_unpacker;
+
+	// heap allocations seen on the frame path (should stay 0)
+	int				m_allocations;
+	void			checkAllocations();
+
 	QSDR::_Error			m_error;
 	QSDR::_ServerMode		m_serverMode;
 	QSDR::_HWInterfaceMode	m_hwInterface;
@@ -395,6 +407,7 @@ private:
 	QHostAddress	m_deviceAddress;
 	QMutex			m_mutex;
 	QMutex			m_spectrumMutex;
+	QMutex			m_outputMutex;
 	QByteArray		m_IQDatagram;
 	//QByteArray		m_audioDatagram;
 	QByteArray		m_outDatagram;
@@ -511,17 +524,18 @@ public slots:
 private slots:
 	//void	initDataProcessorSocket();
 	//void	displayDataProcessorSocketError(QAbstractSocket::SocketError error);
-	void	processWideBandInputBuffer(const QByteArray &buffer);
+	void	processWideBandInputBuffer(const char *buffer, int length);
 	
 private:
 	THPSDRParameter*	io;
 	Settings*			set;
 
 	QFFT*				wbFFT;
-	DualModeAverager*	wbAverager;
+	QPowerAverager*		wbAverager;
 	
 	CPX					cpxWBIn;
 	CPX					cpxWBOut;
+	QVector<float>		m_wbPower;
 
 	QMutex				m_mutex;
 	QByteArray			m_WBDatagram;
@@ -539,7 +553,7 @@ private:
 
 signals:
 	void	messageEvent(QString message);
-	void	wbSpectrumBufferChanged(const qVectorFloat &buffer);
+	void	wbSpectrumBufferChanged();
 };
  
 
@@ -30,6 +30,12 @@
 
 #if defined(Q_OS_WIN32)
 #include <winsock2.h>
+#elif defined(Q_OS_LINUX)
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <poll.h>
+#include <errno.h>
+#include <time.h>
 #endif
 
 
@@ -53,6 +59,9 @@ DataIO::DataIO(THPSDRParameter *ioData)
 	, m_stopped(false)
 {
 	m_dataIOSocket = 0;
+#if defined(Q_OS_LINUX)
+	m_receiveThread = 0;
+#endif
 
 	m_metisGetDataSignature.resize(3);
 	m_metisGetDataSignature[0] = (char)0xEF;
@@ -62,6 +71,7 @@ DataIO::DataIO(THPSDRParameter *ioData)
 
 	m_datagram.resize(1032);
 	m_wbDatagram.resize(0);
+	m_wbDatagram.reserve(2 * BIGWIDEBANDSIZE);
 	m_twoFramesDatagram.resize(0);
 
 	m_sendSequence = 0L;
@@ -114,6 +124,8 @@ DataIO::DataIO(THPSDRParameter *ioData)
 
 DataIO::~DataIO() {
 
+	stopReceiveThread();
+
 	if (m_dataIOSocketOn) {
 		m_dataIOSocket->close();
 		delete m_dataIOSocket;
@@ -128,6 +140,23 @@ void DataIO::stop() {
 	m_stopped = true;
 	m_mutex.unlock();
 	//io->networkIOMutex.unlock();
+
+	stopReceiveThread();
+}
+
+void DataIO::stopReceiveThread() {
+
+#if defined(Q_OS_LINUX)
+	if (m_receiveThread) {
+
+		m_receiveThread->stop();
+		m_receiveThread->wait();
+		delete m_receiveThread;
+		m_receiveThread = 0;
+
+		DATAIO_DEBUG << "receive thread stopped.";
+	}
+#endif
 }
 
 void DataIO::systemStateChanged(
@@ -212,15 +241,7 @@ void DataIO::initDataReceiverSocket() {
 							 //QUdpSocket::ReuseAddressHint | QUdpSocket::ShareAddress))
 	{
 
-#if defined(Q_OS_WIN32)
-		if (::setsockopt(m_dataIOSocket->socketDescriptor(), SOL_SOCKET,
-                     SO_RCVBUF, (char *)&newBufferSize, sizeof(newBufferSize)) == -1) {
-
-			//io->networkIOMutex.lock();
-			DATAIO_DEBUG << "dataIOSocket error!";
-			//io->networkIOMutex.unlock();
-		}
-#endif
+		setReceiveBufferSize(newBufferSize);
 
 		
 		m_dataIOSocket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
@@ -232,11 +253,25 @@ void DataIO::initDataReceiverSocket() {
 			this, 
 			SLOT(displayDataReceiverSocketError(QAbstractSocket::SocketError)));
 
+#if defined(Q_OS_LINUX)
+		// on Linux a dedicated thread drains the socket in batches with
+		// recvmmsg() and reads the kernel receive time stamp of each packet.
+		int on = 1;
+		if (::setsockopt(m_dataIOSocket->socketDescriptor(), SOL_SOCKET,
+					SO_TIMESTAMPNS, &on, sizeof(on)) == -1) {
+
+			DATAIO_DEBUG << "could not enable kernel time stamps.";
+		}
+
+		m_receiveThread = new DataIOReceiveThread(this, m_dataIOSocket->socketDescriptor());
+		m_receiveThread->start(QThread::HighPriority);
+#else
 		CHECKED_CONNECT(
 			m_dataIOSocket,
 			SIGNAL(readyRead()), 
 			this, 
 			SLOT(readDeviceData()));
+#endif
 
 
 		//io->networkIOMutex.lock();
@@ -263,106 +298,116 @@ void DataIO::readDeviceData() {
 		QMutexLocker locker(&io->networkIOMutex);
 		//DATAIO_DEBUG << "sequence :" << m_sequence << "; m_stopped = " << m_stopped;
 		//DATAIO_DEBUG << "stopped = " << m_stopped;
-		//io->networkIOMutex.lock();
-		//m_mutex.lock();
-		//if (m_stopped) {
-		//	DATAIO_DEBUG << "m_stopped = " << m_stopped;
-		//	m_stopped = false;
-		//	//io->networkIOMutex.unlock();
-		//	m_mutex.unlock();
-		//	break;
-		//}
-		////io->networkIOMutex.unlock();
-		//m_mutex.unlock();
-
-		if (m_dataIOSocket->readDatagram(m_datagram.data(), m_datagram.size()) == METIS_DATA_SIZE) {
-			
-			if (m_datagram.left(3) == m_metisGetDataSignature) {
 
-				if (m_datagram[3] == (char)0x06) {
+		// receive straight into the next free slot of the IQ ring; if the
+		// ring is full the datagram is read into m_datagram and dropped.
+		char *slot = io->iq_queue.writeSlot();
+		char *datagram = slot ? slot : m_datagram.data();
 
-					m_sequence  = (m_datagram[4] & 0xFF) << 24;
-					m_sequence += (m_datagram[5] & 0xFF) << 16;
-					m_sequence += (m_datagram[6] & 0xFF) << 8;
-					m_sequence += (m_datagram[7] & 0xFF);
+		qint64 length = m_dataIOSocket->readDatagram(datagram, METIS_DATA_SIZE);
+		bool iqFrame = processDeviceDatagram(datagram, length, 0);
 
-					//DATAIO_DEBUG << "sequence :" << m_sequence;
+		if (slot)
+			io->iq_queue.commitWrite(iqFrame ? (int) length : 0);
+		else if (iqFrame && io->iq_queue.overruns() % 100 == 1)
+			DATAIO_DEBUG << "iq ring full, " << io->iq_queue.overruns() << " frames dropped.";
+	}
+}
 
-					if (m_sequence != m_oldSequence + 1) {
+// returns true if the datagram is an EP6 IQ frame for the data processor.
+bool DataIO::processDeviceDatagram(const char *datagram, qint64 length, qint64 timestamp) {
 
-						DATAIO_DEBUG << "readData missed " << m_sequence - m_oldSequence << " packages.";
+	if (length == METIS_DATA_SIZE) {
+			
+		if (memcmp(datagram, m_metisGetDataSignature.constData(), 3) == 0) {
 
-						if (m_packetLossTime.elapsed() > 100) {
-							
-							set->setPacketLoss(2);
-							m_packetLossTime.restart();
-						}
-					}
+			if (datagram[3] == (char)0x06) {
 
-					m_oldSequence = m_sequence;
+				m_sequence  = (datagram[4] & 0xFF) << 24;
+				m_sequence += (datagram[5] & 0xFF) << 16;
+				m_sequence += (datagram[6] & 0xFF) << 8;
+				m_sequence += (datagram[7] & 0xFF);
 
-					//// enqueue first half of the HPSDR frame from the HPSDR device
-					//io->iq_queue.enqueue(m_datagram.mid(METIS_HEADER_SIZE, BUFFER_SIZE/2));
-					//// enqueue second half of the HPSDR frame from the HPSDR device
-					//io->iq_queue.enqueue(m_datagram.right(BUFFER_SIZE/2));
+				//DATAIO_DEBUG << "sequence :" << m_sequence;
 
-					// enqueue one frame from the HPSDR device
-					//DATAIO_DEBUG << "iq_queue.enqueue()";
-					io->iq_queue.enqueue(m_datagram.mid(METIS_HEADER_SIZE, BUFFER_SIZE));
+				if (m_sequence != m_oldSequence + 1) {
 
+					DATAIO_DEBUG << "readData missed " << m_sequence - m_oldSequence << " packages.";
+
+					if (m_packetLossTime.elapsed() > 100) {
+							
+						set->setPacketLoss(2);
+						m_packetLossTime.restart();
+					}
 				}
-				else if (m_datagram[3] == (char)0x04) { // wide band data
 
-					//qDebug() << "wideband data received!";
-					m_sequenceWideBand  = (m_datagram[4] & 0xFF) << 24;
-					m_sequenceWideBand += (m_datagram[5] & 0xFF) << 16;
-					m_sequenceWideBand += (m_datagram[6] & 0xFF) << 8;
-					m_sequenceWideBand += (m_datagram[7] & 0xFF);
+				m_oldSequence = m_sequence;
+
+				// the frame is already in its IQ ring slot
+				return true;
+			}
+			else if (datagram[3] == (char)0x04) { // wide band data
+
+				//qDebug() << "wideband data received!";
+				m_sequenceWideBand  = (datagram[4] & 0xFF) << 24;
+				m_sequenceWideBand += (datagram[5] & 0xFF) << 16;
+				m_sequenceWideBand += (datagram[6] & 0xFF) << 8;
+				m_sequenceWideBand += (datagram[7] & 0xFF);
 
-					if (m_sequenceWideBand != m_oldSequenceWideBand + 1) {
+				if (m_sequenceWideBand != m_oldSequenceWideBand + 1) {
 
-						DATAIO_DEBUG << "wideband readData missed " << m_sequenceWideBand - m_oldSequenceWideBand << " packages.";
+					DATAIO_DEBUG << "wideband readData missed " << m_sequenceWideBand - m_oldSequenceWideBand << " packages.";
 
-						if (m_packetLossTime.elapsed() > 100) {
+					if (m_packetLossTime.elapsed() > 100) {
 							
-							set->setPacketLoss(2);
-							m_packetLossTime.restart();
-						}
+						set->setPacketLoss(2);
+						m_packetLossTime.restart();
 					}
+				}
 					
-					m_oldSequenceWideBand = m_sequenceWideBand;
+				m_oldSequenceWideBand = m_sequenceWideBand;
 
-					// three 'if's from KISS Konsole
-					if ((m_wbBuffers & m_datagram[7]) == 0) {
+				// three 'if's from KISS Konsole
+				if ((m_wbBuffers & datagram[7]) == 0) {
 
-						m_sendEP4 = true;
-						m_wbCount = 0;
-					}
+					m_sendEP4 = true;
+					m_wbCount = 0;
+				}
 
-					if (m_sendEP4) {
+				if (m_sendEP4) {
 
-						m_wbDatagram.append(m_datagram.mid(METIS_HEADER_SIZE, BUFFER_SIZE));
-					}
+					const char *data = m_wbDatagram.constData();
+					m_wbDatagram.append(datagram + METIS_HEADER_SIZE, BUFFER_SIZE);
+
+					// the buffer is reserved for a full wide band block
+					if (m_wbDatagram.constData() != data && m_wbDatagram.size() > BUFFER_SIZE)
+						io->frameAllocations.fetchAndAddRelaxed(1);
+				}
 						
-					if (m_wbCount++ == m_wbBuffers) {
+				if (m_wbCount++ == m_wbBuffers) {
+
+					// enqueue
+					m_sendEP4 = false;
+					if (!io->wb_queue.enqueue(m_wbDatagram.constData(), m_wbDatagram.size(), timestamp)) {
 
-						// enqueue
-						m_sendEP4 = false;
-						io->wb_queue.enqueue(m_wbDatagram);
-						m_wbDatagram.resize(0);
+						if (io->wb_queue.overruns() % 100 == 1)
+							DATAIO_DEBUG << "wideband ring full, " << io->wb_queue.overruns() << " buffers dropped.";
 					}
+					m_wbDatagram.resize(0);
 				}
 			}
-			else {
-				
-				DATAIO_DEBUG << "got wrong HPSDR device signature!";
-			}
 		}
 		else {
-			
-			DATAIO_DEBUG << "got wrong HPSDR device data size!";
+				
+			DATAIO_DEBUG << "got wrong HPSDR device signature!";
 		}
 	}
+	else {
+			
+		DATAIO_DEBUG << "got wrong HPSDR device data size!";
+	}
+
+	return false;
 }
 
 void DataIO::readData() {
@@ -521,6 +566,31 @@ void DataIO::displayDataReceiverSocketError(QAbstractSocket::SocketError error)
 	//io->networkIOMutex.unlock();
 }
 
+void DataIO::setReceiveBufferSize(int size) {
+
+	if (!m_dataIOSocket) return;
+
+#if defined(Q_OS_WIN32) || defined(Q_OS_LINUX)
+	if (::setsockopt(m_dataIOSocket->socketDescriptor(), SOL_SOCKET,
+                     SO_RCVBUF, (char *)&size, sizeof(size)) == -1) {
+
+		DATAIO_DEBUG << "dataIOSocket error!";
+	}
+#endif
+
+#if defined(Q_OS_LINUX)
+	// the kernel doubles the requested size and caps it at net.core.rmem_max
+	int actualSize = 0;
+	socklen_t optionLength = sizeof(actualSize);
+
+	if (::getsockopt(m_dataIOSocket->socketDescriptor(), SOL_SOCKET,
+                     SO_RCVBUF, &actualSize, &optionLength) == 0 && actualSize < size) {
+
+		DATAIO_DEBUG << "socket buffer size limited to " << actualSize / 1024 << " kB (net.core.rmem_max).";
+	}
+#endif
+}
+
 void DataIO::setManualSocketBufferSize(QObject *sender, bool value) {
 
 	Q_UNUSED (sender)
@@ -534,29 +604,13 @@ void DataIO::setManualSocketBufferSize(QObject *sender, bool value) {
 		if (m_manualBufferSize) {
 
 			DATAIO_DEBUG << "set data IO socket BufferSize to " << m_socketBufferSize;
-#if defined(Q_OS_WIN32)
-			if (::setsockopt(m_dataIOSocket->socketDescriptor(), SOL_SOCKET,
-                     SO_RCVBUF, (char *)&socketBufferSize, sizeof(socketBufferSize)) == -1) {
-
-				//io->networkIOMutex.lock();
-				DATAIO_DEBUG << "dataIOSocket error!";
-				//io->networkIOMutex.unlock();
-			}
-#endif
+			setReceiveBufferSize(socketBufferSize);
 		}
 		else {
 
 			DATAIO_DEBUG << "set data IO socket BufferSize to 32 kB.";
 			socketBufferSize = 1032 * 32;
-#if defined(Q_OS_WIN32)
-			if (::setsockopt(m_dataIOSocket->socketDescriptor(), SOL_SOCKET,
-                     SO_RCVBUF, (char *)&socketBufferSize, sizeof(socketBufferSize)) == -1) {
-
-				//io->networkIOMutex.lock();
-				DATAIO_DEBUG << "dataIOSocket error!";
-				//io->networkIOMutex.unlock();
-			}
-#endif
+			setReceiveBufferSize(socketBufferSize);
 		}
 	io->networkIOMutex.unlock();
 }
@@ -569,15 +623,7 @@ void DataIO::setSocketBufferSize(QObject *sender, int value) {
 	DATAIO_DEBUG << "m_socketBufferSize = " << value;
 
 	io->networkIOMutex.lock();
-#if defined(Q_OS_WIN32)
-		if (::setsockopt(m_dataIOSocket->socketDescriptor(), SOL_SOCKET,
-                     SO_RCVBUF, (char *)&socketBufferSize, sizeof(socketBufferSize)) == -1) {
-
-			//io->networkIOMutex.lock();
-			DATAIO_DEBUG << "dataIOSocket error!";
-			//io->networkIOMutex.unlock();
-		}
-#endif
+		setReceiveBufferSize(socketBufferSize);
 	io->networkIOMutex.unlock();
 }
 
@@ -611,16 +657,126 @@ void DataIO::setSampleRate(QObject *sender, int value) {
 
 		default:
 			DATAIO_DEBUG << "invalid sample rate !\n";
-			break;
+			return;
 	}
 
-#if defined(Q_OS_WIN32)
-		if (::setsockopt(m_dataIOSocket->socketDescriptor(), SOL_SOCKET,
-                     SO_RCVBUF, (char *)&bufferSize, sizeof(bufferSize)) == -1) {
+	setReceiveBufferSize(bufferSize);
+
+	//io->networkIOMutex.unlock();
+}
+
+#if defined(Q_OS_LINUX)
+
+// *********************************************************************
+// Linux receive thread
+
+DataIOReceiveThread::DataIOReceiveThread(DataIO *dataIO, int socketDescriptor)
+	: QThread()
+	, m_dataIO(dataIO)
+	, m_socket(socketDescriptor)
+	, m_stopped(false)
+{
+}
+
+void DataIOReceiveThread::stop() {
+
+	m_stopped = true;
+}
+
+void DataIOReceiveThread::run() {
+
+	struct mmsghdr	msgs[RECV_BATCH_SIZE];
+	struct iovec	iovecs[RECV_BATCH_SIZE];
+
+	THPSDRParameter *io = m_dataIO->io;
+
+	memset(msgs, 0, sizeof(msgs));
+	for (int i = 0; i < RECV_BATCH_SIZE; i++) {
+
+		iovecs[i].iov_len  = METIS_DATA_SIZE;
+
+		msgs[i].msg_hdr.msg_iov = &iovecs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_control = m_control[i];
+	}
+
+	struct pollfd pfd;
+	pfd.fd = m_socket;
+	pfd.events = POLLIN;
+
+	DATAIO_DEBUG << "receive thread started, batch size " << RECV_BATCH_SIZE;
+
+	while (!m_stopped) {
+
+		// wake up regularly to check the stop flag
+		int ready = ::poll(&pfd, 1, 100);
+		if (ready <= 0) {
+
+			if (ready < 0 && errno != EINTR) {
 
-			DATAIO_DEBUG << "dataIOSocket error!";
+				DATAIO_DEBUG << "receive thread poll error " << errno;
+				break;
+			}
+			continue;
 		}
-#endif
 
-	//io->networkIOMutex.unlock();
-}
\ No newline at end of file
+		// receive straight into the free slots of the IQ ring; only if the
+		// ring is full the batch goes to the scratch buffer and is dropped.
+		int slots = qMin(RECV_BATCH_SIZE, io->iq_queue.freeSlots());
+		bool inRing = slots > 0;
+		if (!inRing) slots = RECV_BATCH_SIZE;
+
+		for (int i = 0; i < slots; i++) {
+
+			iovecs[i].iov_base = inRing ? io->iq_queue.writeSlotAt(i) : m_buffer[i];
+
+			// the kernel overwrites the control length of every message
+			msgs[i].msg_hdr.msg_controllen = sizeof(m_control[i]);
+		}
+
+		int packets = ::recvmmsg(m_socket, msgs, slots, MSG_DONTWAIT, 0);
+		if (packets < 0) {
+
+			if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+				continue;
+
+			DATAIO_DEBUG << "receive thread recvmmsg error " << errno;
+			break;
+		}
+
+		QMutexLocker locker(&io->networkIOMutex);
+
+		for (int i = 0; i < packets; i++) {
+
+			qint64 timestamp = 0;
+			for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsg; cmsg = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg)) {
+
+				if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+
+					struct timespec ts;
+					memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+					timestamp = (qint64) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+				}
+			}
+
+			const char *datagram = (const char *) iovecs[i].iov_base;
+			bool iqFrame = m_dataIO->processDeviceDatagram(datagram, msgs[i].msg_len, timestamp);
+
+			// every ring slot is committed in order, non-IQ datagrams as empty slots
+			if (inRing) {
+
+				io->iq_queue.commitWrite(iqFrame ? (int) msgs[i].msg_len : 0, timestamp);
+			}
+			else if (iqFrame) {
+
+				io->iq_queue.countOverrun();
+				if (io->iq_queue.overruns() % 100 == 1)
+					DATAIO_DEBUG << "iq ring full, " << io->iq_queue.overruns() << " frames dropped.";
+			}
+		}
+	}
+
+	DATAIO_DEBUG << "receive thread finished.";
+}
+
+#endif // Q_OS_LINUX
@@ -44,6 +44,11 @@
 #   define DATAIO_DEBUG nullDebug()
 #endif
 
+// number of datagrams fetched with one recvmmsg() call
+#define RECV_BATCH_SIZE		32
+
+class DataIOReceiveThread;
+
 
 class DataIO : public QObject {
 
@@ -77,6 +82,12 @@ private slots:
 	void readDeviceData();
 	
 private:
+	friend class DataIOReceiveThread;
+
+	bool	processDeviceDatagram(const char *datagram, qint64 length, qint64 timestamp);
+	void	setReceiveBufferSize(int size);
+	void	stopReceiveThread();
+
 	Settings				*set;
 	QSDR::_Error			m_error;
 	QSDR::_ServerMode		m_serverMode;
@@ -84,6 +95,9 @@ private:
 	QSDR::_DataEngineState	m_dataEngineState;
 
 	QUdpSocket				*m_dataIOSocket;
+#if defined(Q_OS_LINUX)
+	DataIOReceiveThread		*m_receiveThread;
+#endif
 	QMutex					m_mutex;
 	QByteArray				m_commandDatagram;
 	QByteArray				m_datagram;
@@ -126,4 +140,31 @@ signals:
 	void	messageEvent(QString message);
 };
 
+#if defined(Q_OS_LINUX)
+
+/*!
+	\brief Drains the data IO socket with recvmmsg() and hands every datagram
+	together with its kernel receive time stamp to DataIO.
+*/
+class DataIOReceiveThread : public QThread {
+
+public:
+	DataIOReceiveThread(DataIO *dataIO, int socketDescriptor);
+
+	void	stop();
+
+protected:
+	void	run();
+
+private:
+	DataIO			*m_dataIO;
+	int				m_socket;
+	volatile bool	m_stopped;
+
+	char	m_buffer[RECV_BATCH_SIZE][METIS_DATA_SIZE];	// scratch when the IQ ring is full
+	qint64	m_control[RECV_BATCH_SIZE][8];	// cmsg space, 8 byte aligned
+};
+
+#endif // Q_OS_LINUX
+
 #endif // _CUSDR_DATAIO_H
@@ -0,0 +1,157 @@
+/**
+* @file  cusdr_iqUnpacker.cpp
+* @brief IQ frame unpacker class
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "cusdr_iqUnpacker.h"
+
+#include <string.h>
+
+#if defined(QTDSP_X86)
+#include <immintrin.h>
+#endif
+
+static const float IQ_SCALE  = 1.0f / 8388607.0f;	// 24 bit sample
+static const float MIC_SCALE = 1.0f / 32767.0f;		// 16 bit sample
+
+
+IQFrameUnpacker::IQFrameUnpacker()
+	: m_level(QtDSP::simdLevel())
+{
+	memset(m_slot, 0, sizeof(m_slot));
+	memset(m_i, 0, sizeof(m_i));
+	memset(m_q, 0, sizeof(m_q));
+	memset(m_mic, 0, sizeof(m_mic));
+}
+
+int IQFrameUnpacker::unpack(const char *payload, int receivers) {
+
+	if (receivers < 1 || receivers > MAX_RECEIVERS) return 0;
+
+	int samples = samplesPerFrame(receivers);
+	int stride = 6 * receivers + 2;
+	int words = 2 * receivers;
+
+	const char *slot = payload;
+	for (int s = 0; s < samples; s++) {
+
+		switch (m_level) {
+
+			case QtDSP::SimdAVX2:	convertSlotAVX2(slot, words); break;
+			case QtDSP::SimdSSE41:	convertSlotSSE41(slot, words); break;
+			default:				convertSlotScalar(slot, words); break;
+		}
+
+		for (int r = 0; r < receivers; r++) {
+
+			m_i[r][s] = m_slot[2*r];
+			m_q[r][s] = m_slot[2*r + 1];
+		}
+
+		const char *mic = slot + words * 3;
+		m_mic[s] = (float)(qint16)(((quint8) mic[0] << 8) | (quint8) mic[1]) * MIC_SCALE;
+
+		slot += stride;
+	}
+
+	return samples;
+}
+
+void IQFrameUnpacker::convertSlotScalar(const char *slot, int words) {
+
+	for (int j = 0; j < words; j++) {
+
+		int value  = (int)((  signed char) slot[0]) << 16;
+		value     += (int)((unsigned char) slot[1]) << 8;
+		value     += (int)((unsigned char) slot[2]);
+
+		m_slot[j] = (float) value * IQ_SCALE;
+		slot += 3;
+	}
+}
+
+#if defined(QTDSP_X86)
+
+// Four big-endian 24 bit words (12 bytes) are shuffled into the upper three
+// bytes of four 32 bit lanes; the arithmetic shift then sign extends them.
+
+QTDSP_TARGET("sse4.1")
+void IQFrameUnpacker::convertSlotSSE41(const char *slot, int words) {
+
+	const __m128i shuffle = _mm_setr_epi8(-1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9);
+	const __m128 scale = _mm_set1_ps(IQ_SCALE);
+
+	for (int j = 0; j < words; j += 4) {
+
+		__m128i v = _mm_loadu_si128((const __m128i *)(slot + 3*j));
+		v = _mm_srai_epi32(_mm_shuffle_epi8(v, shuffle), 8);
+
+		_mm_storeu_ps(m_slot + j, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+	}
+}
+
+QTDSP_TARGET("avx2")
+void IQFrameUnpacker::convertSlotAVX2(const char *slot, int words) {
+
+	const __m256i shuffle = _mm256_setr_epi8(
+		-1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9,
+		-1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9);
+	const __m256 scale = _mm256_set1_ps(IQ_SCALE);
+
+	for (int j = 0; j < words; j += 8) {
+
+		// 12 bytes per 128 bit lane: vpshufb does not cross lanes
+		__m128i lo = _mm_loadu_si128((const __m128i *)(slot + 3*j));
+
+		// up to four words left: the upper lane would read past
+		// USB_FRAME_OVERREAD at the end of the payload (1 and 2 receivers)
+		if (j + 4 >= words) {
+
+			__m128i v = _mm_srai_epi32(_mm_shuffle_epi8(lo, _mm256_castsi256_si128(shuffle)), 8);
+			_mm_storeu_ps(m_slot + j, _mm_mul_ps(_mm_cvtepi32_ps(v), _mm256_castps256_ps128(scale)));
+			break;
+		}
+
+		__m128i hi = _mm_loadu_si128((const __m128i *)(slot + 3*j + 12));
+
+		__m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+		v = _mm256_srai_epi32(_mm256_shuffle_epi8(v, shuffle), 8);
+
+		_mm256_storeu_ps(m_slot + j, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+	}
+}
+
+#else
+
+void IQFrameUnpacker::convertSlotSSE41(const char *slot, int words) {
+
+	convertSlotScalar(slot, words);
+}
+
+void IQFrameUnpacker::convertSlotAVX2(const char *slot, int words) {
+
+	convertSlotScalar(slot, words);
+}
+
+#endif // QTDSP_X86
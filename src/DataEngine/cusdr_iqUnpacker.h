@@ -0,0 +1,84 @@
+/**
+* @file  cusdr_iqUnpacker.h
+* @brief IQ frame unpacker header file
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef _CUSDR_IQUNPACKER_H
+#define _CUSDR_IQUNPACKER_H
+
+#include "cusdr_settings.h"
+#include "QtDSP/qtdsp_simd.h"
+
+// payload of one 512 byte USB frame after 3 sync and 5 C&C bytes
+#define USB_FRAME_PAYLOAD		504
+// max. samples per receiver in one frame (1 receiver: 504 / 8)
+#define USB_FRAME_MAX_SAMPLES	64
+// bytes the vector loads may read past the end of the payload
+#define USB_FRAME_OVERREAD		16
+
+
+/*!
+	\class IQFrameUnpacker
+	\brief Converts the 24 bit big-endian I/Q samples of N interleaved
+	receivers and the 16 bit mic samples of one USB frame into
+	per-receiver float buffers (structure of arrays) in one pass.
+
+	The frame layout for N receivers is (I0 Q0 I1 Q1 ... In-1 Qn-1 MIC)
+	repeated 504 / (6N + 2) times. The 24 bit to float conversion uses
+	SSE4.1 or AVX2 if available, the selection is done at construction.
+*/
+class IQFrameUnpacker {
+
+public:
+	IQFrameUnpacker();
+
+	// unpacks one frame payload in place; returns the number of samples per
+	// receiver. The vector loads read up to USB_FRAME_OVERREAD bytes past the
+	// payload, which the IQ ring slots always provide.
+	int		unpack(const char *payload, int receivers);
+
+	const float*	i(int rx) const	{ return m_i[rx]; }
+	const float*	q(int rx) const	{ return m_q[rx]; }
+	const float*	mic() const		{ return m_mic; }
+
+	QtDSP::SimdLevel	simdLevel() const	{ return m_level; }
+
+	static int	samplesPerFrame(int receivers)	{ return USB_FRAME_PAYLOAD / (6 * receivers + 2); }
+
+private:
+	QtDSP::SimdLevel	m_level;
+
+	// 24 bit words of one sample slot (2 * MAX_RECEIVERS) as float, padded to 16
+	float	m_slot[16];
+
+	float	m_i[MAX_RECEIVERS][USB_FRAME_MAX_SAMPLES];
+	float	m_q[MAX_RECEIVERS][USB_FRAME_MAX_SAMPLES];
+	float	m_mic[USB_FRAME_MAX_SAMPLES];
+
+	void	convertSlotScalar(const char *slot, int words);
+	void	convertSlotSSE41(const char *slot, int words);
+	void	convertSlotAVX2(const char *slot, int words);
+};
+
+#endif // _CUSDR_IQUNPACKER_H
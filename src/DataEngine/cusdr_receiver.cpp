@@ -39,24 +39,35 @@ Receiver::Receiver(int rx)
 	, m_receiver(rx)
 	, m_samplerate(set->getSampleRate())
 	, m_audioMode(1)
+	, m_dspLoad(0.0f)
+	, m_dspPeakLoad(0.0f)
+	, m_dspTimeSum(0.0)
+	, m_dspTimeMax(0.0)
+	, m_dspBlocks(0)
+	, m_inBlock(0)
+	, m_inBlockDropped(false)
+	, m_dspPending(0)
+	, m_blockAllocations(0)
 	//, m_calOffset(63.0)
 	//, m_calOffset(33.0)
 {
 	setReceiverData(set->getReceiverDataList().at(m_receiver));
 
 	InitCPX(inBuf, BUFFER_SIZE, 0.0f);
-	InitCPX(outBuf, BUFFER_SIZE, 0.0f);
+	// mono, or left and right interleaved for binaural output
+	outBuf.resize(2 * BUFFER_SIZE);
+	outBuf.fill(0.0f);
 
-	newSpectrum.resize(BUFFER_SIZE*4);
+	for (int i = 0; i < m_inRing.capacity(); i++)
+		InitCPX(m_inRing.at(i), BUFFER_SIZE, 0.0f);
 
 	qtdsp = 0;
 
 	setupConnections();
 
 	highResTimer = new HResTimer();
+	m_dspTimer = new HResTimer();
 	m_displayTime = (int)(1000000.0/set->getFramesPerSecond(m_receiver));
-
-	m_smeterTime.start();
 }
 
 Receiver::~Receiver() {
@@ -74,6 +85,10 @@ Receiver::~Receiver() {
 		delete highResTimer;
 	}
 
+	if (m_dspTimer) {
+		delete m_dspTimer;
+	}
+
 	m_stopped = false;
 }
 
@@ -197,12 +212,24 @@ void Receiver::setupConnections() {
 		this,
 		SLOT(setFilterFrequencies(QObject *, int, qreal, qreal)));
 
+	CHECKED_CONNECT(
+		set,
+		SIGNAL(filterLengthChanged(QObject *, int, int)),
+		this,
+		SLOT(setFilterLength(QObject *, int, int)));
+
 	CHECKED_CONNECT(
 		set,
 		SIGNAL(framesPerSecondChanged(QObject*, int, int)),
 		this,
 		SLOT(setFramesPerSecond(QObject*, int, int)));
 
+	CHECKED_CONNECT(
+		set,
+		SIGNAL(sMeterHoldTimeChanged(int)),
+		this,
+		SLOT(setSMeterHoldTime(int)));
+
 	/*CHECKED_CONNECT(
 		set,
 		SIGNAL(receiverDataReady()),
@@ -268,9 +295,11 @@ bool Receiver::initQtDSPInterface() {
 	qtdsp->filter->setFilter(
 						getFilterFromDSPMode(set->getDefaultFilterList(), mode).filterLo,
 						getFilterFromDSPMode(set->getDefaultFilterList(), mode).filterHi);
+	qtdsp->filter->setFilterLength(set->getFilterLength(m_receiver));
 	qtdsp->wpagc->setMode(m_agcMode);
 	qtdsp->wpagc->setAGCFixedGainDb(m_agcFixedGain_dB);
 	qtdsp->wpagc->setMaximumGainDb(m_agcMaximumGain_dB);
+	qtdsp->signalmeter->setPeakHold(set->getSMeterHoldTime(), SMETER_PEAK_FALL_DB);
 
 //	if (m_agcMode == (AGCMode) agcOFF)
 //		set->setAGCFixedGain_dB(this, m_receiver, m_agcFixedGain_dB);
@@ -296,14 +325,45 @@ void Receiver::deleteQtDSP() {
 	}
 }
 
-void Receiver::enqueueData() {
+cpx *Receiver::inputBlock() {
 
-	inQueue.enqueue(inBuf);
-	
-	if (inQueue.isFull()) {
-		RECEIVER_DEBUG << "inQueue full!";
+	if (!m_inBlock) {
+
+		m_inBlock = m_inRing.writeSlot();
+		m_inBlockDropped = (m_inBlock == 0);
+
+		// never block the de-interleaver: if this receiver cannot keep up
+		// the block goes to the scratch buffer and is dropped.
+		if (m_inBlockDropped)
+			m_inBlock = &inBuf;
+		else if (!m_inBlock->isDetached())
+			m_blockAllocations.fetchAndAddRelaxed(1);
+	}
+
+	// data() detaches a block still shared by the DSP side
+	return m_inBlock->data();
+}
+
+bool Receiver::commitInputBlock() {
+
+	if (!m_inBlock) return false;
+
+	bool dropped = m_inBlockDropped;
+	m_inBlock = 0;
+
+	if (dropped) {
+
+		m_inRing.countOverrun();
+		if (m_inRing.overruns() % 100 == 1)
+			RECEIVER_DEBUG << "input ring full for rx " << m_receiver << " (" << m_inRing.overruns() << " blocks dropped)";
+
+		return false;
 	}
 
+	m_inRing.commitWrite();
+
+	// one pending call drains all blocks queued until it runs
+	return m_dspPending.testAndSetOrdered(0, 1);
 }
 
 void Receiver::stop() {
@@ -311,36 +371,103 @@ void Receiver::stop() {
 	m_mutex.lock();
 	m_stopped = true;
 	m_mutex.unlock();
+
+	m_inRing.clear();
+
+	// a call still queued when the thread stops is never run; without the
+	// reset the next start could not post its first block
+	m_dspPending.fetchAndStoreOrdered(0);
+
+	QHMailbox<qVectorFloat> *spectrumBox = set->spectrumMailbox(m_receiver);
+
+	RECEIVER_DEBUG << "spectra for rx " << m_receiver << ": "
+		<< spectrumBox->published() << " published, "
+		<< spectrumBox->presented() << " presented, "
+		<< spectrumBox->dropped() << " dropped";
+
+	spectrumBox->resetCounters();
 }
 
 void Receiver::dspProcessing() {
 
 	//RECEIVER_DEBUG << "dspProcessing: " << this->thread();
 
-	//io.mutex.lock();
-	qtdsp->processDSP(inBuf, outBuf, BUFFER_SIZE);
-	//io.mutex.unlock();
+	// runs in the receiver's own thread: the data processor fills the
+	// blocks of m_inRing in place and posts a call only if none is pending.
+	m_dspPending.fetchAndStoreOrdered(0);
 
-	// spectrum
-	qtdsp->getSpectrum(newSpectrum, set->getFFTMultiplicator(m_receiver));
-	if (highResTimer->getElapsedTimeInMicroSec() >= getDisplayDelay()) {
+	while (CPX *buf = m_inRing.readSlot()) {
 
-		emit spectrumBufferChanged(m_receiver, newSpectrum);
-		highResTimer->start();
+		processBlock(*buf);
+		m_inRing.commitRead();
 	}
+}
 
-	if (m_receiver == set->getCurrentReceiver()) {
-		// S-Meter
-		if (m_smeterTime.elapsed() > 20) {
+void Receiver::processBlock(CPX &buf) {
+
+	m_dspTimer->start();
+
+	qtdsp->processDSP(buf, outBuf, BUFFER_SIZE);
+
+	// spectrum at the display rate (none until the first spectrum size is
+	// built and a hop of new samples is in), written into the mailbox slot
+	// in place; the display is notified only if it has taken the previous
+	// spectrum, otherwise that one is overwritten.
+	if (highResTimer->getElapsedTimeInMicroSec() >= getDisplayDelay()) {
+
+		QHMailbox<qVectorFloat> *spectrumBox = set->spectrumMailbox(m_receiver);
+
+		int spectrumSize = qtdsp->getSpectrum(spectrumBox->writeSlot(), set->getFFTMultiplicator(m_receiver));
+		if (spectrumSize) {
+
+			if (spectrumBox->commitWrite())
+				emit spectrumBufferChanged(m_receiver);
 
-			m_sMeterValue = qtdsp->getSMeterInstValue();
-			emit sMeterValueChanged(m_receiver, m_sMeterValue);
-			m_smeterTime.restart();
+			highResTimer->start();
 		}
+	}
+
+	// S-Meter, every block and every receiver; the display polls the
+	// reading of the receiver it shows
+	QHMailbox<TSMeterReading> *sMeterBox = set->sMeterMailbox(m_receiver);
+
+	qtdsp->getSMeterReading(sMeterBox->writeSlot());
+	sMeterBox->commitWrite();
+
+	if (m_receiver == set->getCurrentReceiver()) {
 
 		// process output data
-		emit outputBufferSignal(m_receiver, outBuf);
+		emit outputBufferSignal(m_receiver, outBuf, qtdsp->audioChannels());
 	}
+
+	m_dspTimer->stop();
+	updateDSPLoad(m_dspTimer->getElapsedTimeInMicroSec());
+}
+
+void Receiver::updateDSPLoad(double elapsed) {
+
+	m_dspTimeSum += elapsed;
+	if (elapsed > m_dspTimeMax)
+		m_dspTimeMax = elapsed;
+
+	// report about once per second of signal
+	if (++m_dspBlocks < m_samplerate / BUFFER_SIZE) return;
+
+	// real-time budget for one block in micro-seconds
+	double budget = 1000000.0 * BUFFER_SIZE / m_samplerate;
+
+	m_dspLoad = (float)(m_dspTimeSum / (m_dspBlocks * budget));
+	m_dspPeakLoad = (float)(m_dspTimeMax / budget);
+
+	if (m_dspPeakLoad > 1.0f)
+		RECEIVER_DEBUG	<< "rx " << m_receiver << " exceeds block budget: "
+						<< m_dspTimeMax << " us (budget " << budget << " us)";
+
+	set->setDSPLoad(m_receiver, m_dspLoad, m_dspPeakLoad);
+
+	m_dspTimeSum = 0.0;
+	m_dspTimeMax = 0.0;
+	m_dspBlocks = 0;
 }
 
 void Receiver::setSampleRate(QObject *sender, int value) {
@@ -555,7 +682,8 @@ void Receiver::setAGCThreshold_dB(QObject *sender, int rx, qreal value) {
 	if (qtdsp) {
 
 		//RECEIVER_DEBUG << "AGCThreshDB (minus offset) for Rx " << m_receiver << ": "  << m_agcThreshold_dBm - AGCOFFSET;
-		qtdsp->wpagc->setAGCThreshDb(m_filterLo, m_filterHi, 2*BUFFER_SIZE, m_agcThreshold_dBm - AGCOFFSET);
+		// the AGC runs at the decimated rate: scale the spectrum size alike
+		qtdsp->wpagc->setAGCThreshDb(m_filterLo, m_filterHi, 2*BUFFER_SIZE / qtdsp->decimator->decimation(), m_agcThreshold_dBm - AGCOFFSET);
 	}
 }
 
@@ -655,6 +783,12 @@ void Receiver::setAGCHangTime(QObject *sender, int rx, qreal value) {
 	}
 }
 
+void Receiver::setSMeterHoldTime(int value) {
+
+	if (qtdsp)
+		qtdsp->signalmeter->setPeakHold(value, SMETER_PEAK_FALL_DB);
+}
+
 void Receiver::setAudioVolume(QObject *sender, int rx, float value) {
 
 	Q_UNUSED(sender)
@@ -689,6 +823,16 @@ void Receiver::setFilterFrequencies(QObject *sender, int rx, double low, double
 	}
 }
 
+// the design runs on the filter's design thread, the new length is faded
+// in like a new passband
+void Receiver::setFilterLength(QObject *sender, int rx, int value) {
+
+	Q_UNUSED(sender)
+
+	if (m_receiver == rx && qtdsp)
+		qtdsp->filter->setFilterLength(value);
+}
+
 void Receiver::setCtrFrequency(long frequency) {
 
 	if (m_ctrFrequency == frequency) return;
@@ -55,7 +55,11 @@ public:
 	bool	initDSPInterface();
 	void	deleteDSPInterface();
 
-	void	enqueueData();
+	// input block the data processor fills in place; commitInputBlock()
+	// hands it to the DSP thread and returns true if a dspProcessing()
+	// call has to be posted.
+	cpx*	inputBlock();
+	bool	commitInputBlock();
 
 
 	QSDR::_ServerMode	getServerMode()	const;
@@ -84,6 +88,9 @@ public:
 	qreal	getdBmPanScaleMin()		{ return m_dBmPanScaleMin; }
 	qreal	getdBmPanScaleMax()		{ return m_dBmPanScaleMax; }
 	bool	getConnectedStatus()	{ return m_connected; }
+	float	getDSPLoad()			{ return m_dspLoad; }
+	float	getDSPPeakLoad()		{ return m_dspPeakLoad; }
+	int		getBlockAllocations()	{ return m_blockAllocations.load(); }
 
     float	in[BUFFER_SIZE * 2];
     float	out[BUFFER_SIZE * 2];
@@ -91,15 +98,11 @@ public:
 	float	spectrum[BUFFER_SIZE * 4];
 	float	postSpectrum[BUFFER_SIZE * 4];
 
-	QVector<float>	newSpectrum;
-
 	QDSPEngine	*qtdsp;
 	HResTimer	*highResTimer;
 
 	CPX			inBuf;
-    CPX			outBuf;
-
-	QHQueue<CPX>	inQueue;
+    qVectorFloat	outBuf;
 
 public slots:
 	void	setReceiverData(TReceiver data);
@@ -122,6 +125,7 @@ public slots:
 	void	setCtrFrequency(long frequency);
 	void	setVfoFrequency(long frequency);
 	void	setFilterFrequencies(QObject* sender, int rx, qreal low, qreal high);
+	void	setFilterLength(QObject* sender, int rx, int value);
 	void	setLastCtrFrequencyList(const QList<long> &frequencies);
 	void	setLastVfoFrequencyList(const QList<long> &frequencies);
 	void	setdBmPanScaleMin(qreal value);
@@ -155,6 +159,7 @@ private slots:
 	void	setAGCAttackTime(QObject* sender, int rx, qreal value);
 	void 	setAGCDecayTime(QObject* sender, int rx, qreal value);
 	void 	setAGCHangTime(QObject* sender, int rx, qreal value);
+	void	setSMeterHoldTime(int value);
 
 private:
 	Settings				*set;
@@ -179,9 +184,10 @@ private:
 	QList<DSPMode>		m_dspModeList;
 	QList<int>			m_mercuryAttenuators;
 
-	QTime				m_smeterTime;
 	QMutex				m_mutex;
 
+	HResTimer			*m_dspTimer;
+
 	volatile bool	m_stopped;
 	//bool	m_stopped;
 
@@ -199,7 +205,20 @@ private:
 	long	m_vfoFrequency;
 
 	float	m_audioVolume;
-	float	m_sMeterValue;
+	float	m_dspLoad;
+	float	m_dspPeakLoad;
+
+	// per-receiver DSP timing against the real-time block budget
+	double	m_dspTimeSum;
+	double	m_dspTimeMax;
+	int		m_dspBlocks;
+
+	// preallocated input blocks, filled and processed in place
+	QHBlockRing<CPX, RX_BLOCK_BUFFERS>	m_inRing;
+	CPX*		m_inBlock;
+	bool		m_inBlockDropped;
+	QAtomicInt	m_dspPending;
+	QAtomicInt	m_blockAllocations;
 
 	qreal	m_agcGain;
 	qreal	m_agcFixedGain_dB;
@@ -221,12 +240,14 @@ private:
 	bool	m_hangEnabled;
 
 	//void	setupConnections();
+	void	processBlock(CPX &buf);
+	void	updateDSPLoad(double elapsed);
 
 signals:
 	void	messageEvent(QString msg);
-	void	spectrumBufferChanged(int rx, const qVectorFloat& buffer);
-	void	sMeterValueChanged(int rx, float value);
-	void	outputBufferSignal(int rx, const CPX &buffer);
+	// the new data are waiting in the Settings mailboxes
+	void	spectrumBufferChanged(int rx);
+	void	outputBufferSignal(int rx, const qVectorFloat &buffer, int channels);
 	//void	audioReady(int rx);
 };
 
@@ -157,6 +157,9 @@ OGLDisplayPanel::OGLDisplayPanel(QWidget *parent)
 	
 	m_SMeterA = false;
 	//m_SMeterA = true;
+
+	// the S-meter readings are polled, see timerEvent()
+	m_sMeterPollTimer = startTimer(SMETER_POLL_INTERVAL);
 }
 
 OGLDisplayPanel::~OGLDisplayPanel() {
@@ -347,12 +350,6 @@ void OGLDisplayPanel::setupConnections() {
 		this, 
 		SLOT(setMouseWheelFreqStep(QObject*, int, qreal)));
 
-	CHECKED_CONNECT(
-		set,
-		SIGNAL(sMeterValueChanged(int, float)),
-		this,
-		SLOT(setSMeterValue(int, float)));
-
 	CHECKED_CONNECT(
 		set, 
 		SIGNAL(sMeterHoldTimeChanged(int)), 
@@ -2045,9 +2042,12 @@ void OGLDisplayPanel::renderSMeterB() {
 //}
 
 //***********************************************
-void OGLDisplayPanel::setSMeterValue(int rx, float value) {
+void OGLDisplayPanel::setSMeterValue(int rx) {
 
-	Q_UNUSED(rx)
+	const TSMeterReading *reading = set->sMeterMailbox(rx)->readSlot();
+	if (!reading) return;
+
+	float value = reading->rms;
 
 	//qDebug() << "setSMeterValue = " << value;
 	if (m_SMeterA) {
@@ -2095,100 +2095,63 @@ void OGLDisplayPanel::setSMeterValue(int rx, float value) {
 	}
 	else {
 
+		// the needle follows the rms track, the maximum marker the peak
+		// track of the meter; both come with their ballistics from the DSP
 		//float tmp = (1.00423f * value + 93.3932f);
-		float tmp;
-		if (m_mercuryAttenuator)
+		float scale, offset;
+		if (m_mercuryAttenuator) {
 			//tmp = (1.67f * value + 156.237f);
-			tmp = (1.06962f * value + 99.1537f);
-		else
+			scale = 1.06962f;
+			offset = 99.1537f;
+		}
+		else {
 			//tmp = (1.06962f * value + 99.1537f);
-			tmp = (1.67f * value + 156.237f);
-
-		//qDebug() << "S-Meter tmp = " << tmp;
-		if (m_sMeterTimer.elapsed() > 40) {
-
-			if (tmp < m_sMeterMinValueB) m_sMeterMinValueB = tmp;
-
-			if (tmp > m_sMeterMaxValueB) m_sMeterMaxValueB = tmp;
+			scale = 1.67f;
+			offset = 156.237f;
+		}
 
-			/*if (m_sMeterMaxTimer.elapsed() > m_sMeterHoldTime) {
+		float tmp = scale * value + offset;
+		float peak = scale * reading->peak + offset;
 
-				m_sMeterMaxValueB = tmp;
-				m_sMeterMaxTimer.restart();
-			}*/
+		//qDebug() << "S-Meter tmp = " << tmp;
+		if (tmp < m_sMeterMinValueB) m_sMeterMinValueB = tmp;
 
-			int elapsedTimeMax = m_sMeterMaxTimer.elapsed();
-			if (elapsedTimeMax > m_sMeterHoldTime) {
+		m_sMeterMaxValueB = peak;
 
-				if (m_sMeterPrevHoldTimeMax <= 0) 
-					m_sMeterPrevHoldTimeMax = m_sMeterHoldTime;
-				
-				// slowly reduce the peak hold level (taken from SDRMAX3 by (c) Cathy Moss)
-				m_sMeterMaxValueB -= (float)(elapsedTimeMax - m_sMeterPrevHoldTimeMax) / 15;
-				m_sMeterPrevHoldTimeMax = elapsedTimeMax;
-
-				if ((qRound(m_sMeterMaxValueB) <= qRound(tmp)) || (m_sMeterMaxValueB <= tmp)) {
-					
-					m_sMeterMaxValueB = tmp;
-					m_sMeterMaxTimer.restart();
-					m_sMeterPrevHoldTimeMax = 0;
-				}
-			}
+		int elapsedTimeMin = m_sMeterMinTimer.elapsed();
+		if (elapsedTimeMin > m_sMeterHoldTime) {
 
-			int elapsedTimeMin = m_sMeterMinTimer.elapsed();
-			if (elapsedTimeMin > m_sMeterHoldTime) {
+			if (m_sMeterPrevHoldTimeMin <= 0) 
+				m_sMeterPrevHoldTimeMin = m_sMeterHoldTime;
+			
+			// slowly increase the minimum hold level (taken from SDRMAX3 by (c) Cathy Moss)
+			m_sMeterMinValueB += (float)(elapsedTimeMin - m_sMeterPrevHoldTimeMin) / 15;
+			m_sMeterPrevHoldTimeMin = elapsedTimeMin;
 
-				if (m_sMeterPrevHoldTimeMin <= 0) 
-					m_sMeterPrevHoldTimeMin = m_sMeterHoldTime;
+			if ((qRound(m_sMeterMinValueB) >= qRound(tmp)) || (m_sMeterMinValueB >= tmp)) {
 				
-				// slowly increase the minimum hold level (taken from SDRMAX3 by (c) Cathy Moss)
-				m_sMeterMinValueB += (float)(elapsedTimeMin - m_sMeterPrevHoldTimeMin) / 15;
-				m_sMeterPrevHoldTimeMin = elapsedTimeMin;
-
-				if ((qRound(m_sMeterMinValueB) >= qRound(tmp)) || (m_sMeterMinValueB >= tmp)) {
-					
-					m_sMeterMinValueB = tmp;
-					m_sMeterMinTimer.restart();
-					m_sMeterPrevHoldTimeMin = 0;
-				}
-			}
-
-			/*if (m_sMeterMinTimer.elapsed() > m_sMeterHoldTime) {
-
 				m_sMeterMinValueB = tmp;
 				m_sMeterMinTimer.restart();
-			}*/
-
-			m_sMeterValue = tmp * 0.13f + m_sMeterValue * 0.87f;
-			//qDebug() << "scaled m_sMeterValue " << m_sMeterValue;
-
-			if (m_sMeterDisplayTime.elapsed() > 200) {
-				
-				if (m_mercuryAttenuator)
-					//m_sMeterOrgValue = value - 17.7f;
-					m_sMeterOrgValue = value - 37.7f;
-				else
-					//m_sMeterOrgValue = value - 37.7f;
-					m_sMeterOrgValue = value - 17.7f;
-
-				m_sMeterDisplayTime.restart();
+				m_sMeterPrevHoldTimeMin = 0;
 			}
-			//m_sMeterOrgValue = value - 37.7f;
-			
-			/*m_sMeterMeanValue+= value;
-			m_sMeterMeanValueCnt++;
+		}
 
-			if (m_sMeterMeanValueCnt > 100) {
+		m_sMeterValue = tmp;
 
-				qDebug() << "m_sMeterMeanValue" << m_sMeterMeanValue/100;
-				m_sMeterMeanValue = 0.0f;
-				m_sMeterMeanValueCnt = 0;
-			}*/
-			//qDebug() << "          tmp" << tmp;
+		// the number shows the long-term average
+		if (m_sMeterDisplayTime.elapsed() > 200) {
+			
+			if (m_mercuryAttenuator)
+				//m_sMeterOrgValue = reading->average - 17.7f;
+				m_sMeterOrgValue = reading->average - 37.7f;
+			else
+				//m_sMeterOrgValue = reading->average - 37.7f;
+				m_sMeterOrgValue = reading->average - 17.7f;
 
-			update();
-			m_sMeterTimer.restart();
+			m_sMeterDisplayTime.restart();
 		}
+
+		update();
 	}
 }
 
@@ -2562,7 +2525,8 @@ void OGLDisplayPanel::showEvent(QShowEvent *event) {
 
 void OGLDisplayPanel::timerEvent(QTimerEvent *event) {
 
-	Q_UNUSED(event)
+	if (event->timerId() == m_sMeterPollTimer)
+		setSMeterValue(m_currentReceiver);
 }
 
 void OGLDisplayPanel::setSMeterHoldTime(int value) {
@@ -41,6 +41,9 @@
 #   define DISPLAYPANEL_DEBUG nullDebug()
 #endif
 
+// ms between two polls of the S-meter reading
+#define SMETER_POLL_INTERVAL	40
+
 
 class OGLDisplayPanel : public QGLWidget {
 
@@ -262,6 +265,7 @@ private:
 	int		m_freqDigitsPosY;
 	int		m_sMeterPosY;
 	int		m_sMeterHoldTime;
+	int		m_sMeterPollTimer;
 	int		m_sMeterPrevHoldTimeMax;
 	int		m_sMeterPrevHoldTimeMin;
 	int		m_sMeterMeanValueCnt;
@@ -332,7 +336,7 @@ private slots:
 
 	void	setMouseWheelFreqStep(QObject *sender, int rx, qreal value);
 
-	void	setSMeterValue(int rx, float value);
+	void	setSMeterValue(int rx);
 	void	setSMeterHoldTime(int value);
 	void	updateSyncStatus();
 	void	updateADCStatus();
@@ -0,0 +1,280 @@
+/**
+* @file  cusdr_oglDisplayPrep.cpp
+* @brief receiver display preparation class for cuSDR
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+//#define LOG_DISPLAYPREP
+
+// use: DISPLAYPREP_DEBUG
+
+#include "cusdr_oglDisplayPrep.h"
+
+#include <string.h>
+
+
+static void swapFrames(TDisplayFrame &a, TDisplayFrame &b) {
+
+	a.panadapterBins.swap(b.panadapterBins);
+	a.panadapterMinBins.swap(b.panadapterMinBins);
+	a.peakHoldBins.swap(b.peakHoldBins);
+	a.waterfallRow.swap(b.waterfallRow);
+
+	qSwap(a.scaleMult, b.scaleMult);
+	qSwap(a.sampleSize, b.sampleSize);
+	qSwap(a.fftMult, b.fftMult);
+}
+
+DisplayPrep::DisplayPrep(int rx, int size)
+	: QObject()
+	, set(Settings::instance())
+	, m_receiver(rx)
+	, m_sampleSize(0)
+	, m_fftMult(1)
+	, m_peakHoldReset(-1)
+	, m_dBmPanLogGain(47) // allow user to calibrate this value
+	, m_frameFresh(false)
+	, m_reset(false)
+{
+	m_params.serverMode = set->getCurrentServerMode();
+	m_params.dataEngineState = QSDR::DataEngineDown;
+	m_params.spectrumSize = size;
+	m_params.panRectWidth = 0;
+	m_params.freqScaleZoomFactor = 1.0;
+	m_params.dBmPanMin = 0.0;
+	m_params.mercuryAttenuator = false;
+	m_params.peakHold = false;
+	m_params.peakHoldReset = 0;
+	m_params.waterfallLutLo = 0;
+	m_params.waterfallLutScale = 0.0f;
+
+	m_backFrame.scaleMult = 1.0;
+	m_backFrame.sampleSize = 0;
+	m_backFrame.fftMult = 1;
+	m_frontFrame = m_backFrame;
+
+	// a spectrum left unread by a previous panel would hold back the
+	// notifications
+	set->spectrumMailbox(m_receiver)->discard();
+
+	m_thread = new QThreadEx();
+	moveToThread(m_thread);
+	m_thread->start();
+}
+
+DisplayPrep::~DisplayPrep() {
+
+	m_thread->quit();
+	m_thread->wait();
+
+	delete m_thread;
+}
+
+void DisplayPrep::setParams(const TDisplayPrepParams &params) {
+
+	m_paramMutex.lock();
+	m_params = params;
+	m_paramMutex.unlock();
+}
+
+// swaps the published frame into \a frame, returns false if there is no new one
+bool DisplayPrep::takeFrame(TDisplayFrame &frame) {
+
+	QMutexLocker locker(&m_frameMutex);
+
+	if (!m_frameFresh)
+		return false;
+
+	swapFrames(frame, m_frontFrame);
+	m_frameFresh = false;
+
+	return true;
+}
+
+// the data engine went down: back to the 4k FFT
+void DisplayPrep::reset() {
+
+	m_paramMutex.lock();
+	m_reset = true;
+	m_paramMutex.unlock();
+}
+
+void DisplayPrep::processSpectrum(int rx) {
+
+	if (m_receiver != rx) return;
+
+	const qVectorFloat *spectrum = set->spectrumMailbox(m_receiver)->readSlot();
+	if (!spectrum) return;
+
+	const qVectorFloat &buffer = *spectrum;
+
+	m_paramMutex.lock();
+	TDisplayPrepParams p = m_params;
+	bool reset = m_reset;
+	m_reset = false;
+	m_paramMutex.unlock();
+
+	if (reset)
+		m_fftMult = 1;
+
+	if (p.dataEngineState != QSDR::DataEngineUp || p.waterfallLut.isEmpty())
+		return;
+
+	// averaged, if switched on, by the receiver's PowerSpectrum already
+	computeDisplayBins(p, buffer.constData());
+}
+
+// Switches the FFT size of the receiver when the zoomed sample size leaves
+// the 2048 .. 4096 bin window; returns true if it did, the current spectrum
+// is dropped then. The Settings are not touched from this thread: the new
+// size goes to the panel with sampleSizeRequested().
+bool DisplayPrep::adjustSampleSize() {
+
+	if (set->getFFTAutoStatus(m_receiver)) return false;
+
+	if (m_sampleSize < 2048 && m_fftMult < 16) {
+
+		m_fftMult *= 2;
+		m_dBmPanLogGain += 6;
+	}
+	else if (m_sampleSize > 4096 && m_fftMult > 1) {
+
+		m_fftMult /= 2;
+		m_dBmPanLogGain -= 6;
+	}
+	else
+		return false;
+
+	DISPLAYPREP_DEBUG << "set sample size to " << 4096 * m_fftMult;
+	emit sampleSizeRequested(m_receiver, 4096 * m_fftMult);
+
+	return true;
+}
+
+void DisplayPrep::computeDisplayBins(const TDisplayPrepParams &p, const float *buffer) {
+
+	if (p.panRectWidth <= 0) return;
+
+	int deltaSampleSize = 0;
+
+	if (p.serverMode == QSDR::ChirpWSPRFile) {
+		
+		m_sampleSize = (int)floor(2 * BUFFER_SIZE * p.freqScaleZoomFactor);
+		deltaSampleSize = 2 * BUFFER_SIZE - m_sampleSize;
+	}
+	else {
+
+		m_sampleSize = (int)floor(m_fftMult * p.spectrumSize * p.freqScaleZoomFactor);
+		deltaSampleSize = p.spectrumSize - m_sampleSize;
+	}
+
+	if (adjustSampleSize()) return;
+
+	qreal panScale = (qreal)(1.0 * m_sampleSize / p.panRectWidth);
+	qreal scaleMult;
+
+	if (panScale < 0.125) {
+		scaleMult = 0.0625;
+	}
+	else if (panScale < 0.25) {
+		scaleMult = 0.125;
+	}
+	else if (panScale < 0.5) {
+		scaleMult = 0.25;
+	}
+	else if (panScale < 1.0) {
+		scaleMult = 0.5;
+	}
+	else {
+		scaleMult = 1.0;
+	}
+
+	int length = (int)(scaleMult * p.panRectWidth);
+
+	// the displayed bins start half of the difference between full spectrum
+	// size and reduced spectrum size due to zooming into the spectrum; the
+	// bin to pixel map is only rebuilt on zoom or resize
+	m_panEnvelope.setup(deltaSampleSize/2, m_sampleSize, length);
+
+	m_envelope.resize(3 * length);
+	float *specMin = m_envelope.data();
+	float *specMax = specMin + length;
+	float *specMean = specMin + 2 * length;
+
+	m_panEnvelope.process(buffer, specMin, specMax, specMean);
+
+	// the waterfall takes the maxima as well
+	const float *waterMax = specMax;
+
+	qreal gain = m_dBmPanLogGain;
+	if (p.mercuryAttenuator) gain += 20.0f;
+
+	if (m_peakHoldReset != p.peakHoldReset || m_peakHoldBins.size() != length) {
+
+		m_peakHoldBins.resize(length);
+		m_peakHoldBins.fill(-300.0);
+
+		m_peakHoldReset = p.peakHoldReset;
+	}
+
+	TDisplayFrame &frame = m_backFrame;
+
+	frame.panadapterBins.resize(length);
+	frame.panadapterMinBins.resize(length);
+	frame.waterfallRow.resize(4 * p.panRectWidth);
+
+	qreal *bins = frame.panadapterBins.data();
+	qreal *minBins = frame.panadapterMinBins.data();
+	qreal *peakHold = m_peakHoldBins.data();
+	TGL_ubyteRGBA *row = frame.waterfallRow.data();
+
+	int pixelsPerBin = (int)(1/scaleMult);
+
+	for (int i = 0; i < length; i++) {
+		
+		bins[i] = specMax[i] - p.dBmPanMin - gain;
+		minBins[i] = specMin[i] - p.dBmPanMin - gain;
+
+		if (p.peakHold && bins[i] > peakHold[i])
+			peakHold[i] = bins[i];
+
+		const TGL_ubyteRGBA &color = waterfallLutColor(p, waterMax[i] - gain);
+
+		for (int j = 0; j < pixelsPerBin; j++)
+			row[(int)(i/scaleMult) + j] = color;
+	}
+
+	frame.peakHoldBins.resize(length);
+	memcpy(frame.peakHoldBins.data(), peakHold, length * sizeof(qreal));
+
+	frame.scaleMult = scaleMult;
+	frame.sampleSize = m_sampleSize;
+	frame.fftMult = m_fftMult;
+
+	m_frameMutex.lock();
+	swapFrames(m_backFrame, m_frontFrame);
+	m_frameFresh = true;
+	m_frameMutex.unlock();
+
+	emit frameReady();
+}
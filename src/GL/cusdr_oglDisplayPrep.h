@@ -0,0 +1,155 @@
+/**
+* @file  cusdr_oglDisplayPrep.h
+* @brief receiver display preparation header file for cuSDR
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef _CUSDR_OGL_DISPLAYPREP_H
+#define _CUSDR_OGL_DISPLAYPREP_H
+
+#include "cusdr_oglUtils.h"
+#include "cusdr_settings.h"
+#include "QtDSP/qtdsp_envelope.h"
+
+#include <QObject>
+#include <QMutex>
+
+
+#ifdef LOG_DISPLAYPREP
+#   define DISPLAYPREP_DEBUG qDebug().nospace() << "DisplayPrep::\t"
+#else
+#   define DISPLAYPREP_DEBUG nullDebug()
+#endif
+
+
+// interior entries of the waterfall palette between the two thresholds
+#define WATERFALL_LUT_SIZE	4096
+
+
+// view parameters of the receiver panel, copied by the worker once per spectrum
+typedef struct _displayPrepParams {
+
+	QSDR::_ServerMode		serverMode;
+	QSDR::_DataEngineState	dataEngineState;
+
+	int		spectrumSize;
+	int		panRectWidth;
+	qreal	freqScaleZoomFactor;
+	qreal	dBmPanMin;
+	bool	mercuryAttenuator;
+	bool	peakHold;
+	int		peakHoldReset;		// incremented by the panel to clear the peak hold bins
+
+	// waterfall palette, see QGLReceiverPanel::updateWaterfallLut()
+	QVector<TGL_ubyteRGBA>	waterfallLut;
+	int		waterfallLutLo;
+	float	waterfallLutScale;
+
+} TDisplayPrepParams;
+
+// one panadapter and waterfall frame, ready to be uploaded
+typedef struct _displayFrame {
+
+	QVector<qreal>			panadapterBins;
+	QVector<qreal>			panadapterMinBins;
+	QVector<qreal>			peakHoldBins;
+	QVector<TGL_ubyteRGBA>	waterfallRow;
+
+	qreal	scaleMult;
+	int		sampleSize;
+	int		fftMult;
+
+} TDisplayFrame;
+
+
+/*!
+	\class DisplayPrep
+	\brief Prepares the panadapter and waterfall data of one receiver panel
+	in a worker thread of its own: spectrum averaging, reduction of the
+	spectrum bins to display pixels, peak hold and the waterfall row.
+
+	processSpectrum() takes the newest spectrum of the receiver from its
+	Settings mailbox; spectra the thread had no time for are skipped there,
+	not queued up. Every result is written
+	into a back frame and then swapped with the published one; the panel
+	swaps the published frame out with takeFrame() when it paints, so no
+	frame is copied and, once the sizes settle, none is allocated.
+*/
+class DisplayPrep : public QObject {
+
+	Q_OBJECT
+
+public:
+	DisplayPrep(int rx = 0, int size = 0);
+	~DisplayPrep();
+
+	// called from the panel's (GUI) thread
+	void	setParams(const TDisplayPrepParams &params);
+	bool	takeFrame(TDisplayFrame &frame);
+	void	reset();
+
+public slots:
+	void	processSpectrum(int rx);
+
+signals:
+	void	frameReady();
+
+	// a new FFT size for \a rx; the panel sets it in the GUI thread
+	void	sampleSizeRequested(int rx, int size);
+
+private:
+	Settings*			set;
+	QThreadEx*			m_thread;
+
+	QMutex				m_paramMutex;
+	QMutex				m_frameMutex;
+
+	TDisplayPrepParams	m_params;
+	TDisplayFrame		m_backFrame;
+	TDisplayFrame		m_frontFrame;
+
+	QEnvelope			m_panEnvelope;
+	QVector<float>		m_envelope;
+	QVector<qreal>		m_peakHoldBins;
+
+	int		m_receiver;
+	int		m_sampleSize;
+	int		m_fftMult;
+	int		m_peakHoldReset;
+	int		m_dBmPanLogGain;
+	bool	m_frameFresh;
+	bool	m_reset;
+
+	bool	adjustSampleSize();
+	void	computeDisplayBins(const TDisplayPrepParams &p, const float *buffer);
+
+	const TGL_ubyteRGBA &waterfallLutColor(const TDisplayPrepParams &p, float value) const {
+
+		float x = (value - p.waterfallLutLo) * p.waterfallLutScale;
+		int idx = x <= 0.0f ? 0 : (x >= WATERFALL_LUT_SIZE ? WATERFALL_LUT_SIZE + 1 : 1 + (int) x);
+
+		return p.waterfallLut.at(idx);
+	}
+};
+
+#endif // _CUSDR_OGL_DISPLAYPREP_H
@@ -2340,10 +2340,6 @@ void QGLDistancePanel::computeDisplayBins(const float *panBuffer) {
 
 	int newSampleSize = 0;
 	int deltaSampleSize = 0;
-	int idx = 0;
-	int lIdx = 0;
-	int rIdx = 0;
-	qreal localMax;
 
 	if (m_serverMode == QSDR::ChirpWSPRFile) {
 		
@@ -2389,28 +2385,20 @@ void QGLDistancePanel::computeDisplayBins(const float *panBuffer) {
 		GRAPHICS_DEBUG << "bins:" << bins;
 	}*/
 
-	m_panadapterBins.clear();
-	
-	for (int i = 0; i < m_panSpectrumBinsLength; i++) {
-			
-		idx = 0;
-		lIdx = (int)floor((qreal)(i * m_panScale / m_scaleMult));
-		rIdx = (int)floor((qreal)(i * m_panScale / m_scaleMult) + m_panScale / m_scaleMult);
-					
-		// max value; later we try mean value also!
-		localMax = -10000.0F;
-		for (int j = lIdx; j < rIdx; j++) {
+	// the bin to pixel map is only rebuilt on zoom or resize
+	int length = m_panSpectrumBinsLength;
+	m_panEnvelope.setup(deltaSampleSize/2, newSampleSize, length);
 
-			if (panBuffer[j] > localMax) {
+	m_envelope.resize(3 * length);
+	float *envMin = m_envelope.data();
+	float *envMax = envMin + length;
+
+	m_panEnvelope.process(panBuffer, envMin, envMax, envMin + 2 * length);
+
+	m_panadapterBins.resize(length);
+	for (int i = 0; i < length; i++)
+		m_panadapterBins[i] = envMax[i] - m_dBmPanMin - m_dBmPanLogGain;
 
-				localMax = panBuffer[j];
-				idx = j;
-			}
-		}
-		idx += deltaSampleSize/2;
-				
-		m_panadapterBins << panBuffer[idx] - m_dBmPanMin - m_dBmPanLogGain;
-	}
 	update();	
 }
 
@@ -32,6 +32,7 @@
 #include "cusdr_settings.h"
 #include "cusdr_fonts.h"
 #include "cusdr_oglText.h"
+#include "QtDSP/qtdsp_envelope.h"
 
 //#include <QtOpenGL/QGLWidget>
 //#include <QImage>
@@ -98,6 +99,10 @@ private:
 	QList<TReceiver>	m_rxDataList;
 	
 	QVector<qreal>					m_panadapterBins;
+
+	// spectrum bins to display pixels; min, max and mean per pixel
+	QEnvelope						m_panEnvelope;
+	QVector<float>					m_envelope;
 	QQueue<QVector<float> >			specAv_queue;
 
 	QGLFramebufferObject*			m_frequencyScaleFBO;
@@ -26,6 +26,11 @@
 
 #define LOG_GRAPHICS
 
+// logs frames per second and the mean UI-thread time spent in paintGL and
+// drawPanadapter every PANEL_FRAME_STATS_INTERVAL ms.
+//#define PANEL_FRAME_TIMING
+#define PANEL_FRAME_STATS_INTERVAL	5000
+
 // use: GRAPHICS_DEBUG
 
 #include "cusdr_oglReceiverPanel.h"
@@ -56,7 +61,6 @@ QGLReceiverPanel::QGLReceiverPanel(QWidget *parent, int rx)
 	, m_dataEngineState(QSDR::DataEngineDown)
 	, m_mousePos(QPoint(-1, -1))
 	, m_mouseDownPos(QPoint(-1, -1))
-	, m_panSpectrumBinsLength(0)
 	, m_filterLeft(0)
 	, m_filterRight(0)
 	, m_filterTop(0)
@@ -64,8 +68,6 @@ QGLReceiverPanel::QGLReceiverPanel(QWidget *parent, int rx)
 	, m_receiver(rx)
 	//, m_frequencyRxOnRx(0)
 	, m_spectrumSize(set->getSpectrumSize())
-	, m_sampleSize(0)
-	, m_oldSampleSize(0)
 	, m_specAveragingCnt(set->getSpectrumAveragingCnt(m_receiver))
 	, m_currentReceiver(set->getCurrentReceiver())
 	, m_waterfallAlpha(255)
@@ -76,7 +78,8 @@ QGLReceiverPanel::QGLReceiverPanel(QWidget *parent, int rx)
 	, m_sampleRate(set->getSampleRate())
 	, m_downRate(set->getChirpDownSampleRate())
 	, m_adcStatus(0)
-	, m_fftMult(1)
+	, m_peakHoldReset(0)
+	, m_panVBOState(-1)
 	, m_smallSize(true)
 	, m_spectrumVertexColorUpdate(false)
 	, m_spectrumColorsChanged(true)
@@ -176,7 +179,7 @@ QGLReceiverPanel::QGLReceiverPanel(QWidget *parent, int rx)
 	m_agcHangEnabled = m_rxDataList.at(m_receiver).hangEnabled;
 	m_showAGCLines = m_rxDataList.at(m_receiver).agcLines;
 
-	averager = new DualModeAverager(m_receiver, m_spectrumSize);
+	m_displayPrep = new DisplayPrep(m_receiver, m_spectrumSize);
 	radioPopup = new RadioPopupWidget(this, m_receiver);
 
 	fonts = new CFonts(this);
@@ -203,13 +206,15 @@ QGLReceiverPanel::QGLReceiverPanel(QWidget *parent, int rx)
 	m_resizeTime.start();
 	peakHoldTimer.start();
 	//freqChangeTimer.start();
+
+	m_frameStatsTimer.start();
+	m_panadapterNsecs = 0;
+	m_paintNsecs = 0;
+	m_frameStatsCount = 0;
 	
 	m_fps = set->getFramesPerSecond(m_receiver);
 	m_secWaterfallMin = -(1.0/m_fps) * m_secScaleWaterfallRect.height();
 
-	
-	m_dBmPanLogGain = 47;//49;//69 // allow user to calibrate this value
-
 	m_cameraDistance = 0;
 	m_cameraAngle = QPoint(0, 0);
 
@@ -247,15 +252,19 @@ QGLReceiverPanel::QGLReceiverPanel(QWidget *parent, int rx)
 	m_waterfallMidColor = set->getPanadapterColors().waterfallColor.toRgb();
 	m_waterfallColorRange = (int)(m_dBmPanMax - m_dBmPanMin);
 
+	m_waterfallLutLo = 0;
+	m_waterfallLutHi = 0;
+	m_waterfallLutMode = -1;
+	m_waterfallLutScale = 0.0f;
+	m_waterfallLutUpdate = true;
+
 	m_frequencyScaleFBO = 0;
 	m_dBmScaleFBO = 0;
 	m_panadapterGridFBO = 0;
-	m_textureFBO = 0;
-	m_waterfallLineFBO = 0;
-	m_waterfallFBO = 0;
 	m_secScaleWaterfallFBO = 0;
 
-	m_waterfallLineCnt = 0;
+	m_waterfallTexture = 0;
+	m_waterfallRow = 0;
 
 	m_haircrossOffsetRight = 30;
 	m_haircrossOffsetLeft = 116;
@@ -276,28 +285,19 @@ QGLReceiverPanel::~QGLReceiverPanel() {
 	makeCurrent();
 	glFinish();
 
+	m_panVertexVBO.destroy();
+	m_panColorVBO.destroy();
+
 	if (m_frequencyScaleFBO) {
 
 		delete m_frequencyScaleFBO;
 		m_frequencyScaleFBO = 0;
 	}
 
-	if (m_waterfallLineFBO) {
+	if (m_waterfallTexture) {
 
-		delete m_waterfallLineFBO;
-		m_waterfallLineFBO = 0;
-	}
-		
-	if (m_waterfallFBO) {
-
-		delete m_waterfallFBO;
-		m_waterfallFBO = 0;
-	}
-
-	if (m_textureFBO) {
-
-		delete m_textureFBO;
-		m_textureFBO = 0;
+		glDeleteTextures(1, &m_waterfallTexture);
+		m_waterfallTexture = 0;
 	}
 
 	if (m_dBmScaleFBO) {
@@ -318,8 +318,8 @@ QGLReceiverPanel::~QGLReceiverPanel() {
 		m_secScaleWaterfallFBO = 0;
 	}
 
-	if (averager)
-		delete averager;
+	// stops the worker thread before the frames go away
+	delete m_displayPrep;
 
 	while (!specAv_queue.isEmpty())
 		specAv_queue.dequeue();
@@ -449,11 +449,26 @@ void QGLReceiverPanel::setupConnections() {
 		this, 
 		SLOT(setSpectrumAveragingCnt(int)));*/
 
+	// the spectra are averaged and reduced in the display prep thread, the
+	// panel only repaints with the frames it publishes
 	CHECKED_CONNECT(
 		set,
-		SIGNAL(spectrumBufferChanged(int, const qVectorFloat&)),
+		SIGNAL(spectrumBufferChanged(int)),
+		m_displayPrep,
+		SLOT(processSpectrum(int)));
+
+	CHECKED_CONNECT(
+		m_displayPrep,
+		SIGNAL(frameReady()),
+		this,
+		SLOT(update()));
+
+	CHECKED_CONNECT_OPT(
+		m_displayPrep,
+		SIGNAL(sampleSizeRequested(int, int)),
 		this,
-		SLOT(setSpectrumBuffer(int, const qVectorFloat&)));
+		SLOT(setSampleSize(int, int)),
+		Qt::QueuedConnection);
 
 	CHECKED_CONNECT(
 		set, 
@@ -607,6 +622,11 @@ void QGLReceiverPanel::initializeGL() {
 
 void QGLReceiverPanel::paintGL() {
 
+#ifdef PANEL_FRAME_TIMING
+	QElapsedTimer paintTimer;
+	paintTimer.start();
+#endif
+
 	switch (m_serverMode) {
 
 		case QSDR::ChirpWSPR:
@@ -626,6 +646,28 @@ void QGLReceiverPanel::paintGL() {
 			
 			break;
 	}
+
+#ifdef PANEL_FRAME_TIMING
+	// CPU side only: the GL driver may defer the actual drawing to the
+	// buffer swap, which is not part of paintGL.
+	m_paintNsecs += paintTimer.nsecsElapsed();
+	m_frameStatsCount++;
+
+	qint64 interval = m_frameStatsTimer.elapsed();
+	if (interval >= PANEL_FRAME_STATS_INTERVAL) {
+
+		GRAPHICS_DEBUG << "rx " << m_receiver
+			<< ": " << qRound(m_frameStatsCount * 1000.0 / interval) << " fps"
+			<< ", paintGL " << m_paintNsecs / m_frameStatsCount / 1000 << " us"
+			<< ", drawPanadapter " << m_panadapterNsecs / m_frameStatsCount / 1000 << " us"
+			<< " per frame";
+
+		m_frameStatsTimer.restart();
+		m_panadapterNsecs = 0;
+		m_paintNsecs = 0;
+		m_frameStatsCount = 0;
+	}
+#endif
 }
  
 void QGLReceiverPanel::paintReceiverDisplay() {
@@ -633,6 +675,19 @@ void QGLReceiverPanel::paintReceiverDisplay() {
 	QRect mouse_rect(0, 0, 100, 100);
 	mouse_rect.moveCenter(m_mousePos);
 
+	updateDisplayPrepParams();
+
+	// one waterfall line per new frame
+	if (m_displayPrep->takeFrame(m_displayFrame)) {
+
+		if (m_scaleMult != m_displayFrame.scaleMult) {
+
+			m_scaleMult = m_displayFrame.scaleMult;
+			m_waterfallUpdate = true;
+		}
+		m_waterfallDisplayUpdate = true;
+	}
+
 	if (m_filterChanged) {
 
 		m_filterLo = m_filterLowerFrequency / m_sampleRate;
@@ -654,7 +709,14 @@ void QGLReceiverPanel::paintReceiverDisplay() {
 	}
 	//m_displayTime.restart();
 
+#ifdef PANEL_FRAME_TIMING
+	QElapsedTimer panTimer;
+	panTimer.start();
+	drawPanadapter();
+	m_panadapterNsecs += panTimer.nsecsElapsed();
+#else
 	drawPanadapter();
+#endif
 	drawPanHorizontalScale();
 	drawPanVerticalScale();
 	drawPanadapterGrid();
@@ -697,7 +759,11 @@ void QGLReceiverPanel::paint3DPanadapterMode() {
   
 void QGLReceiverPanel::drawPanadapter() {
 
-	GLint vertexArrayLength = (GLint)m_panadapterBins.size();
+	const QVector<qreal> &bins = m_displayFrame.panadapterBins;
+	const QVector<qreal> &minBins = m_displayFrame.panadapterMinBins;
+	const QVector<qreal> &peakHoldBins = m_displayFrame.peakHoldBins;
+
+	GLint vertexArrayLength = (GLint)bins.size();
 
 	GLint height = m_panRect.height();
 	GLint x1 = m_panRect.left();
@@ -732,42 +798,31 @@ void QGLReceiverPanel::drawPanadapter() {
 	glEnable(GL_BLEND);
 	glLineWidth(1);
 
+	// colours, background and buffer sizes only change on demand
+	updatePanadapterBuffers(vertexArrayLength);
+
+	const int fillOffset	= vertexArrayLength;
+	const int phLineOffset	= 3 * vertexArrayLength;
+	const int phFillOffset	= 4 * vertexArrayLength;
+	const int bgOffset		= 6 * vertexArrayLength;
+	const int adcOffset		= bgOffset + 4;
+
 	// draw background
 	if (m_dataEngineState == QSDR::DataEngineUp) {
 
-		if (m_receiver == m_currentReceiver) {
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_COLOR_ARRAY);
 
-//			glBegin(GL_TRIANGLE_STRIP);
-//				glColor3f(0.2f * m_bkgRed, 0.2f * m_bkgGreen, 0.2f * m_bkgBlue); glVertex3f(x1, y1, -4.0); // top left corner
-//				glColor3f(0.2f * m_bkgRed, 0.2f * m_bkgGreen, 0.2f * m_bkgBlue); glVertex3f(x2, y1, -4.0); // top right corner
-//				glColor3f(0.8f * m_bkgRed, 0.8f * m_bkgGreen, 0.8f * m_bkgBlue); glVertex3f(x1, y2, -4.0); // bottom left corner
-//				glColor3f(       m_bkgRed,        m_bkgGreen,        m_bkgBlue); glVertex3f(x2, y2, -4.0); // bottom right corner
-//			glEnd();
-			glBegin(GL_TRIANGLE_STRIP);
-				glColor3f(0.8f * m_bkgRed, 0.8f * m_bkgGreen, 0.8f * m_bkgBlue); glVertex3f(x1, y1, -4.0); // top left corner
-				glColor3f(0.6f * m_bkgRed, 0.6f * m_bkgGreen, 0.6f * m_bkgBlue); glVertex3f(x2, y1, -4.0); // top right corner
-				glColor3f(0.4f * m_bkgRed, 0.4f * m_bkgGreen, 0.4f * m_bkgBlue); glVertex3f(x1, y2, -4.0); // bottom left corner
-				glColor3f(0.2f * m_bkgRed, 0.2f * m_bkgGreen, 0.2f * m_bkgBlue); glVertex3f(x2, y2, -4.0); // bottom right corner
-			glEnd();
-		}
-		else {
+		drawPanArrays(GL_TRIANGLE_STRIP, bgOffset, bgOffset, 4);
 
-			glBegin(GL_TRIANGLE_STRIP);
-				glColor3f(0.4f * m_bkgRed, 0.4f * m_bkgGreen, 0.4f * m_bkgBlue); glVertex3f(x1, y1, -4.0); // top left corner
-				glColor3f(0.4f * m_bkgRed, 0.4f * m_bkgGreen, 0.4f * m_bkgBlue); glVertex3f(x2, y1, -4.0); // top right corner
-				glColor3f(0.4f * m_bkgRed, 0.4f * m_bkgGreen, 0.4f * m_bkgBlue); glVertex3f(x1, y2, -4.0); // bottom left corner
-				glColor3f(0.4f * m_bkgRed, 0.4f * m_bkgGreen, 0.4f * m_bkgBlue); glVertex3f(x2, y2, -4.0); // bottom right corner
-			glEnd();
-		}
+		if (m_adcStatus == 2)
+			drawPanArrays(GL_TRIANGLE_STRIP, adcOffset, adcOffset, 4);
 
-		if (m_adcStatus == 2) {
+		glDisableClientState(GL_VERTEX_ARRAY);
+		glDisableClientState(GL_COLOR_ARRAY);
+		QGLBuffer::release(QGLBuffer::VertexBuffer);
 
-			glBegin(GL_TRIANGLE_STRIP);
-				glColor3f(m_bkgRed, 0.2f * m_bkgGreen, 0.2f * m_bkgBlue); glVertex3f(x1, y1, -4.0); // top left corner
-				glColor3f(m_bkgRed, 0.2f * m_bkgGreen, 0.2f * m_bkgBlue); glVertex3f(x2, y1, -4.0); // top right corner
-				glColor3f(m_bkgRed, 0.2f * m_bkgGreen, 0.2f * m_bkgBlue); glVertex3f(x1, y2, -4.0); // bottom left corner
-				glColor3f(m_bkgRed, 0.2f * m_bkgGreen, 0.2f * m_bkgBlue); glVertex3f(x2, y2, -4.0); // bottom right corner
-			glEnd();
+		if (m_adcStatus == 2) {
 
 			QString str = "ADC  Overload";
 			int rectWidth = m_fonts.hugeFontMetrics->boundingRect(str).width();
@@ -785,100 +840,51 @@ void QGLReceiverPanel::drawPanadapter() {
 	glScissor(x1, size().height() - y2, x2, height);
 	glEnable(GL_SCISSOR_TEST);
 
-	spectrumBufferMutex.lock();
-
-	TGL3float *vertexArray = new TGL3float[vertexArrayLength];
-	TGL3float *vertexColorArray = new TGL3float[vertexArrayLength];
-	
-	TGL3float *vertexArrayBg = new TGL3float[2*vertexArrayLength];
-	TGL3float *vertexColorArrayBg = new TGL3float[2*vertexArrayLength];
+	// only the vertices change from frame to frame: they are written into
+	// the persistent staging array and uploaded with glBufferSubData
+	TGL3float *vertexArray = m_panVertices.data();
+	TGL3float *vertexArrayBg = vertexArray + fillOffset;
+	TGL3float *vertexArrayPH = vertexArray + phLineOffset;
+	TGL3float *vertexArrayBgPH = vertexArray + phFillOffset;
 
-	TGL3float *vertexArrayBgPH = new TGL3float[2*vertexArrayLength];
-	TGL3float *vertexColorArrayBgPH = new TGL3float[2*vertexArrayLength];
+	m_panVertexVBO.bind();
 
-	TGL3float *vertexArrayPH = new TGL3float[vertexArrayLength];
-	TGL3float *vertexColorArrayPH = new TGL3float[vertexArrayLength];
-	
 	switch (m_panMode) {
 
 		case (PanGraphicsMode) FilledLine:
 
 			for (int i = 0; i < vertexArrayLength; i++) {
-			
-				mutex.lock();
-				vertexColorArrayBg[2*i].x = 0.7 * m_redF;
-				vertexColorArrayBg[2*i].y = 0.7 * m_greenF;
-				vertexColorArrayBg[2*i].z = 0.7 * m_blueF;
-								
-				vertexColorArrayBg[2*i+1].x = 0.3 * m_redF;
-				vertexColorArrayBg[2*i+1].y = 0.3 * m_greenF;
-				vertexColorArrayBg[2*i+1].z = 0.3 * m_blueF;
-				
-				if (!m_peakHold) {
-				
-					vertexColorArray[i].x = m_red;
-					vertexColorArray[i].y = m_green;
-					vertexColorArray[i].z = m_blue;
-
-					/*vertexColorArray[i].x = m_red   * (yScaleColor * (m_panadapterBins.at(i) - m_dBmPanMin));
-					vertexColorArray[i].y = m_green * (yScaleColor * (m_panadapterBins.at(i) - m_dBmPanMin));
-					vertexColorArray[i].z = m_blue  * (yScaleColor * (m_panadapterBins.at(i) - m_dBmPanMin));*/
-				}
-				else {
-					
-					vertexColorArray[i].x = 0.7f;
-					vertexColorArray[i].y = 0.7f;
-					vertexColorArray[i].z = 0.7f;
-
-					vertexColorArrayPH[i].x = m_red;
-					vertexColorArrayPH[i].y = m_green;
-					vertexColorArrayPH[i].z = m_blue;
-
-					/*vertexColorArray[i].x = m_red   * (yScaleColor * (m_panadapterBins.at(i) - m_dBmPanMin));
-					vertexColorArray[i].y = m_green * (yScaleColor * (m_panadapterBins.at(i) - m_dBmPanMin));
-					vertexColorArray[i].z = m_blue  * (yScaleColor * (m_panadapterBins.at(i) - m_dBmPanMin));*/
-				}
-				mutex.unlock();
 
 				vertexArrayBg[2*i].x = (GLfloat)(i/m_scaleMult);
-				vertexArrayBg[2*i].y = (GLfloat)(yTop - yScale * m_panadapterBins.at(i));
+				vertexArrayBg[2*i].y = (GLfloat)(yTop - yScale * bins.at(i));
 				vertexArrayBg[2*i].z = -1.5;
 
 				vertexArrayBg[2*i+1].x = (GLfloat)(i/m_scaleMult);
 				vertexArrayBg[2*i+1].y = (GLfloat)yTop;
 				vertexArrayBg[2*i+1].z = -1.5;
-	
-				/*vertexArray[i].x = (GLfloat)(i/m_scaleMult);
-				vertexArray[i].y = (GLfloat)(yTop - yScale * m_panadapterBins.at(i));
-				vertexArray[i].z = -1.0;*/
 
 				if (m_peakHold) {
 					
 					vertexArrayPH[i].x = (GLfloat)(i/m_scaleMult);
-					vertexArrayPH[i].y = (GLfloat)(yTop - yScale * m_panPeakHoldBins.at(i));
+					vertexArrayPH[i].y = (GLfloat)(yTop - yScale * peakHoldBins.at(i));
 					vertexArrayPH[i].z = -0.5;
 				}
 			}
+
+			writePanVertices(fillOffset, 2*vertexArrayLength);
+			if (m_peakHold)
+				writePanVertices(phLineOffset, vertexArrayLength);
 			
 			glEnableClientState(GL_VERTEX_ARRAY);
 			glEnableClientState(GL_COLOR_ARRAY);
 				
-			glVertexPointer(3, GL_FLOAT, 0, vertexArrayBg);
-			glColorPointer(3, GL_FLOAT, 0, vertexColorArrayBg);
-			glDrawArrays(GL_TRIANGLE_STRIP, 0, 2*vertexArrayLength);
-
-			if (m_peakHold) {
-				
-				glVertexPointer(3, GL_FLOAT, 0, vertexArrayPH);
-				glColorPointer(3, GL_FLOAT, 0, vertexColorArrayPH);
-				glDrawArrays(GL_LINE_STRIP, 0, vertexArrayLength);
-			}
-			else {
+			drawPanArrays(GL_TRIANGLE_STRIP, fillOffset, fillOffset, 2*vertexArrayLength);
 
-				glVertexPointer(3, GL_FLOAT, 6*sizeof(float), vertexArrayBg);
-				glColorPointer(3, GL_FLOAT, 0, vertexColorArray);
-				glDrawArrays(GL_LINE_STRIP, 0, vertexArrayLength);
-			}
+			// the line runs along the upper vertices of the filled strip
+			if (m_peakHold)
+				drawPanArrays(GL_LINE_STRIP, phLineOffset, phLineOffset, vertexArrayLength);
+			else
+				drawPanArrays(GL_LINE_STRIP, fillOffset, 0, vertexArrayLength, 6*sizeof(float));
 
 			glDisableClientState(GL_VERTEX_ARRAY);
 			glDisableClientState(GL_COLOR_ARRAY); 
@@ -888,59 +894,40 @@ void QGLReceiverPanel::drawPanadapter() {
 		case (PanGraphicsMode) Line:
 
 			for (int i = 0; i < vertexArrayLength; i++) {
-	
-				mutex.lock();
-				if (!m_peakHold) {
-				
-					vertexColorArray[i].x = m_red;
-					vertexColorArray[i].y = m_green;
-					vertexColorArray[i].z = m_blue;
-
-					/*vertexColorArray[i].x = m_red   * (yScaleColor * (m_panadapterBins.at(i) - m_dBmPanMin));
-					vertexColorArray[i].y = m_green * (yScaleColor * (m_panadapterBins.at(i) - m_dBmPanMin));
-					vertexColorArray[i].z = m_blue  * (yScaleColor * (m_panadapterBins.at(i) - m_dBmPanMin));*/
-
-					/*vertexColorArray[i].x = m_red   * (yScaleColor * m_panadapterBins.at(i));
-					vertexColorArray[i].y = m_green * (yScaleColor * m_panadapterBins.at(i));
-					vertexColorArray[i].z = m_blue  * (yScaleColor * m_panadapterBins.at(i));*/
-				}
-				else {
-					
-					vertexColorArray[i].x = 0.6f;
-					vertexColorArray[i].y = 0.6f;
-					vertexColorArray[i].z = 0.6f;
 
-					vertexColorArrayPH[i].x = m_red;
-					vertexColorArrayPH[i].y = m_green;
-					vertexColorArrayPH[i].z = m_blue;
-				}
-				mutex.unlock();
-				
 				vertexArray[i].x = (GLfloat)(i/m_scaleMult);
-				vertexArray[i].y = (GLfloat)(yTop - yScale * m_panadapterBins.at(i));
+				vertexArray[i].y = (GLfloat)(yTop - yScale * bins.at(i));
 				vertexArray[i].z = -1.0;
+
+				// min/max band of the bins behind the pixel
+				vertexArrayBg[2*i].x = (GLfloat)(i/m_scaleMult);
+				vertexArrayBg[2*i].y = vertexArray[i].y;
+				vertexArrayBg[2*i].z = -1.5;
+
+				vertexArrayBg[2*i+1].x = (GLfloat)(i/m_scaleMult);
+				vertexArrayBg[2*i+1].y = (GLfloat)(yTop - yScale * minBins.at(i));
+				vertexArrayBg[2*i+1].z = -1.5;
 				
 				if (m_peakHold) {
 					
 					vertexArrayPH[i].x = (GLfloat)(i/m_scaleMult);
-					vertexArrayPH[i].y = (GLfloat)(yTop - yScale * m_panPeakHoldBins.at(i));
+					vertexArrayPH[i].y = (GLfloat)(yTop - yScale * peakHoldBins.at(i));
 					vertexArrayPH[i].z = -0.5;
 				}
 			}
+
+			writePanVertices(0, 3*vertexArrayLength);
+			if (m_peakHold)
+				writePanVertices(phLineOffset, vertexArrayLength);
 		
 			glEnableClientState(GL_VERTEX_ARRAY);
 			glEnableClientState(GL_COLOR_ARRAY);
 			
-			glVertexPointer(3, GL_FLOAT, 0, vertexArray);
-			glColorPointer(3, GL_FLOAT, 0, vertexColorArray);
-			glDrawArrays(GL_LINE_STRIP, 0, vertexArrayLength);
+			drawPanArrays(GL_LINES, fillOffset, fillOffset, 2*vertexArrayLength);
+			drawPanArrays(GL_LINE_STRIP, 0, 0, vertexArrayLength);
 			
-			if (m_peakHold) {
-				
-				glVertexPointer(3, GL_FLOAT, 0, vertexArrayPH);
-				glColorPointer(3, GL_FLOAT, 0, vertexColorArrayPH);
-				glDrawArrays(GL_LINE_STRIP, 0, vertexArrayLength);
-			}
+			if (m_peakHold)
+				drawPanArrays(GL_LINE_STRIP, phLineOffset, phLineOffset, vertexArrayLength);
 			
 			glDisableClientState(GL_VERTEX_ARRAY);
 			glDisableClientState(GL_COLOR_ARRAY);
@@ -953,52 +940,19 @@ void QGLReceiverPanel::drawPanadapter() {
 			glDisable(GL_LINE_SMOOTH);
 
 			for (int i = 0; i < vertexArrayLength; i++) {
-			
-				mutex.lock();
-				if (!m_peakHold) {
-					
-					vertexColorArrayBg[2*i].x = m_redST;
-					vertexColorArrayBg[2*i].y = m_greenST;
-					vertexColorArrayBg[2*i].z = m_blueST;
-								
-					vertexColorArrayBg[2*i+1].x = m_redSB;
-					vertexColorArrayBg[2*i+1].y = m_greenSB;
-					vertexColorArrayBg[2*i+1].z = m_blueSB;
-				}
-				else {
-
-					vertexColorArrayBg[2*i].x = m_redSB;
-					vertexColorArrayBg[2*i].y = m_greenSB;
-					vertexColorArrayBg[2*i].z = m_blueSB;
-								
-					vertexColorArrayBg[2*i+1].x = m_redSB;
-					vertexColorArrayBg[2*i+1].y = m_greenSB;
-					vertexColorArrayBg[2*i+1].z = m_blueSB;
-
-					vertexColorArrayBgPH[2*i].x = 0.9f;//m_redST;
-					vertexColorArrayBgPH[2*i].y = 0.9f;//m_greenST;
-					vertexColorArrayBgPH[2*i].z = 0.9f;//m_blueST;
-								
-					vertexColorArrayBgPH[2*i+1].x = 0.9f;// * m_redSB;
-					vertexColorArrayBgPH[2*i+1].y = 0.9f;// * m_greenSB;
-					vertexColorArrayBgPH[2*i+1].z = 0.9f;// * m_blueSB;
-				}
-				mutex.unlock();
 
 				vertexArrayBg[2*i].x = (GLfloat)(i/m_scaleMult);
-				vertexArrayBg[2*i].y = (GLfloat)(yTop - yScale * m_panadapterBins.at(i));
+				vertexArrayBg[2*i].y = (GLfloat)(yTop - yScale * bins.at(i));
 				vertexArrayBg[2*i].z = -1.0f;
 
 				vertexArrayBg[2*i+1].x = (GLfloat)(i/m_scaleMult);
 				vertexArrayBg[2*i+1].y = (GLfloat)yTop;
-				//vertexArrayBg[2*i+1].y = (GLfloat)(m_panRect.bottom());
-				//vertexArrayBg[2*i].y = (GLfloat)(yScale * m_panadapterBins.at(i));
 				vertexArrayBg[2*i+1].z = -1.0f;
 
 				if (m_peakHold) {
 					
 					vertexArrayBgPH[2*i].x = (GLfloat)(i/m_scaleMult);
-					vertexArrayBgPH[2*i].y = (GLfloat)(yTop - yScale * m_panPeakHoldBins.at(i));
+					vertexArrayBgPH[2*i].y = (GLfloat)(yTop - yScale * peakHoldBins.at(i));
 					vertexArrayBgPH[2*i].z = -2.0f;
 
 					vertexArrayBgPH[2*i+1].x = (GLfloat)(i/m_scaleMult);
@@ -1006,37 +960,25 @@ void QGLReceiverPanel::drawPanadapter() {
 					vertexArrayBgPH[2*i+1].z = -2.0f;
 				}
 			}
+
+			writePanVertices(fillOffset, 2*vertexArrayLength);
+			if (m_peakHold)
+				writePanVertices(phFillOffset, 2*vertexArrayLength);
 			
 			glEnableClientState(GL_VERTEX_ARRAY);
 			glEnableClientState(GL_COLOR_ARRAY);
 				
-			glVertexPointer(3, GL_FLOAT, 0, vertexArrayBg);
-			glColorPointer(3, GL_FLOAT, 0, vertexColorArrayBg);
-			//glDrawArrays(GL_QUAD_STRIP, 0, 2*vertexArrayLength);
-			glDrawArrays(GL_LINES, 0, 2*vertexArrayLength);
-
-			if (m_peakHold) {
+			drawPanArrays(GL_LINES, fillOffset, fillOffset, 2*vertexArrayLength);
 
-				glVertexPointer(3, GL_FLOAT, 0, vertexArrayBgPH);
-				glColorPointer(3, GL_FLOAT, 0, vertexColorArrayBgPH);
-				glDrawArrays(GL_LINES, 0, 2*vertexArrayLength);
-			}
+			if (m_peakHold)
+				drawPanArrays(GL_LINES, phFillOffset, phFillOffset, 2*vertexArrayLength);
 
 			glDisableClientState(GL_VERTEX_ARRAY);
 			glDisableClientState(GL_COLOR_ARRAY);
 
 			break;
 	}
-	spectrumBufferMutex.unlock();
-
-	delete[] vertexArray;
-	delete[] vertexColorArray;
-	delete[] vertexArrayBg;
-	delete[] vertexColorArrayBg;
-	delete[] vertexArrayBgPH;
-	delete[] vertexColorArrayBgPH;
-	delete[] vertexArrayPH;
-	delete[] vertexColorArrayPH;
+	QGLBuffer::release(QGLBuffer::VertexBuffer);
 
 	//glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
 
@@ -1047,6 +989,171 @@ void QGLReceiverPanel::drawPanadapter() {
 	glDisable(GL_SCISSOR_TEST);
 } 
 
+// Layout of the panadapter VBOs (vertices and colours alike) for n bins, in
+// TGL3float units: line [0, n), filled strip or min/max band [n, 3n), peak hold line
+// [3n, 4n), peak hold strip [4n, 6n), background [6n, 6n+4) and ADC
+// overload background [6n+4, 6n+8). The buffers are reallocated only when
+// the number of bins changes; the colours and the background are rewritten
+// when the colours, the graphics mode, the peak hold state, the current
+// receiver or the panadapter rectangle change.
+void QGLReceiverPanel::updatePanadapterBuffers(int length) {
+
+	if (!m_panVertexVBO.isCreated()) {
+
+		m_panVertexVBO.setUsagePattern(QGLBuffer::DynamicDraw);
+		m_panVertexVBO.create();
+		m_panColorVBO.setUsagePattern(QGLBuffer::StaticDraw);
+		m_panColorVBO.create();
+	}
+
+	int count = 6 * length + 8;
+	bool resized = (m_panVertices.size() != count);
+
+	if (resized) {
+
+		m_panVertices.resize(count);
+		m_panColors.resize(count);
+
+		m_panVertexVBO.bind();
+		m_panVertexVBO.allocate(count * sizeof(TGL3float));
+		m_panColorVBO.bind();
+		m_panColorVBO.allocate(count * sizeof(TGL3float));
+		QGLBuffer::release(QGLBuffer::VertexBuffer);
+	}
+
+	int state = (int) m_panMode | (m_peakHold ? 0x10 : 0) | (m_receiver == m_currentReceiver ? 0x20 : 0);
+
+	if (!resized && !m_spectrumColorsChanged && state == m_panVBOState && m_panRect == m_panVBORect)
+		return;
+
+	TGL3float *color = m_panColors.data();
+	TGL3float *colorBg = color + length;
+	TGL3float *colorPH = color + 3 * length;
+	TGL3float *colorBgPH = color + 4 * length;
+	TGL3float *colorBkg = color + 6 * length;
+
+	mutex.lock();
+	switch (m_panMode) {
+
+		case (PanGraphicsMode) FilledLine:
+
+			for (int i = 0; i < length; i++) {
+
+				setVertexColor(colorBg[2*i], 0.7f * m_redF, 0.7f * m_greenF, 0.7f * m_blueF);
+				setVertexColor(colorBg[2*i+1], 0.3f * m_redF, 0.3f * m_greenF, 0.3f * m_blueF);
+
+				if (!m_peakHold)
+					setVertexColor(color[i], m_red, m_green, m_blue);
+				else
+					setVertexColor(color[i], 0.7f, 0.7f, 0.7f);
+
+				setVertexColor(colorPH[i], m_red, m_green, m_blue);
+			}
+			break;
+
+		case (PanGraphicsMode) Line:
+
+			for (int i = 0; i < length; i++) {
+
+				if (!m_peakHold)
+					setVertexColor(color[i], m_red, m_green, m_blue);
+				else
+					setVertexColor(color[i], 0.6f, 0.6f, 0.6f);
+
+				setVertexColor(colorBg[2*i], 0.5f * color[i].x, 0.5f * color[i].y, 0.5f * color[i].z);
+				colorBg[2*i+1] = colorBg[2*i];
+
+				setVertexColor(colorPH[i], m_red, m_green, m_blue);
+			}
+			break;
+
+		case (PanGraphicsMode) Solid:
+
+			for (int i = 0; i < length; i++) {
+
+				if (!m_peakHold)
+					setVertexColor(colorBg[2*i], m_redST, m_greenST, m_blueST);
+				else
+					setVertexColor(colorBg[2*i], m_redSB, m_greenSB, m_blueSB);
+
+				setVertexColor(colorBg[2*i+1], m_redSB, m_greenSB, m_blueSB);
+
+				setVertexColor(colorBgPH[2*i], 0.9f, 0.9f, 0.9f);
+				setVertexColor(colorBgPH[2*i+1], 0.9f, 0.9f, 0.9f);
+			}
+			break;
+	}
+
+	// background: top left, top right, bottom left, bottom right corner
+	if (m_receiver == m_currentReceiver) {
+
+		setVertexColor(colorBkg[0], 0.8f * m_bkgRed, 0.8f * m_bkgGreen, 0.8f * m_bkgBlue);
+		setVertexColor(colorBkg[1], 0.6f * m_bkgRed, 0.6f * m_bkgGreen, 0.6f * m_bkgBlue);
+		setVertexColor(colorBkg[2], 0.4f * m_bkgRed, 0.4f * m_bkgGreen, 0.4f * m_bkgBlue);
+		setVertexColor(colorBkg[3], 0.2f * m_bkgRed, 0.2f * m_bkgGreen, 0.2f * m_bkgBlue);
+	}
+	else {
+
+		for (int i = 0; i < 4; i++)
+			setVertexColor(colorBkg[i], 0.4f * m_bkgRed, 0.4f * m_bkgGreen, 0.4f * m_bkgBlue);
+	}
+
+	for (int i = 4; i < 8; i++)
+		setVertexColor(colorBkg[i], m_bkgRed, 0.2f * m_bkgGreen, 0.2f * m_bkgBlue);
+	mutex.unlock();
+
+	GLfloat x1 = (GLfloat) m_panRect.left();
+	GLfloat y1 = (GLfloat) m_panRect.top();
+	GLfloat x2 = x1 + m_panRect.width();
+	GLfloat y2 = y1 + m_panRect.height();
+
+	TGL3float *vertexBkg = m_panVertices.data() + 6 * length;
+	TGL3float corners[4] = {
+
+		{ x1, y1, -4.0f },
+		{ x2, y1, -4.0f },
+		{ x1, y2, -4.0f },
+		{ x2, y2, -4.0f }
+	};
+
+	for (int i = 0; i < 4; i++) {
+
+		vertexBkg[i] = corners[i];
+		vertexBkg[i + 4] = corners[i];
+	}
+
+	m_panColorVBO.bind();
+	m_panColorVBO.write(0, m_panColors.constData(), count * sizeof(TGL3float));
+
+	m_panVertexVBO.bind();
+	writePanVertices(6 * length, 8);
+	QGLBuffer::release(QGLBuffer::VertexBuffer);
+
+	m_spectrumColorsChanged = false;
+	m_panVBOState = state;
+	m_panVBORect = m_panRect;
+}
+
+// uploads \a count staged vertices from \a offset; the vertex VBO must be bound
+void QGLReceiverPanel::writePanVertices(int offset, int count) {
+
+	m_panVertexVBO.write(
+		offset * sizeof(TGL3float),
+		m_panVertices.constData() + offset,
+		count * sizeof(TGL3float));
+}
+
+void QGLReceiverPanel::drawPanArrays(GLenum mode, int vertexOffset, int colorOffset, int count, int vertexStride) {
+
+	m_panVertexVBO.bind();
+	glVertexPointer(3, GL_FLOAT, vertexStride, (const GLvoid *)(vertexOffset * sizeof(TGL3float)));
+
+	m_panColorVBO.bind();
+	glColorPointer(3, GL_FLOAT, 0, (const GLvoid *)(colorOffset * sizeof(TGL3float)));
+
+	glDrawArrays(mode, 0, count);
+}
+
 void QGLReceiverPanel::drawPanVerticalScale() {
 
 	if (!m_dBmScalePanRect.isValid()) return;
@@ -1386,6 +1493,11 @@ void QGLReceiverPanel::drawPanFilter() {
 	}
 }
 
+// The waterfall is a ring of texture rows: every new line is uploaded into
+// the row above the previous one, and the texture is drawn starting at that
+// row with GL_REPEAT wrapping the older lines around. Nothing is copied on
+// the GPU; the texture is only reallocated if the waterfall size changes,
+// so the history survives zooming.
 void QGLReceiverPanel::drawWaterfall() {
 
 	if (m_waterfallRect.isEmpty()) return;
@@ -1394,155 +1506,67 @@ void QGLReceiverPanel::drawWaterfall() {
 	int left = m_waterfallRect.left();
 	int width = m_waterfallRect.width();
 	int height = m_waterfallRect.height();
-	//int height = this->size().height();
-
 
 	glColor4f(1.0, 1.0, 1.0, 1.0);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	glEnable(GL_BLEND);
 
-	// check for framebuffer objects
-	if (set->getFBOPresence()) {
-	
-		// create the FBOs if not exist
-		if (!m_textureFBO || !m_waterfallLineFBO || !m_waterfallFBO || m_waterfallUpdate) {
-	
-			if (m_waterfallLineFBO) {
-
-				delete m_waterfallLineFBO;
-				m_waterfallLineFBO = 0;
-			}
-		
-			if (m_waterfallFBO) {
-
-				delete m_waterfallFBO;
-				m_waterfallFBO = 0;
-			}
-
-			if (m_textureFBO) {
-
-				delete m_textureFBO;
-				m_textureFBO = 0;
-			}
-
-			if (QGLFramebufferObject::hasOpenGLFramebufferBlit()) {
-			
-				//QGLFramebufferObjectFormat format;
-				//format.setSamples(2);
-				//format.setAttachment(QGLFramebufferObject::CombinedDepthStencil);
-
-				m_waterfallLineFBO = new QGLFramebufferObject(width, 1);
-				//if (m_waterfallLineFBO)
-				//GRAPHICS_DEBUG << "m_waterfallLineFBO generated.";
-
-				m_waterfallFBO = new QGLFramebufferObject(width, height);
-				//if (m_waterfallFBO)
-				//GRAPHICS_DEBUG << "m_waterfallFBO generated.";
-
-				m_textureFBO = new QGLFramebufferObject(width, height);
-				//if (m_textureFBO)
-				//GRAPHICS_DEBUG << "m_textureFBO generated.";
-				
-			}	
-			else {
-			
-				GRAPHICS_DEBUG << "has no OpenGL FramebufferBlit";
-			}
-
-			m_waterfallUpdate = false;
-			drawGLRect(m_waterfallRect, Qt::black);
-
-			m_waterfallLineCnt = 0;
-						
-			if (width > 0) {
-
-				m_waterfallPixel.clear();
-				m_waterfallPixel.resize(width);
-		
-				TGL_ubyteRGBA col;
-				col.red = 0; col.green = 0;	col.blue = 0; col.alpha = 255;
-		
-				for (int i = 0; i < width; i++) 
-					m_waterfallPixel[i] = col;
-			}
-		}
-
-		if (m_dataEngineState == QSDR::DataEngineUp) {
-
-			GLint oldTex;
-			glGetIntegerv(GL_TEXTURE_BINDING_2D, &oldTex);
-
-			m_waterfallLineFBO->bind();
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_waterfallPixel.data());
-			m_waterfallLineFBO->release();
-
-			m_waterfallLineCnt++;
-			if (m_waterfallLineCnt > height) m_waterfallLineCnt = height;
-
-			// draw the waterfall
-			glEnable(GL_TEXTURE_2D);
-			glBindTexture(GL_TEXTURE_2D, m_waterfallFBO->texture());
-	
-			glBegin(GL_QUADS);
-				glTexCoord2f(0, 1); glVertex2i(left,			top);			// top left corner
-				glTexCoord2f(1, 1); glVertex2i(left + width,	top);			// top right corner
-				glTexCoord2f(1, 0); glVertex2i(left + width,	top + height);	// bottom right corner
-				glTexCoord2f(0, 0); glVertex2i(left,			top + height);	// bottom left corner
-			glEnd();
-			glBindTexture(GL_TEXTURE_2D, oldTex);
-			glDisable(GL_TEXTURE_2D);
-
-			glPushAttrib(GL_VIEWPORT_BIT);
-			glViewport(0, 0, width, height);
-			setProjectionOrthographic(width, height);
+	GLint oldTex;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &oldTex);
 
-			// render to the next waterfall texture
-			m_textureFBO->bind();
+	if (!m_waterfallTexture || (m_waterfallUpdate && m_waterfallTextureSize != QSize(width, height))) {
 
-			glEnable(GL_TEXTURE_2D);
-			glBindTexture(GL_TEXTURE_2D, m_waterfallFBO->texture());
+		if (!m_waterfallTexture)
+			glGenTextures(1, &m_waterfallTexture);
 
-			// the waterfall FBO
-			glBegin(GL_QUADS);
-				glTexCoord2f(0, 1); glVertex2i(0,	  1);			// top left corner
-				glTexCoord2f(1, 1); glVertex2i(width, 1);			// top right corner
-				glTexCoord2f(1, 0); glVertex2i(width, 1 + height);	// bottom right corner
-				glTexCoord2f(0, 0); glVertex2i(0,	  1 + height);	// bottom left corner
-			glEnd();
+		// opaque black until the first lines come in
+		TGL_ubyteRGBA black;
+		black.red = 0; black.green = 0; black.blue = 0; black.alpha = 255;
 
-			// the new waterfall line
-			glBindTexture(GL_TEXTURE_2D, m_waterfallLineFBO->texture());
-			
-			glBegin(GL_QUADS);
-				glTexCoord2f(0, 1); glVertex2i(0,		0);	// top left corner
-				glTexCoord2f(1, 1); glVertex2i(width,	0);	// top right corner
-				glTexCoord2f(1, 0); glVertex2i(width,	1);	// bottom right corner
-				glTexCoord2f(0, 0); glVertex2i(0,		1);	// bottom left corner
-			glEnd();
-			
-			m_textureFBO->release();
+		QVector<TGL_ubyteRGBA> clear(width * height, black);
 
-			glDisable(GL_TEXTURE_2D);
-			glPopAttrib();
-			glViewport(0, 0, size().width(), size().height());
-			setProjectionOrthographic(size().width(), size().height());
+		glBindTexture(GL_TEXTURE_2D, m_waterfallTexture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, clear.constData());
 
-			if (m_waterfallLineCnt < height) {
+		m_waterfallTextureSize = QSize(width, height);
+		m_waterfallRow = 0;
+	}
+	m_waterfallUpdate = false;
 
-				QRect rect(0, top + m_waterfallLineCnt, width, height - m_waterfallLineCnt);
-				drawGLRect(rect, QColor(0, 0, 0, 255), 3.0f);
-			}
+	if (m_dataEngineState == QSDR::DataEngineUp) {
 
-			// copy the next waterfall image to the waterfall FBO
-			QRect copyRect(0, 0, width, height);
-			QGLFramebufferObject::blitFramebuffer(m_waterfallFBO, copyRect, m_textureFBO, copyRect);
-		}
-		else {
+		glBindTexture(GL_TEXTURE_2D, m_waterfallTexture);
+
+		// one row upload per line
+		m_waterfallRow = (m_waterfallRow + height - 1) % height;
+		glTexSubImage2D(
+			GL_TEXTURE_2D, 0, 0, m_waterfallRow,
+			qMin(width, m_displayFrame.waterfallRow.size()), 1,
+			GL_RGBA, GL_UNSIGNED_BYTE, m_displayFrame.waterfallRow.constData());
+
+		// the newest row at the top, the older ones below it
+		GLfloat t0 = (GLfloat) m_waterfallRow / height;
+		GLfloat t1 = t0 + 1.0f;
+
+		glEnable(GL_TEXTURE_2D);
+		glBegin(GL_QUADS);
+			glTexCoord2f(0, t0); glVertex2i(left,			top);			// top left corner
+			glTexCoord2f(1, t0); glVertex2i(left + width,	top);			// top right corner
+			glTexCoord2f(1, t1); glVertex2i(left + width,	top + height);	// bottom right corner
+			glTexCoord2f(0, t1); glVertex2i(left,			top + height);	// bottom left corner
+		glEnd();
+		glDisable(GL_TEXTURE_2D);
 
-			drawGLRect(m_waterfallRect, Qt::black);
-		}
+		glBindTexture(GL_TEXTURE_2D, oldTex);
 	}
 	else {
+
+		glBindTexture(GL_TEXTURE_2D, oldTex);
+		drawGLRect(m_waterfallRect, Qt::black);
 	}
 }
 
@@ -1783,16 +1807,16 @@ void QGLReceiverPanel::drawVFOControl() {
 		if (m_dataEngineState == QSDR::DataEngineUp) {
 				
 			qglColor(QColor(0, 0, 0, 255));
-			m_oglTextSmall->renderText(x1+3, y1, 0.0f, str.arg(m_sampleSize));
+			m_oglTextSmall->renderText(x1+3, y1, 0.0f, str.arg(m_displayFrame.sampleSize));
 			qglColor(QColor(255, 170, 90, 200));
-			m_oglTextSmall->renderText(x1+1, y1-2, 1.0f, str.arg(m_sampleSize));
+			m_oglTextSmall->renderText(x1+1, y1-2, 1.0f, str.arg(m_displayFrame.sampleSize));
 		}
 		
 		str = "FFT: %1";
 		//float res;
 		QString s;
 
-		switch (m_fftMult) {
+		switch (m_displayFrame.fftMult) {
 
 			case 1:
 				s = "4k";
@@ -3615,6 +3639,14 @@ void QGLReceiverPanel::setSpectrumSize(QObject *sender, int value) {
 	}
 }
 
+// the display prep thread switched the FFT size of this receiver
+void QGLReceiverPanel::setSampleSize(int rx, int size) {
+
+	if (m_receiver != rx) return;
+
+	set->setSampleSize(this, rx, size);
+}
+
 void QGLReceiverPanel::setCtrFrequency(QObject *sender, int mode, int rx, long freq) {
 
 	Q_UNUSED(sender)
@@ -3625,11 +3657,7 @@ void QGLReceiverPanel::setCtrFrequency(QObject *sender, int mode, int rx, long f
 
 	if (m_peakHold) {
 		
-		//spectrumBufferMutex.lock();
-		m_panPeakHoldBins.clear();
-		m_panPeakHoldBins.resize(m_panSpectrumBinsLength);
-		m_panPeakHoldBins.fill(-500.0);
-		//spectrumBufferMutex.unlock();
+		m_peakHoldBufferResize = true;
 	}
 
 	for (int i = 0; i < set->getNumberOfReceivers(); i++) {
@@ -3654,11 +3682,7 @@ void QGLReceiverPanel::setVFOFrequency(QObject *sender, int mode, int rx, long f
 
 	if (m_peakHold) {
 		
-		//spectrumBufferMutex.lock();
-		m_panPeakHoldBins.clear();
-		m_panPeakHoldBins.resize(m_panSpectrumBinsLength);
-		m_panPeakHoldBins.fill(-500.0);
-		//spectrumBufferMutex.unlock();
+		m_peakHoldBufferResize = true;
 	}
 
 	for (int i = 0; i < set->getNumberOfReceivers(); i++) {
@@ -3735,252 +3759,78 @@ void QGLReceiverPanel::freqRulerPositionChanged(QObject *sender, int rx, float p
 	}
 }
 
-void QGLReceiverPanel::setSpectrumBuffer(int rx, const qVectorFloat& buffer) {
-
-	if (m_receiver != rx) return;
-
-	QVector<float> specBuf(m_spectrumSize);
-	QVector<float> waterBuf(m_spectrumSize);
-	waterBuf = buffer;
-
-
-	if (m_dataEngineState == QSDR::DataEngineUp) {
-	
-		if (m_spectrumAveraging) {
-	
-			spectrumBufferMutex.lock();
-			specBuf = buffer;
-			averager->ProcessDBAverager(specBuf, specBuf);
-			computeDisplayBins(specBuf, waterBuf);
-			spectrumBufferMutex.unlock();
-		}
-		else {
-
-			specBuf = buffer;
-			if (m_dataEngineState == QSDR::DataEngineUp)
-				computeDisplayBins(specBuf, waterBuf);
-		}
-	}
-}
-
-void QGLReceiverPanel::computeDisplayBins(QVector<float>& buffer, QVector<float>& waterfallBuffer) {
-
-	//int m_sampleSize = 0;
-	int deltaSampleSize = 0;
-	int idx = 0;
-	int lIdx = 0;
-	int rIdx = 0;
-	qreal localMax;
-
-	if (m_serverMode == QSDR::ChirpWSPRFile) {
-		
-		m_sampleSize = (int)floor(2 * BUFFER_SIZE * m_freqScaleZoomFactor);
-		deltaSampleSize = 2 * BUFFER_SIZE - m_sampleSize;
-	}
-	else {
-
-		m_sampleSize = (int)floor(m_fftMult * m_spectrumSize * m_freqScaleZoomFactor);
-		deltaSampleSize = m_spectrumSize - m_sampleSize;
-	}
-
-	if (set->getFFTAutoStatus(m_receiver)) {
-	}
-	else {
-	
-		if (m_sampleSize < 2048) {
-
-			if (m_fftMult == 1) {
-
-				GRAPHICS_DEBUG << "set sample size to 8192";
-				set->setSampleSize(this, m_receiver, 8192);
-				//m_dBmPanLogGain += 3.0103;
-				m_dBmPanLogGain += 6;
-				m_fftMult = 2;
-
-				return;
-			}
-			else if (m_fftMult == 2) {
-
-				GRAPHICS_DEBUG << "set sample size to 16384";
-				set->setSampleSize(this, m_receiver, 16384);
-				//m_dBmPanLogGain += 3.0103;
-				m_dBmPanLogGain += 6;
-				m_fftMult = 4;
-
-				return;
-			}
-			else if (m_fftMult == 4) {
-
-				GRAPHICS_DEBUG << "set sample size to 32768";
-				set->setSampleSize(this, m_receiver, 32768);
-				//m_dBmPanLogGain += 3.0103;
-				m_dBmPanLogGain += 6;
-				m_fftMult = 8;
-
-				return;
-			}
-			else if (m_fftMult == 8) {
-
-				GRAPHICS_DEBUG << "set sample size to 65536";
-				set->setSampleSize(this, m_receiver, 65536);
-				//m_dBmPanLogGain += 3.0103;
-				m_dBmPanLogGain += 6;
-				m_fftMult = 16;
-
-				return;
-			}
-		}
-		else if (m_sampleSize > 4096) {
-
-			if (m_fftMult == 2) {
-
-				GRAPHICS_DEBUG << "set sample size to 4096";
-				set->setSampleSize(this, m_receiver, 4096);
-				//m_dBmPanLogGain -= 3.0103;
-				m_dBmPanLogGain -= 6;
-				m_fftMult = 1;
-
-				return;
-			}
-			else if (m_fftMult == 4) {
-
-				GRAPHICS_DEBUG << "set sample size to 8192";
-				set->setSampleSize(this, m_receiver, 8192);
-				//m_dBmPanLogGain -= 3.0103;
-				m_dBmPanLogGain -= 6;
-				m_fftMult = 2;
+// Hands the view state to the display prep thread; called on every paint,
+// so a zoom, scale or size change reaches the worker with the next frame.
+void QGLReceiverPanel::updateDisplayPrepParams() {
 
-				return;
-			}
-			else if (m_fftMult == 8) {
-
-				GRAPHICS_DEBUG << "set sample size to 16384";
-				set->setSampleSize(this, m_receiver, 16384);
-				//m_dBmPanLogGain -= 3.0103;
-				m_dBmPanLogGain -= 6;
-				m_fftMult = 4;
+	updateWaterfallLut();
 
-				return;
-			}
-			else if (m_fftMult == 16) {
-
-				GRAPHICS_DEBUG << "set sample size to 32768";
-				set->setSampleSize(this, m_receiver, 32768);
-				//m_dBmPanLogGain -= 3.0103;
-				m_dBmPanLogGain -= 6;
-				m_fftMult = 8;
+	if (m_peakHoldBufferResize) {
 
-				return;
-			}
-		}
+		m_peakHoldReset++;
+		m_peakHoldBufferResize = false;
 	}
 
-	//GRAPHICS_DEBUG << "m_dBmPanLogGain = " << m_dBmPanLogGain;
-
-	m_panScale = (qreal)(1.0 * m_sampleSize / m_panRectWidth);
-	m_scaleMultOld = m_scaleMult;
-		
-	if (m_panScale < 0.125) {
-		m_scaleMult = 0.0625;
-	}
-	else if (m_panScale < 0.25) {
-		m_scaleMult = 0.125;
-	}
-	else if (m_panScale < 0.5) {
-		m_scaleMult = 0.25;
-	}
-	else if (m_panScale < 1.0) {
-		m_scaleMult = 0.5;
-	}
-	else {
-		m_scaleMult = 1.0;
-	}
+	TDisplayPrepParams params;
+
+	params.serverMode = m_serverMode;
+	params.dataEngineState = m_dataEngineState;
+	params.spectrumSize = m_spectrumSize;
+	params.panRectWidth = m_panRectWidth;
+	params.freqScaleZoomFactor = m_freqScaleZoomFactor;
+	params.dBmPanMin = m_dBmPanMin;
+	params.mercuryAttenuator = m_mercuryAttenuator;
+	params.peakHold = m_peakHold;
+	params.peakHoldReset = m_peakHoldReset;
+	params.waterfallLut = m_waterfallLut;
+	params.waterfallLutLo = m_waterfallLutLo;
+	params.waterfallLutScale = m_waterfallLutScale;
+
+	m_displayPrep->setParams(params);
+}
 
-	m_panSpectrumBinsLength = (GLint)(m_scaleMult * m_panRectWidth);
+// The palette is sampled from getWaterfallColorAtPixel() at the centres of
+// WATERFALL_LUT_SIZE steps between the two thresholds. It is rebuilt when
+// the thresholds (dBm scale, waterfall offsets), the colour mode or the
+// colours change, so the per bin colour is a single table lookup.
+void QGLReceiverPanel::updateWaterfallLut() {
 
-	/*if (m_sampleSize != m_oldSampleSize) {
-	
-		GRAPHICS_DEBUG << "m_panSpectrumBinsLength = " << m_panSpectrumBinsLength;
-		GRAPHICS_DEBUG << "m_sampleSize =            " << m_sampleSize;
-		GRAPHICS_DEBUG << "deltaSampleSize =         " << deltaSampleSize;
-		GRAPHICS_DEBUG << "";
+	int lowerThreshold = (int)m_dBmPanMin - m_waterfallOffsetLo;
+	int upperThreshold = (int)m_dBmPanMax + m_waterfallOffsetHi;
 
-		m_oldSampleSize = m_sampleSize;
-	}*/
+	if (!m_waterfallLutUpdate &&
+		lowerThreshold == m_waterfallLutLo &&
+		upperThreshold == m_waterfallLutHi &&
+		(int) m_waterfallMode == m_waterfallLutMode)
+		return;
 
-	if (m_scaleMultOld != m_scaleMult) {
+	m_waterfallLut.resize(WATERFALL_LUT_SIZE + 2);
 
-		m_waterfallUpdate = true;
-	}
+	qreal step = (qreal)(upperThreshold - lowerThreshold) / WATERFALL_LUT_SIZE;
 
-	m_waterfallPixel.clear();
-	m_waterfallPixel.resize(4 * m_panRectWidth);
+	for (int i = 0; i < WATERFALL_LUT_SIZE + 2; i++) {
 
-	m_panadapterBins.clear();
+		qreal value;
+		if (i == 0)
+			value = lowerThreshold;
+		else if (i == WATERFALL_LUT_SIZE + 1)
+			value = upperThreshold;
+		else
+			value = lowerThreshold + (i - 0.5) * step;
 
-	if (m_peakHoldBufferResize) {
-		
-		//spectrumBufferMutex.lock();
-		m_panPeakHoldBins.clear();
-		m_panPeakHoldBins.resize(m_panSpectrumBinsLength);
-		m_panPeakHoldBins.fill(-300.0);
-		//spectrumBufferMutex.unlock();
+		QColor pColor = getWaterfallColorAtPixel(value);
 
-		m_peakHoldBufferResize = false;
+		m_waterfallLut[i].red   = (uchar)(pColor.red());
+		m_waterfallLut[i].green = (uchar)(pColor.green());
+		m_waterfallLut[i].blue  = (uchar)(pColor.blue());
+		m_waterfallLut[i].alpha = 255;
 	}
-	
-	for (int i = 0; i < m_panSpectrumBinsLength; i++) {
-		
-		//qreal max;
-		idx = 0;
-		lIdx = (int)qFloor((qreal)(i * m_panScale / m_scaleMult));
-		rIdx = (int)qFloor((qreal)(i * m_panScale / m_scaleMult) + m_panScale / m_scaleMult);
-					
-		// max value; later we try mean value also!
-		localMax = -10000.0F;
-		for (int j = lIdx; j < rIdx; j++) {
-
-			if (buffer.at(j) > localMax) {
-
-				localMax = buffer.at(j);
-				idx = j;
-			}
-		}
-		// shift the beginning of the bins by half of the difference between
-		// full spectrum size and reduced spectrum size due to zooming
-		idx += deltaSampleSize/2;
-		
-		QColor pColor;
-		if (m_mercuryAttenuator) {
-
-			m_panadapterBins << buffer.at(idx) - m_dBmPanMin - m_dBmPanLogGain - 20.0f;
-			pColor = getWaterfallColorAtPixel(waterfallBuffer.at(idx) - m_dBmPanLogGain - 20.0f);
-		}
-		else {
-
-			m_panadapterBins << buffer.at(idx) - m_dBmPanMin - m_dBmPanLogGain;
-			pColor = getWaterfallColorAtPixel(waterfallBuffer.at(idx) - m_dBmPanLogGain);
-		}
 
-		if (m_peakHold && (m_panadapterBins.at(i) > m_panPeakHoldBins.at(i))) {
-
-			m_panPeakHoldBins[i] = m_panadapterBins.at(i);
-		}
-				
-		
-		TGL_ubyteRGBA color;
-		color.red   = (uchar)(pColor.red());
-		color.green = (uchar)(pColor.green());
-		color.blue  = (uchar)(pColor.blue());
-		color.alpha = 255;
-		
-		for (int j = 0; j < (int)(1/m_scaleMult); j++) {
-
-			m_waterfallPixel[(int)(i/m_scaleMult) + j] = color;
-		}
-	}
-	m_waterfallDisplayUpdate = true;
-	update();
+	m_waterfallLutLo = lowerThreshold;
+	m_waterfallLutHi = upperThreshold;
+	m_waterfallLutMode = (int) m_waterfallMode;
+	m_waterfallLutScale = upperThreshold > lowerThreshold ? (float) WATERFALL_LUT_SIZE / (upperThreshold - lowerThreshold) : 0.0f;
+	m_waterfallLutUpdate = false;
 }
 
 // get waterfall colors - taken from PowerSDR/KISS Konsole
@@ -4145,11 +3995,7 @@ void QGLReceiverPanel::systemStateChanged(
 		m_dataEngineState = state;
 
 	if (state == QSDR::DataEngineDown)
-		m_fftMult = 1;
-	//	m_panadapterBins.clear();
-
-	if (state == QSDR::DataEngineDown)
-		averager->clearBuffer();
+		m_displayPrep->reset();
 
 	if (m_serverMode != mode)
 		m_serverMode = mode;
@@ -4191,14 +4037,12 @@ void QGLReceiverPanel::graphicModeChanged(
 
 	 if (m_receiver != rx) return;
 
-	 spectrumBufferMutex.lock();
-
 	 if (m_spectrumAveraging == value) 
 		 return;
 	 else
 		 m_spectrumAveraging = value;
 
-	 spectrumBufferMutex.unlock();
+	 update();
  }
 
 void QGLReceiverPanel::setSpectrumAveragingCnt(int value) {
@@ -4239,17 +4083,13 @@ void QGLReceiverPanel::setPeakHoldStatus(bool value, int rx) {
 
 	if (m_receiver != rx) return;
 
-	spectrumBufferMutex.lock();
-
-	if (m_peakHold == value) 
+	if (m_peakHold == value)
 		return;
 	else
 		m_peakHold = value;
 	
-	m_panPeakHoldBins.clear();
-	m_panPeakHoldBins.resize(m_panSpectrumBinsLength);
-	m_panPeakHoldBins.fill(-500.0);
-	spectrumBufferMutex.unlock();
+	m_peakHoldBufferResize = true;
+	update();
 }
 
 void QGLReceiverPanel::setPanLockedStatus(bool value, int rx) {
@@ -4315,6 +4155,7 @@ void QGLReceiverPanel::setMercuryAttenuator(QObject* sender, HamBand band, int v
 void QGLReceiverPanel::setPanadapterColors() {
 
 	m_spectrumColorsChanged = true;
+	m_waterfallLutUpdate = true;
 
 	mutex.lock();
 	m_bkgRed   = (GLfloat)(set->getPanadapterColors().panBackgroundColor.red() / 256.0);
@@ -33,11 +33,13 @@
 #include "cusdr_fonts.h"
 #include "Util/cusdr_buttons.h"
 #include "cusdr_oglText.h"
-#include "QtDSP/qtdsp_dualModeAverager.h"
+#include "cusdr_oglDisplayPrep.h"
 #include "cusdr_radioPopupWidget.h"
 
 #include <QWheelEvent>
 #include <QtOpenGL/QGLWidget>
+#include <QtOpenGL/QGLBuffer>
+#include <QElapsedTimer>
 
 
 #ifdef LOG_GRAPHICS
@@ -61,7 +63,6 @@ public slots:
 
 	//void setSpectrumBuffer(const float* buffer, int size);
 	//void setSpectrumBuffer(const qVectorFloat& buffer);
-	void setSpectrumBuffer(int rx, const qVectorFloat& buffer);
 	void setCtrFrequency(QObject* sender, int mode, int rx, long freq);
 	void setVFOFrequency(QObject* sender, int mode, int rx, long freq);
 
@@ -89,7 +90,7 @@ private:
 	CFonts*						fonts;
 	TFonts						m_fonts;
 
-	DualModeAverager*			averager;
+	DisplayPrep*				m_displayPrep;
 	RadioPopupWidget*			radioPopup;
 	AGCMode						m_agcMode;
 	DSPMode						m_dspMode;
@@ -100,6 +101,12 @@ private:
 	QTime						m_resizeTime;
 	QTime						freqChangeTimer;
 	QTime						peakHoldTimer;
+
+	// paint time statistics, see PANEL_FRAME_TIMING
+	QElapsedTimer				m_frameStatsTimer;
+	qint64						m_panadapterNsecs;
+	qint64						m_paintNsecs;
+	int							m_frameStatsCount;
 	
 	QString						m_bandText;
 	QString						m_agcModeString;
@@ -112,21 +119,26 @@ private:
 	
 	QList<TReceiver>			m_rxDataList;
 	
-	QVector<qreal>					m_panadapterBins;
-	QVector<qreal>					m_panPeakHoldBins;
-	QVarLengthArray<TGL_ubyteRGBA>	m_waterfallPixel;
+	// the latest frame from m_displayPrep
+	TDisplayFrame					m_displayFrame;
 
 	QQueue<QVector<float> >			specAv_queue;
 
 	QGLFramebufferObject*		m_frequencyScaleFBO;
 	QGLFramebufferObject*		m_dBmScaleFBO;
 	QGLFramebufferObject*		m_panadapterGridFBO;
-	QGLFramebufferObject*		m_textureFBO;
-	QGLFramebufferObject*		m_waterfallLineFBO;
-	QGLFramebufferObject*		m_waterfallFBO;
 	QGLFramebufferObject*		m_secScaleWaterfallFBO;
 
+	GLuint						m_waterfallTexture;
+	QSize						m_waterfallTextureSize;
+
+	QGLBuffer					m_panVertexVBO;
+	QGLBuffer					m_panColorVBO;
+	QVector<TGL3float>			m_panVertices;
+	QVector<TGL3float>			m_panColors;
+
 	QRect						m_panRect;
+	QRect						m_panVBORect;
 	QRect						m_dBmScalePanRect;
 	QRect						m_freqScalePanRect;
 	QRect						m_waterfallRect;
@@ -159,6 +171,15 @@ private:
 	QColor						m_waterfallMidColor;
 	QColor						m_gridColor;
 	QColor						m_darkColor;
+
+	// entry 0: at or below the lower threshold, WATERFALL_LUT_SIZE + 1: at or
+	// above the upper threshold
+	QVector<TGL_ubyteRGBA>		m_waterfallLut;
+	int							m_waterfallLutLo;
+	int							m_waterfallLutHi;
+	int							m_waterfallLutMode;
+	float						m_waterfallLutScale;
+	bool						m_waterfallLutUpdate;
 	
 	QMutex						mutex;
 	QMutex						spectrumBufferMutex;
@@ -185,7 +206,6 @@ private:
 	};
     
 	GLint		m_panRectWidth;
-	GLint		m_panSpectrumBinsLength;
 
 	GLint		m_filterLeft;
 	GLint		m_filterRight;
@@ -228,8 +248,6 @@ private:
 	int			m_receiver;
 	//int			m_frequencyRxOnRx;
 	int			m_spectrumSize;
-	int			m_sampleSize;
-	int			m_oldSampleSize;
 	int			m_oldWidth;
 	int			m_oldPanRectHeight;
 	int			m_cnt;
@@ -242,7 +260,6 @@ private:
 	int			m_freqRulerDisplayWidth;
 	int			m_oldWaterfallWidth;
 	int			m_displayTop;
-	int			m_dBmPanLogGain;
 	int			m_panSpectrumMinimumHeight;
 	int			m_mouseRegion;
 	int			m_oldMouseRegion;
@@ -257,11 +274,12 @@ private:
 	int			m_haircrossMaxRight;
 	int			m_haircrossMinTop;
 	int			m_displayCenterlineHeight;
-	int			m_waterfallLineCnt;
+	int			m_waterfallRow;
 	int			m_adcStatus;
 	int			m_fps;
 	int			m_filterWidth;
-	int			m_fftMult;
+	int			m_peakHoldReset;
+	int			m_panVBOState;
 
 	long		m_centerFrequency;
 	long		m_vfoFrequency;
@@ -310,9 +328,7 @@ private:
 	qreal		m_mouseWheelFreqStep;
 	qreal		m_secWaterfallMin;
 	qreal		m_secWaterfallMax;
-	qreal		m_panScale;
 	qreal		m_scaleMult;
-	qreal		m_scaleMultOld;
 	qreal		m_filterLowerFrequency;
 	qreal		m_filterUpperFrequency;
 	qreal		m_mouseDownFilterFrequencyLo;
@@ -340,6 +356,7 @@ private:
 	void	setupConnections();
 
 	QColor	getWaterfallColorAtPixel(qreal value);
+	void	updateWaterfallLut();
 
 	void	saveGLState();
 	void	restoreGLState();
@@ -349,6 +366,9 @@ private:
 	void	paint3DPanadapterMode();
 
 	void	drawPanadapter();
+	void	updatePanadapterBuffers(int length);
+	void	writePanVertices(int offset, int count);
+	void	drawPanArrays(GLenum mode, int vertexOffset, int colorOffset, int count, int vertexStride = 0);
 	void 	drawPanVerticalScale();
 	void 	drawPanHorizontalScale();
 	void 	drawPanadapterGrid();
@@ -366,9 +386,7 @@ private:
 	void 	renderPanadapterGrid();
 	void 	renderWaterfallVerticalScale();
 
-	//void	computeDisplayBins(const QVector<float>& panBuffer, const float* waterfallBuffer);
-	//void	computeDisplayBins(QVector<float> &buffer);
-	void	computeDisplayBins(QVector<float>& panBuffer, QVector<float>& waterfallBuffer);
+	void	updateDisplayPrepParams();
 	void 	showText(float x, float y, float z, const QString &text, bool smallText);
 	void	showRadioPopup(bool value);
 
@@ -387,6 +405,7 @@ private slots:
 					WaterfallColorMode waterfallColorMode);
 
 	void	setSpectrumSize(QObject *sender, int value);
+	void	setSampleSize(int rx, int size);
 	void	setCurrentReceiver(QObject *sender, int value);
 	void 	setHamBand(QObject *sender, int rx, bool byButton, HamBand band);
 	void	setFilterFrequencies(QObject *sender, int rx, qreal lo, qreal hi);
@@ -254,6 +254,13 @@ inline int nextPowerOfTwo(int value) {
 	return value;
 }
 
+inline void setVertexColor(TGL3float &color, GLfloat red, GLfloat green, GLfloat blue) {
+
+	color.x = red;
+	color.y = green;
+	color.z = blue;
+}
+
 inline TScaleSteps getXScale(double size) {
 
 	TScaleSteps s;
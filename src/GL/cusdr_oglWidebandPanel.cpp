@@ -30,6 +30,8 @@
 
 #include "cusdr_oglWidebandPanel.h"
 
+#include <string.h>
+
 //#include <QtGui>
 //#include <QDebug>
 //#include <QFileInfo>
@@ -233,9 +235,9 @@ void QGLWidebandPanel::setupConnections() {
 
 	CHECKED_CONNECT(
 		set,
-		SIGNAL(widebandSpectrumBufferChanged(const qVectorFloat &)),
+		SIGNAL(widebandSpectrumBufferChanged()),
 		this,
-		SLOT(setWidebandSpectrumBuffer(const qVectorFloat &)));
+		SLOT(setWidebandSpectrumBuffer()));
 
 	CHECKED_CONNECT(
 		set,
@@ -1834,17 +1836,22 @@ void QGLWidebandPanel::setCurrentReceiver(QObject *sender, int value) {
 //	////updateGL();
 //}
 
-void QGLWidebandPanel::setWidebandSpectrumBuffer(const qVectorFloat &buffer) {
+void QGLWidebandPanel::setWidebandSpectrumBuffer() {
 
 	//int deltaIdx;
 	//qreal frequencyScale;
 	//qreal scaleMult = 1.0;
 
-	m_wbSpectrumBufferLength = buffer.size();
+	const qVectorFloat *buffer = set->widebandMailbox()->readSlot();
+	if (!buffer) return;
+
+	m_wbSpectrumBufferLength = buffer->size();
 
+	// copied, not shared: the mailbox slot is written again by the
+	// wideband processor
 	mutex.lock();
 	m_wbSpectrumBuffer.resize(m_wbSpectrumBufferLength);
-	m_wbSpectrumBuffer = buffer;
+	memcpy(m_wbSpectrumBuffer.data(), buffer->constData(), m_wbSpectrumBufferLength * sizeof(float));
 
 	//m_scaledBufferSize = qFloor(m_wbSpectrumBufferLength * m_freqScaleZoomFactor);
 	mutex.unlock();
@@ -264,7 +264,7 @@ private slots:
 	void	setCurrentReceiver(QObject *sender, int value);
 	void	setFrequency(QObject *sender, int mode, int rx, long freq);
 	void	setupDisplayRegions(QSize size);
-	void	setWidebandSpectrumBuffer(const qVectorFloat &buffer);
+	void	setWidebandSpectrumBuffer();
 	void	resetWidebandSpectrumBuffer();
 	//void	setSpectrumAveragingCnt(int value);
 	void	setPanadapterColors();
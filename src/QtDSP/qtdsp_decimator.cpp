@@ -0,0 +1,164 @@
+/**
+* @file  qtdsp_decimator.cpp
+* @brief decimator class for QtDSP
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "qtdsp_decimator.h"
+#include "qtdsp_filter.h"
+
+#include <string.h>
+
+
+QDecimator::QDecimator(int size)
+	: m_size(size)
+	, m_decimation(1)
+	, m_numStages(0)
+{
+	for (int s = 0; s < DECIMATOR_MAX_STAGES; s++) {
+
+		// the stages behind the first one see a block halved s times
+		InitCPX(m_stages[s].buf, DECIMATOR_LAST_TAPS - 1 + (m_size >> s), 0.0f);
+	}
+}
+
+QDecimator::~QDecimator() {
+
+	for (int s = 0; s < DECIMATOR_MAX_STAGES; s++)
+		m_stages[s].buf.clear();
+}
+
+void QDecimator::setSampleRate(int value) {
+
+	m_decimation = qMax(1, value / DECIMATOR_OUTPUT_RATE);
+	m_numStages = 0;
+
+	while ((1 << m_numStages) < m_decimation && m_numStages < DECIMATOR_MAX_STAGES)
+		m_numStages++;
+
+	// a stage fed at rate fs has to suppress fs/2 - 28 kHz .. fs/2, which
+	// it folds into +-28 kHz; the last stage has the narrowest transition
+	// band, from 20 to 28 kHz
+	for (int s = 0; s < m_numStages; s++) {
+
+		int taps = DECIMATOR_TAPS;
+		if (s == m_numStages - 1)
+			taps = DECIMATOR_LAST_TAPS;
+		else if (s == m_numStages - 2)
+			taps = DECIMATOR_MID_TAPS;
+
+		designStage(m_stages[s], taps);
+	}
+}
+
+void QDecimator::designStage(HalfBandStage &stage, int taps) {
+
+	float window[DECIMATOR_LAST_TAPS];
+	QFilter::MakeWindow(BLACKMANHARRIS_WINDOW, taps, window);
+
+	int mid = (taps - 1) / 2;
+
+	// windowed sinc with cutoff at a quarter of the input rate; the taps at
+	// even distance from the center are zero. Normalized to unity DC gain.
+	float sum = 0.5f * window[mid];
+	for (int k = 1; k <= mid; k += 2) {
+
+		float tap = (float)(qSin(ONEPI * k / 2.0) / (ONEPI * k)) * window[mid + k];
+		stage.coeff[k / 2] = tap;
+		sum += 2.0f * tap;
+	}
+
+	stage.center = 0.5f * window[mid] / sum;
+	for (int k = 1; k <= mid; k += 2)
+		stage.coeff[k / 2] /= sum;
+
+	stage.taps = taps;
+	stage.history = taps - 1;
+
+	cpx zero;
+	zero.re = 0.0f; zero.im = 0.0f;
+	stage.buf.fill(zero);
+}
+
+// The input block is expected behind the history in stage.buf. Every output
+// sample is the center tap plus the symmetric pairs at odd distances.
+void QDecimator::processStage(HalfBandStage &stage, int bsize, cpx *out) {
+
+	const cpx *x = stage.buf.constData();
+	const int mid = (stage.taps - 1) / 2;
+	const int pairs = (mid + 1) / 2;
+
+	for (int m = 0, t = 1; t < bsize; m++, t += 2) {
+
+		const cpx *c = x + stage.history + t - mid;
+
+		float re = stage.center * c[0].re;
+		float im = stage.center * c[0].im;
+
+		for (int k = 0; k < pairs; k++) {
+
+			int d = 2 * k + 1;
+			re += stage.coeff[k] * (c[-d].re + c[d].re);
+			im += stage.coeff[k] * (c[-d].im + c[d].im);
+		}
+
+		out[m].re = re;
+		out[m].im = im;
+	}
+
+	// keep the last taps - 1 input samples for the next block
+	cpx *buf = stage.buf.data();
+	memmove(buf, buf + bsize, stage.history * sizeof(cpx));
+}
+
+int QDecimator::ProcessDecimate(CPX &in, CPX &out, int bsize, QNco *nco) {
+
+	// the input goes behind the history of the first stage, or straight to
+	// the output without decimation
+	cpx *dst = (m_numStages == 0)
+		? out.data()
+		: m_stages[0].buf.data() + m_stages[0].history;
+
+	if (nco)
+		nco->mix(in.constData(), dst, bsize);
+	else
+		memcpy(dst, in.constData(), bsize * sizeof(cpx));
+
+	if (m_numStages == 0)
+		return bsize;
+
+	// each stage writes straight behind the history of the next one
+	for (int s = 0; s < m_numStages; s++) {
+
+		HalfBandStage &stage = m_stages[s];
+
+		cpx *dst = (s == m_numStages - 1)
+			? out.data()
+			: m_stages[s + 1].buf.data() + m_stages[s + 1].history;
+
+		processStage(stage, bsize, dst);
+		bsize /= 2;
+	}
+
+	return bsize;
+}
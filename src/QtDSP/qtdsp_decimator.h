@@ -0,0 +1,102 @@
+/**
+* @file  qtdsp_decimator.h
+* @brief decimator header file for QtDSP
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef _QTDSP_DECIMATOR_H
+#define _QTDSP_DECIMATOR_H
+
+#include "qtdsp_qComplex.h"
+#include "qtdsp_nco.h"
+
+// rate of the receiver chain behind the decimator (filter, AGC, demodulator)
+#define DECIMATOR_OUTPUT_RATE	48000
+// 384 kHz / 48 kHz = 2^3
+#define DECIMATOR_MAX_STAGES	3
+// half-band taps (4k + 3 each) of the stages fed at 8 times the output rate
+// and more, of the stage fed at 4 times and of the last stage
+#define DECIMATOR_TAPS			23
+#define DECIMATOR_MID_TAPS		39
+#define DECIMATOR_LAST_TAPS		99
+
+
+/*!
+	\class QDecimator
+	\brief Decimates the complex receiver signal from the ADC rate (48, 96,
+	192 or 384 kHz) to DECIMATOR_OUTPUT_RATE by a cascade of polyphase
+	half-band FIR stages, each decimating by 2.
+
+	Only the even half-band taps around the center are non-zero, and only
+	every second output is computed, so a stage costs about taps/4 complex
+	multiply-adds per input sample. The last stage is flat to 20 kHz
+	(< 0.001 dB) and suppresses everything from 28 kHz on by more than
+	100 dB. The stages before it must keep what they fold into +-28 kHz
+	below -100 dB as well; the transition band gets narrower towards the
+	end of the cascade, so the stage fed at 4 times the output rate needs
+	DECIMATOR_MID_TAPS, the earlier ones get by with DECIMATOR_TAPS.
+
+	An NCO passed to ProcessDecimate() mixes the input on its way into the
+	first stage, so the frequency shift costs no pass of its own.
+
+	All buffers are allocated at construction; ProcessDecimate() does not
+	allocate.
+*/
+class QDecimator {
+
+public:
+	// \a size is the largest input block size
+	QDecimator(int size = 0);
+	~QDecimator();
+
+	// sets the input sample rate; resets the filter history.
+	void	setSampleRate(int value);
+
+	int		decimation() const	{ return m_decimation; }
+	int		outputRate() const	{ return DECIMATOR_OUTPUT_RATE; }
+
+	// decimates \a bsize input samples, mixed with \a nco first if given;
+	// returns the number of output samples.
+	int		ProcessDecimate(CPX &in, CPX &out, int bsize, QNco *nco = 0);
+
+private:
+	struct HalfBandStage {
+
+		int		taps;
+		int		history;		// taps - 1 samples of the previous block
+		float	center;
+		float	coeff[DECIMATOR_LAST_TAPS / 4 + 1];	// taps at odd distance 1, 3, .. from the center
+		CPX		buf;			// history followed by the input block
+	};
+
+	HalfBandStage	m_stages[DECIMATOR_MAX_STAGES];
+
+	int		m_size;
+	int		m_decimation;
+	int		m_numStages;
+
+	void	designStage(HalfBandStage &stage, int taps);
+	void	processStage(HalfBandStage &stage, int bsize, cpx *out);
+};
+
+#endif // _QTDSP_DECIMATOR_H
@@ -27,6 +27,7 @@
  */
 
 #include "qtdsp_demodulation.h"
+#include "qtdsp_kernels.h"
 
 
 Demodulation::Demodulation(QObject *parent, int size)
@@ -35,7 +36,6 @@ Demodulation::Demodulation(QObject *parent, int size)
 	, m_mode((DSPMode) LSB)
 	, m_size(size)
 	, m_samplerate((float)set->getSampleRate())
-	, m_phase(0.0f)
 	, m_delay_real(0.0f)
 	, m_delay_imag(1.0f)
 	, m_alpha(0.3f * 500.0f * TWOPI / m_samplerate)
@@ -53,80 +53,80 @@ Demodulation::Demodulation(QObject *parent, int size)
 	, m_pll_bandwidth(500.0f)
 	, m_pll_frequency(0.0f)
 {   
-    setDemodMode((DSPMode) LSB);
+    m_magnitude.resize(m_size);
 
-    delay0.re = 0.0f;
-    delay0.im = 0.0f;
-    tmp0.re = 0.0f;
-    tmp0.im = 0.0f;
+    setDemodMode((DSPMode) LSB);
 }
 
 Demodulation::~Demodulation() {
 
 }
 
-void Demodulation::ProcessBlock(CPX &in, CPX &out, int bsize) {
-
-    Q_UNUSED(bsize)
+void Demodulation::ProcessBlock(CPX &in, float *out, int bsize) {
 
     switch(m_mode) {
 
         case (DSPMode) AM:
 
-            DoMagnitude(in, out);
+            DoMagnitude(in, out, bsize);
             break;
 
         case (DSPMode) SAM:
 
-            DoSAM(in, out);
+            DoSAM(in, out, bsize);
             break;
 
         case (DSPMode)FMN:
 
-            DoFMN(in, out);
+            DoFMN(in, out, bsize);
             break;
 
         //case (DSPMode) FMW:
 
-            //DoFMN(in, out);
+            //DoFMN(in, out, bsize);
             //break;
 
         default:
 
-            memcpy(out.data(), in.data(), sizeof(cpx) * m_size);
+            DoReal(in, out, bsize);
             break;
     }
 }
 
-inline void Demodulation::DoMagnitude(CPX &in, CPX &out) {
+bool Demodulation::passesIQ() const {
 
-    for (int i = 0; i < m_size; i++) {
+	return m_mode != AM && m_mode != SAM && m_mode != FMN;
+}
 
-		float magn = SqrMagCPX(in.at(i));
+// the modes without demodulator: the audio is the real part of the
+// filtered signal
+inline void Demodulation::DoReal(CPX &in, float *out, int size) {
 
-		out[i].re = magn;
-		out[i].im = magn;
-	}
+	const cpx *x = in.constData();
+	for (int i = 0; i < size; i++)
+		out[i] = x[i].re;
 }
 
-void Demodulation::DoSAM(CPX &in, CPX &out ) {
+inline void Demodulation::DoMagnitude(CPX &in, float *out, int size) {
 
-    float difference;
+	QtDSP::magnitude(in.constData(), out, size);
+}
+
+void Demodulation::DoSAM(CPX &in, float *out, int size) {
 
-    for (int i = 0; i < m_size; i++) {
+	float *magn = m_magnitude.data();
+	QtDSP::magnitude(in.constData(), magn, size);
 
-        tmp0.re = qCos(m_phase);
-        tmp0.im = qSin(m_phase);
+	const cpx *x = in.constData();
 
-        delay0.re = tmp0.re * in.at(i).re + tmp0.im * in.at(i).im;
-        delay0.im = -tmp0.im * in.at(i).re + tmp0.re * in.at(i).im;
+    for (int i = 0; i < size; i++) {
 
-        if ((delay0.im) == 0.0 && (delay0.re == 0.0)) {
+        cpx osc = m_vco.phasor();
 
-             delay0.re = 0.000000000001f;
-        }
+        float re = osc.re * x[i].re + osc.im * x[i].im;
+        float im = -osc.im * x[i].re + osc.re * x[i].im;
 
-        difference = sqrt(in.at(i).re * in.at(i).re + in.at(i).im * in.at(i).im) * (qAtan2(delay0.im, delay0.re));
+        float difference = magn[i] * QtDSP::fastAtan2(im, re);
 
         m_pll_frequency += m_beta * difference;
 
@@ -136,40 +136,29 @@ void Demodulation::DoSAM(CPX &in, CPX &out ) {
         if (m_pll_frequency > m_pll_hi_limit)
         	m_pll_frequency = m_pll_hi_limit;
 
-        m_phase += m_pll_frequency + m_alpha * difference;
-
-        while (m_phase >= TWOPI)
-        	m_phase -= (float)TWOPI;
-
-        while (m_phase < 0)
-            m_phase += (float)TWOPI;
+        // the accumulator wraps the phase modulo 2 pi by itself
+        m_vco.advance(m_pll_frequency + m_alpha * difference);
 
-        m_lockcurrent = 0.999 * m_lockcurrent + 0.001 * qAbs(delay0.re);
+        m_lockcurrent = 0.999f * m_lockcurrent + 0.001f * qAbs(re);
         m_lockprevious = m_lockcurrent;
-        m_dc = (0.999 * m_dc) + (0.001 * delay0.re);
+        m_dc = 0.999f * m_dc + 0.001f * re;
 
-        out[i].re = delay0.re - m_dc;
-        out[i].im = out.at(i).re;
+        out[i] = re - m_dc;
     }
 }
 
-void Demodulation::DoFMN(CPX &in, CPX &out ) {
+void Demodulation::DoFMN(CPX &in, float *out, int size) {
 
-    float difference;
+	const cpx *x = in.constData();
 
-    for (int i = 0; i < m_size; i++) {
+    for (int i = 0; i < size; i++) {
 
-        tmp0.re = qCos(m_phase);
-        tmp0.im = qSin(m_phase);
+        cpx osc = m_vco.phasor();
 
-        delay0.re = tmp0.re * in.at(i).re + tmp0.im * in.at(i).im;
-        delay0.im = -tmp0.im * in.at(i).re + tmp0.re * in.at(i).im;
+        float re = osc.re * x[i].re + osc.im * x[i].im;
+        float im = -osc.im * x[i].re + osc.re * x[i].im;
 
-        if ((delay0.im) == 0.0 && (delay0.re == 0.0)) {
-
-             delay0.re = 0.000000000001f;
-        }
-        difference = qAtan2(delay0.im, delay0.re);
+        float difference = QtDSP::fastAtan2(im, re);
 
         m_pll_frequency += m_beta * difference;
 
@@ -178,22 +167,16 @@ void Demodulation::DoFMN(CPX &in, CPX &out ) {
         if (m_pll_frequency > m_pll_hi_limit)
             m_pll_frequency = m_pll_hi_limit;
 
-        m_phase += m_pll_frequency + m_alpha * difference;
-
-        while (m_phase >= TWOPI)
-			m_phase -= (float)TWOPI;
-        while (m_phase < 0)
-			m_phase += (float)TWOPI;
+        m_vco.advance(m_pll_frequency + m_alpha * difference);
 
-        m_afc = 0.99 * m_afc + 0.01 * m_pll_frequency;
-        out[i].re = (m_pll_frequency - m_afc) * m_cvt;
-        out[i].im = out.at(i).re;
+        m_afc = 0.99f * m_afc + 0.01f * m_pll_frequency;
+        out[i] = (m_pll_frequency - m_afc) * m_cvt;
     }
 }
 
-void Demodulation::DoFMW(CPX &in, CPX &out ) {
+void Demodulation::DoFMW(CPX &in, float *out, int size) {
 
-    memcpy(out.data(), in.data(), sizeof(CPX) * m_size);
+    DoReal(in, out, size);
 }
 
 void Demodulation::setDemodMode(DSPMode mode) {
@@ -265,10 +248,13 @@ void Demodulation::setSampleRate(QObject *sender, int value) {
 
 	m_samplerate = value;
 
-	m_alpha = 0.3f * 500.0f * TWOPI / m_samplerate;
-	m_beta = m_alpha * m_alpha * 0.25f;
-
-	m_cvt = 0.45f * m_samplerate / (ONEPI * 500.0f);
 	m_twopi_over_sr = TWOPI / m_samplerate;
 	m_cvt_sr_mult = (0.45f * m_samplerate) / ONEPI;
+
+	// loop gains of the current mode, SAM ones for all others
+	m_alpha = 0.3f * 500.0f * m_twopi_over_sr;
+	m_beta = m_alpha * m_alpha * 0.25f;
+	m_cvt = m_cvt_sr_mult / 500.0f;
+
+	setDemodMode(m_mode);
 }
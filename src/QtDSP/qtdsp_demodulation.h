@@ -31,9 +31,23 @@
 
 #include <cmath>
 #include "qtdsp_qComplex.h"
+#include "qtdsp_nco.h"
 #include "../cusdr_settings.h"
 
 
+/*!
+	\class Demodulation
+	\brief AM, SAM and FM demodulators behind the AGC.
+
+	The PLL of SAM and FM runs its oscillator on the phase accumulator and
+	tables of a QNco and takes the phase error from QtDSP::fastAtan2(), so
+	no sample calls a libm function. The loop itself stays serial; the
+	envelope |in| of AM and SAM is computed for the block at once by the
+	vectorized QtDSP::magnitude() kernel.
+
+	The output is the real, mono audio signal; for the modes without a
+	demodulator (SSB, CW, DIGI, DSB) it is the real part of the input.
+*/
 class Demodulation : public QObject {
 
 	Q_OBJECT
@@ -42,9 +56,11 @@ public:
 	Demodulation(QObject *parent = 0, int size = 0);
 	~Demodulation();
 
-    void ProcessBlock(CPX &in, CPX &out, int bsize);
+    void ProcessBlock(CPX &in, float *out, int bsize);
 
     DSPMode demodMode() const;
+    // true if the mode takes the filtered I/Q as it is (no demodulator)
+    bool passesIQ() const;
 
 public slots:
     void 	setDemodMode(DSPMode mode);
@@ -53,15 +69,14 @@ public slots:
 private:
     Settings	*set;
 
-    cpx 		tmp0;
-    cpx 		delay0;
+    QNco		m_vco;
+    QVector<float>	m_magnitude;
 
     DSPMode 	m_mode;
     
     int 		m_size;
     
     float 		m_samplerate;
-    float 		m_phase;
     float 		m_delay_real;
     float 		m_delay_imag;
     float 		m_alpha;
@@ -80,10 +95,11 @@ private:
     float 		m_pll_frequency;
     
 
-    void 		DoMagnitude(CPX &in, CPX &out);
-    void 		DoSAM(CPX &in, CPX &out);
-    void 		DoFMN(CPX &in, CPX &out);
-    void 		DoFMW(CPX &in, CPX &out);
+    void 		DoReal(CPX &in, float *out, int size);
+    void 		DoMagnitude(CPX &in, float *out, int size);
+    void 		DoSAM(CPX &in, float *out, int size);
+    void 		DoFMN(CPX &in, float *out, int size);
+    void 		DoFMW(CPX &in, float *out, int size);
 };
 
 #endif	// _QTDSP_DEMODULATION_H
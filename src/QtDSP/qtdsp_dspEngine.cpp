@@ -33,59 +33,97 @@
 
 #include "qtdsp_dspEngine.h"
 
-double myLog(double x, double base) {
-	
-	return log(x) / log(base);
+static int spectrumIndex(int multiplier) {
+
+	int idx = 0;
+	while ((1 << idx) < multiplier && idx < SPECTRUM_SIZES - 1)
+		idx++;
+
+	return idx;
+}
+
+
+SpectrumPlanThread::SpectrumPlanThread()
+	: QThread()
+	, m_target(0)
+	, m_size(0)
+	, m_result(0)
+{
+}
+
+SpectrumPlanThread::~SpectrumPlanThread() {
+
+	wait();
+	delete m_result.fetchAndStoreAcquire(0);
+}
+
+// the new spectrum is handed to the calling thread
+void SpectrumPlanThread::plan(int size) {
+
+	// the previous run may still be returning after publishing its result
+	wait();
+
+	m_target = QThread::currentThread();
+	m_size = size;
+	start(QThread::LowPriority);
+}
+
+PowerSpectrum *SpectrumPlanThread::takeResult() {
+
+	return m_result.fetchAndStoreAcquire(0);
 }
 
+void SpectrumPlanThread::run() {
+
+	QElapsedTimer timer;
+	timer.start();
+
+	PowerSpectrum *spectrum = new PowerSpectrum(0, m_size);
+	spectrum->moveToThread(m_target);
+
+	DSP_ENGINE_DEBUG << "spectrum size " << m_size << " (" << 2 * m_size << " point FFT) planned in " << timer.elapsed() << " ms";
+	m_result.storeRelease(spectrum);
+}
+
+
 
 QDSPEngine::QDSPEngine(QObject *parent, int rx, int size)
 	: QObject(parent)
 	, set(Settings::instance())
 	, m_qtdspOn(false)
+	, m_spectrumAveraging(set->getSpectrumAveraging(rx))
+	, m_binaural(set->getBinaural(rx))
+	, m_averagingMode(set->getSpectrumAveragingMode(rx))
 	, m_rx(rx)
 	, m_size(size)
 	, m_samplerate(set->getSampleRate())
 	, m_fftMultiplier(1)
+	, m_spectrumOverlap(set->getSpectrumOverlap(rx))
+	, m_averagingCnt(set->getSpectrumAveragingCnt(rx))
+	, m_audioChannels(1)
 	, m_volume(0.0f)
 {
 	qRegisterMetaType<QVector<cpx> >();
 	qRegisterMetaType<CPX>();
 
 	fft    		= new QFFT(m_size); // m_size = 1024
+	nco			= new QNco();
+	decimator	= new QDecimator(m_size);
 	filter 		= new QFilter(this, m_size, 2, 12);//8);
 	wpagc  		= new QWPAGC(this, m_size);
-	//spectrum 	= new PowerSpectrum(this, m_size*2);
-
-	/*QString str = "Initializing DSP engine for rx %1: 8k FFT ...please wait";
-	set->setSystemMessage(str.arg(m_rx), 0);
-		
-	if (m_rx == 0) {
-		
-		spectrum2 	= new PowerSpectrum(this, m_size*4);
-
-		str = "Initializing DSP engine for rx %1: 16k FFT ...please wait";
-		set->setSystemMessage(str.arg(m_rx), 0);
-		spectrum4 	= new PowerSpectrum(this, m_size*8);
 
-		str = "Initializing DSP engine for rx %1: 32k FFT ...please wait";
-		set->setSystemMessage(str.arg(m_rx), 0);
-		spectrum8 	= new PowerSpectrum(this, m_size*16);
+	// the spectrum sizes are built on demand, see updateSpectra()
+	for (int i = 0; i < SPECTRUM_SIZES; i++) {
 
-		str = "Initializing DSP engine for rx %1: 64k FFT ...please wait";
-		set->setSystemMessage(str.arg(m_rx), 0);
-		spectrum16 	= new PowerSpectrum(this, m_size*32);
-	}*/
-
-	int factor = 2;
-	
-	while (factor <= 128) {
-
-		PowerSpectrum* spec = new PowerSpectrum(this, m_size*factor);
-		powerSpectraList << spec;
-
-		factor *= 2;
+		m_spectra[i] = 0;
+		m_spectrumUsed[i] = 0;
 	}
+	m_planThread = new SpectrumPlanThread();
+	m_spectrumClock.start();
+	m_evictionTime = 0;
+	m_servingSpectrum = -1;
+	m_requestedSpectrum = spectrumIndex(set->getFFTMultiplicator(m_rx));
+	m_planningSpectrum = -1;
 
 	m_spectrumSize = m_size*4;
 
@@ -98,14 +136,12 @@ QDSPEngine::QDSPEngine(QObject *parent, int rx, int size)
 
 	wpagc->setReceiver(m_rx);
 
+	setupDecimation();
+
+    InitCPX(decCPX, m_size, 0.0f);
     InitCPX(tmp1CPX, m_size, 0.0f);
     InitCPX(tmp2CPX, m_size, 0.0f);
 
-	osc1cpx.re = 1.0f;
-	osc1cpx.im = 0.0f;
-
-	m_NcoInc = 0.0;
-	m_NcoTime = 0.0;
 	m_NcoFreq = 0.0;
 	m_CWoffset = 0.0;
 
@@ -120,6 +156,7 @@ QDSPEngine::QDSPEngine(QObject *parent, int rx, int size)
 
 QDSPEngine::~QDSPEngine() {
 
+	decCPX.clear();
 	tmp1CPX.clear();
 	tmp2CPX.clear();
 
@@ -129,6 +166,12 @@ QDSPEngine::~QDSPEngine() {
 	if (fft)
 		delete fft;
 
+	if (nco)
+		delete nco;
+
+	if (decimator)
+		delete decimator;
+
 	if (filter)
 		delete filter;
 
@@ -138,9 +181,13 @@ QDSPEngine::~QDSPEngine() {
 	//if (spectrum)
 	//	delete spectrum;
 
-	if (!powerSpectraList.empty()) {
+	if (m_planThread)
+		delete m_planThread;
 
-		powerSpectraList.clear();
+	for (int i = 0; i < SPECTRUM_SIZES; i++) {
+
+		if (m_spectra[i])
+			delete m_spectra[i];
 	}
 
 	if (signalmeter)
@@ -164,6 +211,36 @@ void QDSPEngine::setupConnections() {
 		this,
 		SLOT(setSampleSize(int, int)));
 
+	CHECKED_CONNECT(
+		set,
+		SIGNAL(spectrumOverlapChanged(QObject *, int, int)),
+		this,
+		SLOT(setSpectrumOverlap(QObject *, int, int)));
+
+	CHECKED_CONNECT(
+		set,
+		SIGNAL(spectrumAveragingChanged(QObject *, int, bool)),
+		this,
+		SLOT(setSpectrumAveraging(QObject *, int, bool)));
+
+	CHECKED_CONNECT(
+		set,
+		SIGNAL(spectrumAveragingCntChanged(QObject *, int, int)),
+		this,
+		SLOT(setSpectrumAveragingCnt(QObject *, int, int)));
+
+	CHECKED_CONNECT(
+		set,
+		SIGNAL(spectrumAveragingModeChanged(QObject *, int, SpectrumAveragingMode)),
+		this,
+		SLOT(setSpectrumAveragingMode(QObject *, int, SpectrumAveragingMode)));
+
+	CHECKED_CONNECT(
+		set,
+		SIGNAL(binauralChanged(QObject *, int, bool)),
+		this,
+		SLOT(setBinaural(QObject *, int, bool)));
+
 	CHECKED_CONNECT(
 		wpagc,
 		SIGNAL(agcMaximumGainChanged(qreal)),
@@ -195,65 +272,125 @@ void QDSPEngine::setupConnections() {
 		SLOT(setAGCLineValues(QObject *, int, qreal, qreal)));
 }
 
-void QDSPEngine::processDSP(CPX &in, CPX &out, int size) {
+int QDSPEngine::processDSP(CPX &in, qVectorFloat &out, int size) {
 
 	m_mutex.lock();
 
-	/*switch (m_fftMultiplcator) {
+	updateSpectra();
 
-		case 1:
-			spectrum->ProcessSpectrum(in, size*2, 1);
-			break;
+	if (m_servingSpectrum >= 0)
+		m_spectra[m_servingSpectrum]->ProcessSpectrum(in, size);
 
-		case 2:
-			spectrum2->ProcessSpectrum(in, size*4, 3);
-			break;
+	// the spectrum above sees the full rate, filter, AGC and demodulator
+	// run on the block shifted by the NCO and decimated to
+	// DECIMATOR_OUTPUT_RATE.
+	int bsize = decimator->ProcessDecimate(in, decCPX, size, m_NcoFreq != 0 ? nco : 0);
 
-		case 4:
-			spectrum4->ProcessSpectrum(in, size*8, 7);
-			break;
+	filter->ProcessFilter(decCPX, tmp1CPX, bsize);
+	signalmeter->ProcessBlock(tmp1CPX, bsize);
+	wpagc->ProcessAGC(tmp1CPX, tmp2CPX, bsize);
 
-		case 8:
-			spectrum8->ProcessSpectrum(in, size*16, 15);
-			break;
+	// the audio is real from here on; only binaural output of the modes
+	// without demodulator carries I and Q to the packing step
+	float *audio = out.data();
 
-		case 16:
-			spectrum16->ProcessSpectrum(in, size*32, 31);
-			break;
-	}*/
+	if (m_binaural && demod->passesIQ()) {
 
-	int idx = (int)(myLog(m_fftMultiplier, 2));
-	powerSpectraList.at(idx)->ProcessSpectrum(in, size * m_fftMultiplier * 2, m_fftMultiplier*2-1);
+		const cpx *x = tmp2CPX.constData();
+		for (int i = 0; i < bsize; i++) {
 
-	if (m_NcoFreq != 0)
-		ProcessFrequencyShift(in, in, size);
+			audio[2 * i]     = x[i].re * m_volume;
+			audio[2 * i + 1] = x[i].im * m_volume;
+		}
+		m_audioChannels = 2;
+	}
+	else {
 
-	filter->ProcessFilter(in, tmp1CPX, size);
-	signalmeter->ProcessBlock(tmp1CPX, size);
-	wpagc->ProcessAGC(tmp1CPX, tmp2CPX, size);
-	demod->ProcessBlock(tmp2CPX, out, size);
-	
-	//memcpy(out.data(), in.data(), size * sizeof(cpx));
-	//out = in;
+		demod->ProcessBlock(tmp2CPX, audio, bsize);
 
-	for (int i = 0; i < size; i++) {
+		for (int i = 0; i < bsize; i++)
+			audio[i] *= m_volume;
 
-		out[i] = ScaleCPX(out.at(i), m_volume);
+		m_audioChannels = 1;
 	}
 	m_mutex.unlock();
+
+	return bsize;
 }
 
+// returns 0 as long as no spectrum size is ready and between two spectra
+// of the hop size; a new multiplier takes effect as soon as its spectrum
+// has been built.
 int	QDSPEngine::getSpectrum(qVectorFloat &buffer, int mult) {
 
 	m_fftMultiplier = mult;
-	int idx = (int)(myLog(m_fftMultiplier, 2));
-	
-	return powerSpectraList.at(idx)->spectrumResult(buffer, m_size * m_fftMultiplier * 2 - 2048);
+	m_requestedSpectrum = spectrumIndex(mult);
+
+	if (m_servingSpectrum < 0) return 0;
+
+	int serving = 1 << m_servingSpectrum;
+	return m_spectra[m_servingSpectrum]->spectrumResult(buffer, m_size * serving * 2 - 2048);
 }
 
-float QDSPEngine::getSMeterInstValue() {
+// called from processDSP: switches to the requested spectrum size once it
+// exists, has the plan thread build it otherwise, and deletes sizes that
+// have not been used for SPECTRUM_IDLE_TIME.
+void QDSPEngine::updateSpectra() {
 
-	return signalmeter->getInstFValue();
+	qint64 now = m_spectrumClock.elapsed();
+
+	if (m_planningSpectrum >= 0) {
+
+		PowerSpectrum *spectrum = m_planThread->takeResult();
+		if (spectrum) {
+
+			m_spectra[m_planningSpectrum] = spectrum;
+			m_spectrumUsed[m_planningSpectrum] = now;
+			m_planningSpectrum = -1;
+		}
+	}
+
+	int req = m_requestedSpectrum;
+	if (m_spectra[req]) {
+
+		// a size kept from before holds samples from the time it last served
+		if (m_servingSpectrum != req)
+			m_spectra[req]->clearHistory();
+
+		m_servingSpectrum = req;
+	}
+	else if (m_planningSpectrum < 0) {
+
+		m_planningSpectrum = req;
+		m_planThread->plan(m_size * (2 << req));
+	}
+
+	if (m_servingSpectrum >= 0) {
+
+		m_spectrumUsed[m_servingSpectrum] = now;
+		m_spectra[m_servingSpectrum]->setOverlap(m_spectrumOverlap);
+		m_spectra[m_servingSpectrum]->setAveraging(m_spectrumAveraging, m_averagingMode, m_averagingCnt);
+	}
+
+	if (now - m_evictionTime < 1000) return;
+	m_evictionTime = now;
+
+	for (int i = 0; i < SPECTRUM_SIZES; i++) {
+
+		if (m_spectra[i] && i != m_servingSpectrum && now - m_spectrumUsed[i] > SPECTRUM_IDLE_TIME) {
+
+			// same size as handed to the plan thread
+			int size = m_size * (2 << i);
+			DSP_ENGINE_DEBUG << "rx " << m_rx << ": release idle spectrum size " << size << " (" << 2 * size << " point FFT)";
+			delete m_spectra[i];
+			m_spectra[i] = 0;
+		}
+	}
+}
+
+void QDSPEngine::getSMeterReading(TSMeterReading &reading) const {
+
+	signalmeter->getReading(reading);
 }
 
 void QDSPEngine::setVolume(float value) {
@@ -263,6 +400,18 @@ void QDSPEngine::setVolume(float value) {
 	m_volume = value;
 }
 
+void QDSPEngine::setBinaural(QObject *sender, int rx, bool value) {
+
+	Q_UNUSED(sender)
+
+	if (m_rx == rx) {
+
+		m_mutex.lock();
+		m_binaural = value;
+		m_mutex.unlock();
+	}
+}
+
 void QDSPEngine::setQtDSPStatus(bool value) { 
 	
 	m_qtdspOn = value; 
@@ -332,28 +481,38 @@ void QDSPEngine::setSampleRate(QObject *sender, int value) {
 
 	//DSP_ENGINE_DEBUG << "set sample rate to " << m_samplerate;
 	//setNCOFrequency(m_rx, m_rxData.vfoFrequency - m_rxData.ctrFrequency);
-	m_NcoInc = TWOPI * m_NcoFreq/m_samplerate;
-	m_OscCos = qCos(m_NcoInc);
-	m_OscSin = qSin(m_NcoInc);
+	nco->setFrequency(m_NcoFreq, m_samplerate);
 
-	filter->setSampleRate(this, m_samplerate);
-	demod->setSampleRate(this, m_samplerate);
-	wpagc->setSampleRate(this, m_samplerate);
+	setupDecimation();
 
 	m_mutex.unlock();
 
 }
 
+// the receiver chain behind the decimator always runs at the output rate
+// of the decimator, the filter block shrinks by the decimation factor.
+void QDSPEngine::setupDecimation() {
+
+	decimator->setSampleRate(m_samplerate);
+
+	int rate = m_samplerate / decimator->decimation();
+
+	filter->setBlockSize(m_size / decimator->decimation());
+	filter->setSampleRate(this, rate);
+	demod->setSampleRate(this, rate);
+	wpagc->setSampleRate(this, rate);
+	signalmeter->setSampleRate(rate);
+}
+
 void QDSPEngine::setNCOFrequency(int rx, long ncoFreq) {
 
 	if (m_rx != rx) return;
 
 	qreal tmp = ncoFreq + m_CWoffset;
 
+	// the NCO keeps its phase, a retune does not click
 	m_NcoFreq = tmp;
-	m_NcoInc = TWOPI * m_NcoFreq/m_samplerate;
-	m_OscCos = qCos(m_NcoInc);
-	m_OscSin = qSin(m_NcoInc);
+	nco->setFrequency(m_NcoFreq, m_samplerate);
 	
 	//DSP_ENGINE_DEBUG << "NCO: " << m_NcoFreq;
 }
@@ -368,29 +527,51 @@ void QDSPEngine::setSampleSize(int rx, int size) {
 	}
 }
 
-void QDSPEngine::ProcessFrequencyShift(CPX &in, CPX &out, int size) {
+void QDSPEngine::setSpectrumOverlap(QObject *sender, int rx, int value) {
+
+	Q_UNUSED(sender)
+
+	if (m_rx == rx) {
+
+		m_mutex.lock();
+		m_spectrumOverlap = value;
+		m_mutex.unlock();
+	}
+}
+
+void QDSPEngine::setSpectrumAveraging(QObject *sender, int rx, bool value) {
+
+	Q_UNUSED(sender)
+
+	if (m_rx == rx) {
+
+		m_mutex.lock();
+		m_spectrumAveraging = value;
+		m_mutex.unlock();
+	}
+}
 
-	cpx tmp;
-	CPX Osc;
+void QDSPEngine::setSpectrumAveragingCnt(QObject *sender, int rx, int value) {
 
-	Osc.resize(size);
+	Q_UNUSED(sender)
 
-	for (int i = 0; i < size; i++) {
+	if (m_rx == rx) {
 
-		tmp = in.at(i);
+		m_mutex.lock();
+		m_averagingCnt = value;
+		m_mutex.unlock();
+	}
+}
 
-		qreal OscGn;
-		Osc[i].re = osc1cpx.re * m_OscCos - osc1cpx.im * m_OscSin;
-		Osc[i].im = osc1cpx.im * m_OscCos + osc1cpx.re * m_OscSin;
+void QDSPEngine::setSpectrumAveragingMode(QObject *sender, int rx, SpectrumAveragingMode mode) {
 
-		OscGn = 1.95 - (osc1cpx.re * osc1cpx.re + osc1cpx.im * osc1cpx.im);
+	Q_UNUSED(sender)
 
-		osc1cpx.re = OscGn * Osc.at(i).re;
-		osc1cpx.im = OscGn * Osc.at(i).im;
+	if (m_rx == rx) {
 
-		//Cpx multiply by shift frequency
-		out[i].re = ((tmp.re * Osc.at(i).re) - (tmp.im * Osc.at(i).im));
-		out[i].im = ((tmp.re * Osc.at(i).im) + (tmp.im * Osc.at(i).re));
+		m_mutex.lock();
+		m_averagingMode = mode;
+		m_mutex.unlock();
 	}
 }
 
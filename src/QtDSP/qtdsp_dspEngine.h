@@ -31,6 +31,11 @@
 
 #define AGCOFFSET -18.0//-63.0
 
+// panadapter FFT multipliers 1 .. 64 (FFT sizes 2 * 1024 .. 128 * 1024)
+#define SPECTRUM_SIZES		7
+// a spectrum size not used for this time (ms) is deleted
+#define SPECTRUM_IDLE_TIME	30000
+
 //#include <QObject>
 //#include <QThread>
 //#include <QMetaType>
@@ -43,6 +48,8 @@
 #include "../cusdr_settings.h"
 #include "qtdsp_qComplex.h"
 #include "qtdsp_filter.h"
+#include "qtdsp_nco.h"
+#include "qtdsp_decimator.h"
 #include "qtdsp_fft.h"
 #include "qtdsp_wpagc.h"
 #include "qtdsp_powerSpectrum.h"
@@ -58,6 +65,32 @@
 #endif
 
 
+/*!
+	\brief Builds one PowerSpectrum (window, buffers and FFTW plans) off the
+	DSP thread; the DSP thread picks it up with takeResult() when done.
+*/
+class SpectrumPlanThread : public QThread {
+
+public:
+	SpectrumPlanThread();
+	~SpectrumPlanThread();
+
+	void	plan(int size);
+
+	// the finished spectrum, or 0 while planning
+	PowerSpectrum*	takeResult();
+
+protected:
+	void	run();
+
+private:
+	QThread		*m_target;
+	int			m_size;
+
+	QAtomicPointer<PowerSpectrum>	m_result;
+};
+
+
 class QDSPEngine : public QObject {
 
 	Q_OBJECT
@@ -67,23 +100,21 @@ public:
 	~QDSPEngine();
 
 	QFFT*				fft;
+	QNco*				nco;
+	QDecimator*			decimator;
 	QFilter*			filter;
 	QWPAGC*				wpagc;
-	PowerSpectrum*		spectrum;
-	PowerSpectrum*		spectrum2;
-	PowerSpectrum*		spectrum4;
-	PowerSpectrum*		spectrum8;
-	PowerSpectrum*		spectrum16;
-	
 	SignalMeter*		signalmeter;
 	Demodulation*		demod;
 
-	QList<PowerSpectrum* >	powerSpectraList;
-
-	void	processDSP(CPX &in, CPX &out,  int size);
+	// returns the number of output samples at the decimated rate; \a out
+	// gets the mono audio, or left and right interleaved if audioChannels()
+	// is 2 (binaural).
+	int		processDSP(CPX &in, qVectorFloat &out,  int size);
+	int		audioChannels() const	{ return m_audioChannels; }
 
 	int		getSpectrum(qVectorFloat &buffer, int mult);
-	float	getSMeterInstValue();
+	void	getSMeterReading(TSMeterReading &reading) const;
 
 public slots:
 	bool getQtDSPStatus() { return m_qtdspOn; }
@@ -91,8 +122,14 @@ public slots:
 	void setNCOFrequency(int rx, long value);
 	void setSampleRate(QObject *sender, int value);
 	void setSampleSize(int rx, int size);
+	void setSpectrumOverlap(QObject *sender, int rx, int value);
+	void setSpectrumAveraging(QObject *sender, int rx, bool value);
+	void setSpectrumAveragingCnt(QObject *sender, int rx, int value);
+	void setSpectrumAveragingMode(QObject *sender, int rx, SpectrumAveragingMode mode);
 	void setQtDSPStatus(bool value);
 	void setVolume(float value);
+	// I and Q on the left and right channel for the modes without demodulator
+	void setBinaural(QObject *sender, int rx, bool value);
 	void setDSPMode(DSPMode mode);
 	void setAGCMode(AGCMode mode);
 
@@ -101,30 +138,45 @@ private:
 	TReceiver	m_rxData;
 	AGCMode		m_agcMode;
 
+	CPX		decCPX;
 	CPX		tmp1CPX;
 	CPX		tmp2CPX;
-	cpx		osc1cpx;
 
 	QMutex	m_mutex;
 
+	// spectrum sizes are built on demand by m_planThread; m_servingSpectrum
+	// keeps serving until the requested size is ready.
+	PowerSpectrum*		m_spectra[SPECTRUM_SIZES];
+	qint64				m_spectrumUsed[SPECTRUM_SIZES];
+	SpectrumPlanThread*	m_planThread;
+	QElapsedTimer		m_spectrumClock;
+	qint64				m_evictionTime;
+	int					m_servingSpectrum;
+	int					m_requestedSpectrum;
+	int					m_planningSpectrum;
+
 	bool	m_qtdspOn;
+	bool	m_spectrumAveraging;
+	bool	m_binaural;
+
+	SpectrumAveragingMode	m_averagingMode;
 
 	int		m_rx;
 	int		m_size;
 	int		m_spectrumSize;
 	int		m_samplerate;
 	int		m_fftMultiplier;
+	int		m_spectrumOverlap;
+	int		m_averagingCnt;
+	int		m_audioChannels;
 
 	float	m_volume;
 	qreal	m_NcoFreq;
-	qreal	m_NcoInc;
-	qreal	m_NcoTime;
 	qreal	m_CWoffset;
-	qreal	m_OscCos;
-	qreal	m_OscSin;
 	//qreal	m_calOffset;
 
-	void	ProcessFrequencyShift(CPX &in, CPX &out, int size);
+	void	updateSpectra();
+	void	setupDecimation();
 	void	setupConnections();
 
 private slots:
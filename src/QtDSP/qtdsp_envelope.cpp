@@ -0,0 +1,70 @@
+/**
+* @file  qtdsp_envelope.cpp
+* @brief spectrum envelope class for QtDSP
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "qtdsp_envelope.h"
+#include "qtdsp_kernels.h"
+
+
+QEnvelope::QEnvelope()
+	: m_offset(0)
+	, m_bins(0)
+	, m_pixels(0)
+{
+}
+
+QEnvelope::~QEnvelope() {
+
+	m_edges.clear();
+}
+
+bool QEnvelope::setup(int offset, int bins, int pixels) {
+
+	if (pixels < 0) pixels = 0;
+	if (bins < pixels) bins = pixels;
+
+	if (offset == m_offset && bins == m_bins && pixels == m_pixels)
+		return false;
+
+	m_offset = offset;
+	m_bins = bins;
+	m_pixels = pixels;
+
+	m_edges.resize(pixels + 1);
+
+	// bins >= pixels, so every pixel gets at least one bin
+	int *edges = m_edges.data();
+	for (int p = 0; p <= pixels; p++)
+		edges[p] = offset + (int)((qint64) p * bins / qMax(1, pixels));
+
+	return true;
+}
+
+void QEnvelope::process(const float *in, float *min, float *max, float *mean) const {
+
+	if (m_pixels == 0) return;
+
+	QtDSP::envelope(in, m_edges.constData(), m_pixels, min, max, mean);
+}
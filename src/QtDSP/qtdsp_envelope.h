@@ -0,0 +1,71 @@
+/**
+* @file  qtdsp_envelope.h
+* @brief spectrum envelope header file for QtDSP
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef _QTDSP_ENVELOPE_H
+#define _QTDSP_ENVELOPE_H
+
+#include <QVector>
+
+
+/*!
+	\class QEnvelope
+	\brief Reduces a block of spectrum bins to a smaller number of display
+	pixels, giving the minimum, maximum and mean of the bins behind each pixel.
+
+	Pixel p covers the bins offset + [p * bins / pixels, (p + 1) * bins / pixels),
+	at least one. The bin boundaries are kept until setup() is called with a
+	different offset, bin or pixel count, i.e. on a zoom, pan or resize of the
+	display. process() does not allocate.
+*/
+class QEnvelope {
+
+public:
+	QEnvelope();
+	~QEnvelope();
+
+	// returns true if the bin to pixel map had to be rebuilt.
+	bool	setup(int offset, int bins, int pixels);
+
+	int		pixels() const	{ return m_pixels; }
+	int		offset() const	{ return m_offset; }
+	int		bins() const	{ return m_bins; }
+
+	// first bin of pixel \a p relative to the start of the input; edge(pixels()) ends the last one
+	int		edge(int p) const	{ return m_edges.at(p); }
+
+	// min, max and mean hold pixels() values each; \a in the whole block
+	// the offset refers to.
+	void	process(const float *in, float *min, float *max, float *mean) const;
+
+private:
+	QVector<int>	m_edges;
+
+	int		m_offset;
+	int		m_bins;
+	int		m_pixels;
+};
+
+#endif // _QTDSP_ENVELOPE_H
@@ -26,10 +26,124 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
 
+#define LOG_QFFT
+
 #include "qtdsp_fft.h"
+#include "qtdsp_simd.h"
+#include "qtdsp_kernels.h"
+#include "../cusdr_settings.h"
+
 #include <string.h>
+#include <stdlib.h>
 
 #include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+
+QMutex	QFFTPlanner::m_mutex;
+QString	QFFTPlanner::m_wisdomFile;
+qint64	QFFTPlanner::m_planningTime = 0;
+
+bool QFFTPlanner::loadWisdom(const QString &directory) {
+
+	QMutexLocker locker(&m_mutex);
+
+	// wisdom is only valid for the CPU and the FFTW build it was made with
+	QByteArray key;
+	key.append(QtDSP::cpuModelName());
+	key.append('|');
+	key.append(fftwf_version);
+	key.append('|');
+	key.append(fftwf_cc);
+
+	QString hash = QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex().left(12);
+	m_wisdomFile = QDir(directory).filePath("fftwf_wisdom_" + hash);
+
+	QFFT_DEBUG << "wisdom key: " << key.constData();
+
+	QFile file(m_wisdomFile);
+	if (!file.open(QIODevice::ReadOnly)) {
+
+		QFFT_DEBUG << "no wisdom in " << qPrintable(m_wisdomFile) << " - sizes are planned on first use.";
+		return false;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+
+	QByteArray wisdom = file.readAll();
+	if (!fftwf_import_wisdom_from_string(wisdom.constData())) {
+
+		QFFT_DEBUG << "could not import wisdom from " << qPrintable(m_wisdomFile);
+		return false;
+	}
+
+	QFFT_DEBUG << "imported wisdom from " << qPrintable(m_wisdomFile) << " in " << timer.elapsed() << " ms.";
+	return true;
+}
+
+QString QFFTPlanner::wisdomFilename() {
+
+	QMutexLocker locker(&m_mutex);
+	return m_wisdomFile;
+}
+
+fftwf_plan QFFTPlanner::planDft1d(int size, fftwf_complex *in, fftwf_complex *out, int sign, unsigned flags) {
+
+	QMutexLocker locker(&m_mutex);
+
+	// a size in the wisdom is planned without measuring
+	fftwf_plan plan = fftwf_plan_dft_1d(size, in, out, sign, flags | FFTW_WISDOM_ONLY);
+	if (plan) return plan;
+
+	QElapsedTimer timer;
+	timer.start();
+
+	plan = fftwf_plan_dft_1d(size, in, out, sign, flags);
+
+	qint64 elapsed = timer.elapsed();
+	m_planningTime += elapsed;
+
+	QFFT_DEBUG << "planned FFT size " << size << (sign == FFTW_FORWARD ? " forward" : " backward") << " in " << elapsed << " ms.";
+
+	saveWisdom();
+	return plan;
+}
+
+void QFFTPlanner::destroyPlan(fftwf_plan plan) {
+
+	QMutexLocker locker(&m_mutex);
+	fftwf_destroy_plan(plan);
+}
+
+qint64 QFFTPlanner::planningTime() {
+
+	QMutexLocker locker(&m_mutex);
+	return m_planningTime;
+}
+
+// called with m_mutex held
+void QFFTPlanner::saveWisdom() {
+
+	if (m_wisdomFile.isEmpty()) return;
+
+	char *wisdom = fftwf_export_wisdom_to_string();
+	if (!wisdom) return;
+
+	// written to a temporary file first, a crash never leaves half a file
+	QSaveFile file(m_wisdomFile);
+	if (file.open(QIODevice::WriteOnly)) {
+
+		file.write(wisdom, strlen(wisdom));
+		if (!file.commit())
+			QFFT_DEBUG << "could not write wisdom to " << qPrintable(m_wisdomFile);
+	}
+	free(wisdom);
+}
+
 
 QFFT::QFFT(int size)
 	: QObject()
@@ -37,8 +151,9 @@ QFFT::QFFT(int size)
 	, half_sz(size/2)
 {
     cpxbuf = (fftwf_complex *) fftwf_malloc(sizeof(fftwf_complex) * m_size);
-    plan_fwd = fftwf_plan_dft_1d(m_size , cpxbuf, cpxbuf, FFTW_FORWARD, FFTW_MEASURE);
-    plan_rev = fftwf_plan_dft_1d(m_size , cpxbuf, cpxbuf, FFTW_BACKWARD, FFTW_MEASURE);
+
+    plan_fwd = QFFTPlanner::planDft1d(m_size, cpxbuf, cpxbuf, FFTW_FORWARD, FFTW_MEASURE);
+    plan_rev = QFFTPlanner::planDft1d(m_size, cpxbuf, cpxbuf, FFTW_BACKWARD, FFTW_MEASURE);
 
     memset(cpxbuf, 0, m_size * sizeof(cpxbuf));
 
@@ -47,8 +162,8 @@ QFFT::QFFT(int size)
 
 QFFT::~QFFT() {
 	
-	fftwf_destroy_plan(plan_fwd);
-	fftwf_destroy_plan(plan_rev);
+	QFFTPlanner::destroyPlan(plan_fwd);
+	QFFTPlanner::destroyPlan(plan_rev);
 	
 	if (cpxbuf) 
 		fftwf_free(cpxbuf);
@@ -56,6 +171,60 @@ QFFT::~QFFT() {
 	buf.clear();
 }
 
+// The plans are in-place plans on cpxbuf (fftwf_malloc); FFTW's new-array
+// execute accepts any other in-place array of at least that alignment.
+void QFFT::ForwardInPlace(cpx *data) {
+
+	if (isAligned(data)) {
+
+		fftwf_execute_dft(plan_fwd, (fftwf_complex *) data, (fftwf_complex *) data);
+		return;
+	}
+
+	memcpy(cpxbuf, data, sizeof(cpx) * m_size);
+	fftwf_execute(plan_fwd);
+	memcpy(data, cpxbuf, sizeof(cpx) * m_size);
+}
+
+void QFFT::InverseInPlace(cpx *data) {
+
+	if (isAligned(data)) {
+
+		fftwf_execute_dft(plan_rev, (fftwf_complex *) data, (fftwf_complex *) data);
+		return;
+	}
+
+	memcpy(cpxbuf, data, sizeof(cpx) * m_size);
+	fftwf_execute(plan_rev);
+	memcpy(data, cpxbuf, sizeof(cpx) * m_size);
+}
+
+void QFFT::WindowedPower(const cpx *in, const float *window, int length, float *power, int start) {
+
+	cpx *x = (cpx *) cpxbuf;
+
+	// the window pass replaces the copy into the plan's buffer and unwraps
+	// the ring: in[start] .. in[length - 1], then in[0] .. in[start - 1]
+	const cpx *src = in + start;
+	for (int i = 0; i < length - start; i++) {
+
+		x[i].re = src[i].re * window[i];
+		x[i].im = src[i].im * window[i];
+	}
+
+	for (int i = length - start; i < length; i++) {
+
+		x[i].re = in[i - length + start].re * window[i];
+		x[i].im = in[i - length + start].im * window[i];
+	}
+	memset(x + length, 0, sizeof(cpx) * (m_size - length));
+
+	fftwf_execute(plan_fwd);
+
+	// the dB conversion is left to the caller, after any averaging
+	QtDSP::magnitudeSquared(x, power, m_size);
+}
+
 void QFFT::DoFFTWForward(CPX &in, CPX &out, int size) {
 
 	memcpy(cpxbuf, in.data(), sizeof(cpx) * size);
@@ -78,14 +247,8 @@ void QFFT::DoFFTWMagnForward(CPX &in, int size, float baseline, float correction
 
     fftwf_execute(plan_fwd);
 
-    for (int i = 0, j = size-1; i < size; i++, j--) {
-
-		*(buf.data()+j) = *(cpx *)(cpxbuf+i);
-    }
-
-    for (int i = 0, j = half_sz; i < half_sz; i++, j++) {
-
-        *(fbr+i) = 10.0 * log10(MagCPX(*(buf.data()+j)) + baseline) + correction;
-        *(fbr+j) = 10.0 * log10(MagCPX(*(buf.data()+i)) + baseline) + correction;
-    }
+	// same order as the reversed spectrum with swapped halves
+	cpx *x = (cpx *) cpxbuf;
+	QtDSP::magnitudeDbReversed(x, fbr, half_sz, baseline, correction);
+	QtDSP::magnitudeDbReversed(x + half_sz, fbr + half_sz, half_sz, baseline, correction);
 }
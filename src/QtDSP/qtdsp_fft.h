@@ -30,11 +30,51 @@
 #define	_QTDSP_FFT_H
 
 #include <QObject>
+#include <QMutex>
+#include <QString>
 
 #include <cmath>
 #include "fftw3.h"
 #include "qtdsp_qComplex.h"
 
+#ifdef LOG_QFFT
+#   define QFFT_DEBUG qDebug().nospace() << "QFFT::\t"
+#else
+#   define QFFT_DEBUG nullDebug()
+#endif
+
+
+/*!
+	\class QFFTPlanner
+	\brief The one FFTW planner of the application.
+
+	FFTW's planner is not thread safe, so every plan is created and destroyed
+	here under one lock. The planner wisdom is kept in the settings directory
+	in a file keyed by CPU model and FFTW build, so that wisdom from another
+	machine or FFTW version is never imported. Each size that is not in the
+	wisdom yet is planned once and the wisdom file is rewritten right away.
+*/
+class QFFTPlanner {
+
+public:
+	// must be called before the first QFFT is created
+	static bool		loadWisdom(const QString &directory);
+	static QString	wisdomFilename();
+
+	static fftwf_plan	planDft1d(int size, fftwf_complex *in, fftwf_complex *out, int sign, unsigned flags);
+	static void			destroyPlan(fftwf_plan plan);
+
+	// total time (ms) spent planning sizes that were not in the wisdom
+	static qint64	planningTime();
+
+private:
+	static QMutex	m_mutex;
+	static QString	m_wisdomFile;
+	static qint64	m_planningTime;
+
+	static void		saveWisdom();
+};
+
 
 class QFFT : public QObject {
 
@@ -44,6 +84,19 @@ public:
     QFFT(int size = 0);
     ~QFFT();
 
+	// in-place transforms of m_size samples in a caller owned array; a
+	// CPX_ALIGNMENT aligned array (CPXBuffer) is transformed without copies.
+	void	ForwardInPlace(cpx *data);
+	void	InverseInPlace(cpx *data);
+
+	// fused window -> FFT -> |X|^2: \a length samples of \a in are windowed
+	// and zero padded to the FFT size, \a power gets m_size values in FFT
+	// order. \a in may be a ring buffer of \a length samples with the oldest
+	// one at \a start.
+	void	WindowedPower(const cpx *in, const float *window, int length, float *power, int start = 0);
+
+	static bool	isAligned(const void *p)	{ return ((quintptr) p & (CPX_ALIGNMENT - 1)) == 0; }
+
 public slots:
     void DoFFTWForward(CPX &in, CPX &out, int size);
 	void DoFFTWInverse(CPX &in, CPX &out, int size);
@@ -28,6 +28,7 @@
 
 
 #include "qtdsp_filter.h"
+#include "qtdsp_kernels.h"
 
 //#include <cstring>
 
@@ -39,163 +40,258 @@
 #define NULL 0
 #endif
 
+
+FilterDesignThread::FilterDesignThread(QFilter *filter)
+	: QThread()
+	, m_filter(filter)
+	, m_fft(0)
+	, m_fftSize(0)
+	, m_pending(false)
+	, m_busy(false)
+	, m_quit(false)
+{
+}
+
+FilterDesignThread::~FilterDesignThread() {
+
+	m_mutex.lock();
+	m_quit = true;
+	m_wakeUp.wakeOne();
+	m_mutex.unlock();
+
+	wait();
+	if (m_fft) delete m_fft;
+}
+
+// called by the owner of the filter; the thread is started with the first
+// design and then waits for the next one
+void FilterDesignThread::design(const FilterDesign &request) {
+
+	QMutexLocker locker(&m_mutex);
+
+	m_request = request;
+	m_pending = true;
+
+	if (!isRunning())
+		start(QThread::LowPriority);
+	else
+		m_wakeUp.wakeOne();
+}
+
+void FilterDesignThread::waitForDesign() {
+
+	QMutexLocker locker(&m_mutex);
+
+	while (m_pending || m_busy)
+		m_idle.wait(&m_mutex);
+}
+
+void FilterDesignThread::run() {
+
+	m_mutex.lock();
+
+	forever {
+
+		while (!m_pending && !m_quit)
+			m_wakeUp.wait(&m_mutex);
+
+		if (m_quit) break;
+
+		FilterDesign request = m_request;
+		m_pending = false;
+		m_busy = true;
+		m_mutex.unlock();
+
+		if (m_fftSize != request.size * 2) {
+
+			if (m_fft) delete m_fft;
+
+			m_fftSize = request.size * 2;
+			m_fft = new QFFT(m_fftSize);
+		}
+		m_filter->designSpectra(request, m_fft, m_taps);
+
+		m_mutex.lock();
+		m_busy = false;
+
+		if (!m_pending)
+			m_idle.wakeAll();
+	}
+
+	m_busy = false;
+	m_idle.wakeAll();
+	m_mutex.unlock();
+}
+
+
+
 QFilter::QFilter(QObject *parent, int size, const int ftype, const int wtype)
 	: QObject(parent)
 	, set(Settings::instance())
 	, m_streamMode(true)
+	, m_fading(false)
 	, m_size(size)
 	, m_ftype(ftype)
 	, m_wtype(wtype)
+	, m_filterLength(0)
+	, m_maxTaps(FILTER_MAX_TAPS)
+	, m_fdlSlots(0)
+	, m_fdlPos(0)
 	, m_samplerate(set->getSampleRate())
 	, m_filter_lo(-3050.0f)
 	, m_filter_hi(-150.0f)
+	, m_designer(0)
+	, m_active(&m_spectraA)
+	, m_next(&m_spectraB)
+	, ovlpfft(0)
 {
-	InitCPX(ovlp, 		m_size, 0.0f);
-	InitCPX(tmp, 		m_size, 0.0f);
-	InitCPX(res, 		m_size, 0.0f);
-	InitCPX(filter, 	m_size * 2, 0.0f);
-	InitCPX(tmp0, 		m_size * 2, 0.0f);
-	InitCPX(tmp1, 		m_size * 2, 0.0f);
-	InitCPX(tmp2, 		m_size * 2, 0.0f);
-	InitCPX(tmpfilt0, 	m_size * 2, 0.0f);
-	InitCPX(tmpfilt1, 	m_size * 2, 0.0f);
-
-    ovlpfft = new QFFT(m_size * 2);
-    filtfft = new QFFT(m_size * 2);
+	allocate();
 
+	// the first filter is in place before the first block
+	m_designer = new FilterDesignThread(this);
     MakeFilter(m_filter_lo, m_filter_hi, m_ftype, m_wtype);
+	m_designer->waitForDesign();
 }
 
 QFilter::~QFilter() {
 
+	// the design thread writes m_published
+	delete m_designer;
+
 	if (ovlpfft) delete ovlpfft;
-	if (filtfft) delete filtfft;
 
-    ovlp.clear();
-    filter.clear();
-    tmpfilt0.clear();
-    tmpfilt1.clear();
-	tmp.clear();
-    tmp0.clear();
-    tmp1.clear();
+	m_lastBlock.clear();
+}
+
+// buffers and FFTs for the block size m_size; the delay line and the
+// consumer's spectra hold the partitions of the longest filter.
+void QFilter::allocate() {
+
+	if (ovlpfft) delete ovlpfft;
+
+	ovlpfft = new QFFT(m_size * 2);
+
+	m_fdlSlots = (m_maxTaps + m_size - 1) / m_size;
+	m_fdlPos = 0;
+
+	m_fdl.resize(m_fdlSlots * m_size * 2);
+	m_fdl.clear();
+
+	m_fftBuf.resize(m_size * 2);
+	m_fadeBuf.resize(m_size * 2);
+
+	InitCPX(m_lastBlock, m_size, 0.0f);
 
+	m_spectraA.bins.resize(m_fdlSlots * m_size * 2);
+	m_spectraB.bins.resize(m_fdlSlots * m_size * 2);
+	m_spectraA.size = m_spectraB.size = m_size;
+	m_spectraA.partitions = m_spectraB.partitions = 0;
+	m_spectraA.taps = m_spectraB.taps = 0;
+
+	m_active = &m_spectraA;
+	m_next = &m_spectraB;
+	m_fading = false;
 }
 
-void QFilter::DoConvolutionCPX() {
+// DSP side: copies a published filter into the spare spectra. The first
+// filter after allocate() is used at once, any later one is faded in.
+void QFilter::takeSpectra(const FilterSpectra &spectra) {
 
-    mutex.lock();
-    for (int i = 0; i < m_size * 2; i++)  //convolution in frequency space here
-    {
-        tmp0[i].re = (filter.at(i).re * tmp1.at(i).re) - (filter.at(i).im * tmp1.at(i).im);
-        tmp0[i].im = (filter.at(i).re * tmp1.at(i).im) + (filter.at(i).im * tmp1.at(i).re);
-    }
-    mutex.unlock();
+	int partitions = qMin(spectra.partitions, m_fdlSlots);
+
+	memcpy(m_next->bins.data(), spectra.bins.constData(), sizeof(cpx) * partitions * m_size * 2);
+	m_next->partitions = partitions;
+	m_next->taps = qMin(spectra.taps, partitions * m_size);
+
+	if (m_active->partitions == 0) {
+
+		qSwap(m_active, m_next);
+		m_fading = false;
+	}
+	else
+		m_fading = true;
 }
 
-void QFilter::DoOverlapAddCPX() {
+// sums the products of the newest input spectra with the partition spectra
+// into acc and transforms it back; without stream mode only the current
+// block and the first partition take part.
+const cpx *QFilter::convolve(const FilterSpectra &spectra, cpx *acc) {
 
-    //SSEAddCPX(tmp0, tmp1, ovlp, m_size);
-	for (int i = 0; i < m_size; i++) {
+	const int bins = m_size * 2;
+	const int partitions = m_streamMode ? spectra.partitions : qMin(1, spectra.partitions);
+
+	memset(acc, 0, sizeof(cpx) * bins);
 
-		//tmp0[i] = AddCPX(tmp1.at(i), ovlp.at(i));
-		//ovlp[i] = tmp1.at(i + m_size);
-		res[i] = AddCPX(tmp2.at(i), ovlp.at(i));
-		ovlp[i] = tmp2.at(i + m_size);
+	int slot = m_fdlPos;
+	for (int k = 0; k < partitions; k++) {
+
+		QtDSP::multiplyAccumulate(m_fdl.constData() + slot * bins, spectra.bins.constData() + k * bins, acc, bins);
+
+		if (--slot < 0)
+			slot = m_fdlSlots - 1;
 	}
+
+	ovlpfft->InverseInPlace(acc);
+	return acc;
 }
 
 void QFilter::ProcessFilter(CPX &in, CPX &out, int bsize) {
 
 	Q_UNUSED (bsize)
 
-	memcpy(tmp0.data(), in.data(), sizeof(cpx) * m_size);
-    ovlpfft->DoFFTWForward(tmp0, tmp1, m_size * 2);
-    DoConvolutionCPX();
-    ovlpfft->DoFFTWInverse(tmp0, tmp1, m_size * 2);
+	// a filter published by the design thread since the last block
+	const FilterSpectra *spectra = m_published.readSlot();
+	if (spectra && spectra->size == m_size)
+		takeSpectra(*spectra);
 
-    if (m_streamMode) {
+	// overlap-save: the previous and the current block, transformed into
+	// the newest slot of the delay line
+	if (++m_fdlPos == m_fdlSlots)
+		m_fdlPos = 0;
 
-    	//Normalize(tmp1, tmp2, m_size * 2);
+	cpx *x = m_fdl.data() + m_fdlPos * m_size * 2;
 
-    	// Overlap-Add
-    	for (int i = 0; i < m_size; i++) {
+	if (m_streamMode)
+		memcpy(x, m_lastBlock.constData(), sizeof(cpx) * m_size);
+	else
+		memset(x, 0, sizeof(cpx) * m_size);
 
-    		out[i] = AddCPX(tmp1.at(i), ovlp.at(i));
-    		ovlp[i] = tmp1.at(i + m_size);
-    	}
-		//DoOverlapAddCPX();
-		//Normalize(tmp0, out, m_size * 2);
-		//memcpy(out.data(), res.data(), sizeof(cpx) * m_size);
-    }
-    else {
-		
-		memcpy(out.data(), tmp1.data(), sizeof(cpx) * m_size);
-    }
-}
+	memcpy(x + m_size, in.constData(), sizeof(cpx) * m_size);
+	memcpy(m_lastBlock.data(), in.constData(), sizeof(cpx) * m_size);
 
-void QFilter::ProcessChirpFilter(CPX &in, CPX &out, int bsize) {
+	ovlpfft->ForwardInPlace(x);
 
-    Q_UNUSED(in)
-    Q_UNUSED(out)
-    Q_UNUSED(bsize)
-}
+	// the second half of the circular convolution is the linear one
+	const cpx *y = convolve(*m_active, m_fftBuf.data()) + m_size;
+	cpx *o = out.data();
 
-void QFilter::ProcessForwardFilter(CPX &in, CPX &out, int bsize) {
+	if (!m_fading) {
 
-	Q_UNUSED (bsize)
+		memcpy(o, y, sizeof(cpx) * m_size);
+		return;
+	}
 
-	//memcpy(tmp0, in, sizeof(CPX) * m_size);
-	memcpy(tmp0.data(), in.data(), sizeof(cpx) * m_size);
-    ovlpfft->DoFFTWForward(tmp0, tmp1, m_size * 2);
+	// both filters see the same input history, so a linear crossfade over
+	// the block switches between them without a transient
+	const cpx *z = convolve(*m_next, m_fadeBuf.data()) + m_size;
 
-    DoConvolutionCPX();
-    //ovlpfft->DoFFTWInverse(tmp0, tmp1, m_size * 2);
+	float step = 1.0f / m_size;
+	for (int i = 0; i < m_size; i++) {
 
-    if (m_streamMode) {
+		float w = (i + 1) * step;
+		o[i].re = y[i].re + w * (z[i].re - y[i].re);
+		o[i].im = y[i].im + w * (z[i].im - y[i].im);
+	}
 
-        DoOverlapAddCPX();
-        //memcpy(out, tmp0, sizeof(CPX) * m_size);
-        memcpy(out.data(), tmp0.data(), sizeof(cpx) * m_size);
-    }
-    else {
-		
-		//memcpy(out, tmp1, sizeof(CPX) * m_size);
-    	memcpy(out.data(), tmp1.data(), sizeof(cpx) * m_size);
-    }
+	qSwap(m_active, m_next);
+	m_fading = false;
 }
 
-int QFilter::ProcessAndDecimate(CPX &in, CPX &out, int bsize) {
+void QFilter::ProcessChirpFilter(CPX &in, CPX &out, int bsize) {
 
     Q_UNUSED(in)
+    Q_UNUSED(out)
     Q_UNUSED(bsize)
-
-    //memset(tmp0, 0, sizeof(CPX) * m_size * 2);
-    //memset(tmp1, 0, sizeof(CPX) * m_size * 2);
-    //memcpy(tmp0, in, sizeof(CPX) * m_size);
-	tmp0.resize(m_size * 2);
-	tmp1.resize(m_size * 2);
-	tmp0.resize(m_size);
-
-    ovlpfft->DoFFTWForward(tmp0, tmp1, m_size * 2);
-    DoConvolutionCPX();
-    ovlpfft->DoFFTWInverse(tmp0, tmp1, m_size * 2);
-
-    if (m_streamMode) {
-		
-		DoOverlapAddCPX();
-        for (int i = 0, j = 0; i < m_size; i+=2, j++) {
-			
-			*(out.data()+j) = *(tmp0.data()+i);
-        }
-    }
-	else {
-		
-		for (int i = 0, j = 0; i < m_size; i+=2, j++) {
-			
-			*(out.data()+j) = *(tmp1.data()+i);
-        }
-    }
-    return m_size/2;
 }
 
 void QFilter::Normalize(CPX &in, CPX &out, int size) {
@@ -208,39 +304,75 @@ void QFilter::Normalize(CPX &in, CPX &out, int size) {
 	}
 }
 
-void QFilter::Decimate(CPX &in, CPX &out, int downrate) {
+void QFilter::setSampleRate(QObject *sender, int value) {
+
+	Q_UNUSED(sender)
+
+	m_samplerate = (float)value;
+	//FILTER_DEBUG << "set sample rate to " << m_samplerate;
+	MakeFilter(m_filter_lo, m_filter_hi, m_ftype, m_wtype);
+}
+
+// the block size changes with the decimation in front of the filter; by
+// default the filter length follows it, so the impulse response keeps its
+// duration. Must not run concurrently with ProcessFilter(); the output is
+// silent until the new design is published.
+void QFilter::setBlockSize(int size) {
 
-	int newsize = qRound(qreal(m_size / downrate));
+	if (size == m_size) return;
 
-	//memset(out, 0, newsize * sizeof(CPX));
-	//memset(tmp, 0, m_size * sizeof(CPX));
-	out.resize(newsize);
-	tmp.resize(m_size);
-	//memcpy(tmp, in, m_size * sizeof(CPX));
-	memcpy(tmp.data(), in.data(), m_size * sizeof(cpx));
+	mutex.lock();
+	m_size = size;
+	allocate();
+	mutex.unlock();
 
-	for (int j = 0; j < newsize; j++) {
-		for (int k = 0; k < downrate; k++) {
-		//for (int k = 0; k < downrate - 1; k++) {
+	MakeFilter(m_filter_lo, m_filter_hi, m_ftype, m_wtype);
+}
 
-			if (j * downrate + k < m_size) {
+void QFilter::setFilterLength(int taps) {
 
-				out[j].re += tmp.at(j * downrate + k).re;
-				out[j].im += tmp.at(j * downrate + k).im;
-			}
-		}
-	}
+	taps = qBound(0, taps, m_maxTaps);
+	if (taps == m_filterLength) return;
+
+	m_filterLength = taps;
+	MakeFilter(m_filter_lo, m_filter_hi, m_ftype, m_wtype);
 }
 
-void QFilter::setSampleRate(QObject *sender, int value) {
+void QFilter::setMaxFilterLength(int taps) {
 
-	Q_UNUSED(sender)
+	if (taps == m_maxTaps || taps <= 0) return;
+
+	mutex.lock();
+	m_maxTaps = taps;
+	m_filterLength = qMin(m_filterLength, m_maxTaps);
+	allocate();
+	mutex.unlock();
 
-	m_samplerate = (float)value;
-	//FILTER_DEBUG << "set sample rate to " << m_samplerate;
 	MakeFilter(m_filter_lo, m_filter_hi, m_ftype, m_wtype);
 }
 
+void QFilter::loadTaps(const CPX &taps, int length) {
+
+	mutex.lock();
+	m_loadedTaps = taps;
+	m_loadedTaps.resize(qBound(1, length, m_maxTaps));
+	m_filterLength = m_loadedTaps.size();
+	m_ftype = 3;
+	mutex.unlock();
+
+	MakeFilter(m_filter_lo, m_filter_hi, m_ftype, m_wtype);
+}
+
+int QFilter::filterLength() const {
+
+	return m_filterLength > 0 ? m_filterLength : m_size;
+}
+
+int QFilter::activeLength() const {
+
+	return m_active->taps;
+}
+
 void QFilter::setFilterLo(const float value) {
 
     if (value != m_filter_lo) {
@@ -289,74 +421,119 @@ void QFilter::setStreamMode(int value) {
 	m_streamMode = value;
 }
 
+// posts the design; the taps and spectra are built by m_designer
 void QFilter::MakeFilter(const float lo, const float hi, const int ftype = 2, const int wtype = 12) {
     
+	FilterDesign request;
+
+	mutex.lock();
+	request.lo = lo;
+	request.hi = hi;
+	request.samplerate = m_samplerate;
+	request.ftype = ftype;
+	request.wtype = wtype;
+	request.size = m_size;
+	request.length = filterLength();
+	request.loadedTaps = m_loadedTaps;
+	mutex.unlock();
+
+	m_designer->design(request);
+}
+
+void QFilter::waitForDesign() {
+
+	m_designer->waitForDesign();
+}
+
+void QFilter::designSpectra(const FilterDesign &request, QFFT *fft, CPX &taps) {
+
+	const int size = request.size;
+	const int length = request.length;
+	const int bins = size * 2;
+	const int partitions = (length + size - 1) / size;
+
     // size x 4 adjusts for no gain
     //float one_over_norm = 1.0 / (m_size * 4);
-	float one_over_norm = 1.0 / (m_size * 2);
+	float one_over_norm = 1.0 / bins;
 	
-    filter.resize(m_size * 2);
-    tmpfilt0.resize(m_size * 2);
-    tmpfilt1.resize(m_size  * 2);
+	// zero beyond the taps up to the end of the last partition
+	InitCPX(taps, partitions * size, 0.0f);
 
-    switch (ftype) {
+    switch (request.ftype) {
 
         case 1: // lowpass            
-            MakeFirLowpass( hi,
-                            m_samplerate,
-                            wtype,
-                            tmpfilt0,
-                            m_size);
+            MakeFirLowpass( request.hi,
+                            request.samplerate,
+                            request.wtype,
+                            taps,
+                            length);
             break;
         case 2: // bandpass            
-            MakeFirBandpass(lo,
-                            hi,
-                            m_samplerate,
-                            wtype,
-                            tmpfilt0,
-                            m_size);
+            MakeFirBandpass(request.lo,
+                            request.hi,
+                            request.samplerate,
+                            request.wtype,
+                            taps,
+                            length);
             break;
         case 3: // loadable coeff
-            LoadFilter(tmpfilt0);
+            LoadFilter(request, taps);
             break;
         case 4: // bandstop
-            MakeFirBandstop(lo,
-                            hi,
-							m_samplerate,
-							tmpfilt0,
-							m_size);
+            MakeFirBandstop(request.lo,
+                            request.hi,
+							request.samplerate,
+							taps,
+							length);
             break;
         default:            
-            MakeFirBandpass(lo,
-							hi,
-							m_samplerate,
-							wtype,
-							tmpfilt0,
-							m_size);
+            MakeFirBandpass(request.lo,
+							request.hi,
+							request.samplerate,
+							request.wtype,
+							taps,
+							length);
             break;
     }
 
-    mutex.lock();
-    //filtfft->DoFFTWForward(tmpfilt0, tmpfilt1, m_size * 2);
-	filtfft->DoFFTWForward(tmpfilt0, filter, m_size * 2);
+	// Do compensation here instead of in inverse FFT
+	FilterSpectra &spectra = m_published.writeSlot();
+
+	spectra.size = size;
+	spectra.partitions = partitions;
+	spectra.taps = length;
+	spectra.bins.resize(partitions * bins);
+
+	for (int k = 0; k < partitions; k++) {
+
+		cpx *h = spectra.bins.data() + k * bins;
 
-	for (int i = 0; i < m_size * 2; i++) {
+		memcpy(h, taps.constData() + k * size, sizeof(cpx) * size);
+		memset(h + size, 0, sizeof(cpx) * size);
 
-			filter[i].re *= one_over_norm;
-			filter[i].im *= one_over_norm;
+		fft->ForwardInPlace(h);
+
+		for (int i = 0; i < bins; i++) {
+
+			h[i].re *= one_over_norm;
+			h[i].im *= one_over_norm;
+		}
 	}
-	mutex.unlock();
 
-    // Do compensation here instead of in inverse FFT
-    //filter_mutex.lock();
-    //SSEScaleCPX(filter, tmpfilt1, one_over_norm, m_size * 2);
-    //filter_mutex.unlock();
+	m_published.commitWrite();
 }
 
 //void QFilter::LoadFilter(CPX * taps) {
-void QFilter::LoadFilter(CPX &taps) {
+void QFilter::LoadFilter(const FilterDesign &request, CPX &taps) {
+
+	if (!request.loadedTaps.isEmpty()) {
+
+		int length = qMin(taps.size(), request.loadedTaps.size());
+		memcpy(taps.data(), request.loadedTaps.constData(), sizeof(cpx) * length);
+		return;
+	}
 
-    if (FILTERCOEFFSIZE > m_size) return;
+    if (FILTERCOEFFSIZE > request.size) return;
 
     for (int i = 0; i < FILTERCOEFFSIZE; i++) {
 
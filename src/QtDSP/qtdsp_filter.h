@@ -38,9 +38,12 @@
 #include "qtdsp_qComplex.h"
 #include "qtdsp_invsinc_coeff.h"
 #include "../cusdr_settings.h"
+#include "../Util/cusdr_frameRing.h"
 
 //#include <QObject>
 //#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
 
 #ifdef LOG_QTDSP_FILTER
 #   define FILTER_DEBUG qDebug().nospace() << "QtDSP_Filter::\t"
@@ -52,44 +55,151 @@
 
 #define BLACKMANHARRIS_WINDOW   12
 
+// longest impulse response setFilterLength() accepts by default, see
+// setMaxFilterLength()
+#define FILTER_MAX_TAPS			8192
+
+
+class QFilter;
+
+// everything a filter design depends on, copied when it is posted
+struct FilterDesign {
+
+	float	lo;
+	float	hi;
+	float	samplerate;
+	int		ftype;
+	int		wtype;
+	int		size;
+	int		length;
+	CPX		loadedTaps;
+};
+
+
+/*!
+	\brief Designs the filters of one QFilter (taps and partition spectra)
+	off the DSP thread and publishes them to it; a design posted while
+	another one waits replaces it.
+*/
+class FilterDesignThread : public QThread {
+
+public:
+	FilterDesignThread(QFilter *filter);
+	~FilterDesignThread();
+
+	void	design(const FilterDesign &request);
+
+	// blocks until the last posted design is published
+	void	waitForDesign();
+
+protected:
+	void	run();
+
+private:
+	QFilter			*m_filter;
+	QFFT			*m_fft;
+	int				m_fftSize;
+	CPX				m_taps;
+
+	QMutex			m_mutex;
+	QWaitCondition	m_wakeUp;
+	QWaitCondition	m_idle;
+	FilterDesign	m_request;
+	bool			m_pending;
+	bool			m_busy;
+	bool			m_quit;
+};
+
+
+/*!
+	\class QFilter
+	\brief Complex FIR filter as a uniformly partitioned overlap-save
+	convolution.
+
+	The taps are cut into partitions of the block size, each one zero padded
+	to twice its length and transformed. Every block is transformed once,
+	together with the previous one, into a frequency domain delay line; the
+	output spectrum is the sum of the last K input spectra times the K
+	partition spectra, and one inverse FFT yields the block. The latency is
+	one block whatever the filter length, which is set independently by
+	setFilterLength() (by default the block size).
+
+	MakeFilter() only posts the design to a FilterDesignThread, which builds
+	the taps and their spectra and publishes them through a QHMailbox,
+	latest wins. ProcessFilter() takes a new filter at the start of a block
+	and crossfades from the old to the new output over that block; neither
+	side waits for the other.
+
+	loadTaps() sets an arbitrary impulse response instead of a designed one
+	(filter type 3), e.g. the matched filter of the chirp decoder.
+*/
 class QFilter : public QObject {
 
 	Q_OBJECT 
 
+	friend class FilterDesignThread;
+
 public:
     QFilter(QObject *parent = 0, int size = 0, const int ftype = 2, const int wtype = 12);
 	~QFilter();
 
 private:
+	// partition k holds the taps k * size .. (k + 1) * size - 1, zero
+	// padded to 2 * size and transformed, at bins + 2 * k * size
+	struct FilterSpectra {
+
+		int			size;
+		int			partitions;
+		int			taps;			// impulse response length
+		CPXBuffer	bins;
+	};
+
 	Settings	*set;
 
+	// serializes the setters; ProcessFilter() does not take it
 	QMutex		mutex;
 
 	bool		m_streamMode;
+	bool		m_fading;
 
     int			m_size;
 	int			m_ftype;
 	int			m_wtype;
+	int			m_filterLength;		// 0: the block size
+	int			m_maxTaps;
+	int			m_fdlSlots;
+	int			m_fdlPos;			// slot of the newest input spectrum
 
     float		m_samplerate;
 	float		m_filter_lo;
     float		m_filter_hi;
 
-    CPX		ovlp;
-    CPX		filter;
-    CPX		res;
-    CPX		tmpfilt0;
-    CPX		tmpfilt1;
-	CPX		tmp;
-    CPX		tmp0;
-    CPX		tmp1;
-    CPX		tmp2;
+	CPX			m_loadedTaps;		// taps of loadTaps()
+	CPX			m_lastBlock;		// previous input block
+
+	CPXBuffer	m_fdl;				// frequency domain delay line, m_fdlSlots spectra
+	CPXBuffer	m_fftBuf;			// output spectrum of the active filter
+	CPXBuffer	m_fadeBuf;			// output spectrum of the next filter while fading
+
+	// written by m_designer only
+	QHMailbox<FilterSpectra>	m_published;
+	FilterDesignThread			*m_designer;
+
+	FilterSpectra	m_spectraA;
+	FilterSpectra	m_spectraB;
+	FilterSpectra	*m_active;
+	FilterSpectra	*m_next;
 
     QFFT	*ovlpfft;
-    QFFT	*filtfft;
+
+	void	allocate();
+	// design thread side of MakeFilter()
+	void	designSpectra(const FilterDesign &request, QFFT *fft, CPX &taps);
+	void	takeSpectra(const FilterSpectra &spectra);
+	const cpx*	convolve(const FilterSpectra &spectra, cpx *acc);
 
 private slots:
-    void LoadFilter(CPX &taps);
+    void LoadFilter(const FilterDesign &request, CPX &taps);
     void MakeFirLowpass(float cutoff, 
                         float samplerate, 
                         int wtype, 
@@ -124,25 +234,30 @@ private slots:
                         CPX &taps,
                         int length);
     
-	//void DoConvolutionCPX();
-    void DoOverlapAddCPX();
-
 public slots:
 	void	setSampleRate(QObject *sender, int value);
+	void	setBlockSize(int size);
+	// impulse response length in taps, 0 for the block size
+	void	setFilterLength(int taps);
+	// longest impulse response; must not run concurrently with ProcessFilter()
+	void	setMaxFilterLength(int taps);
+	// uses the first \a length of \a taps as impulse response
+	void	loadTaps(const CPX &taps, int length);
 
     void	MakeFilter(const float lo, const float hi, const int ftype, const int wtype);
+	void	waitForDesign();
     static void MakeWindow(int wtype, int size, float * window);
 
     void	ProcessFilter(CPX &in, CPX &out, int bsize);
-	void	ProcessForwardFilter(CPX &in, CPX &out, int bsize);
 	void	ProcessChirpFilter(CPX &in, CPX &out, int bsize);
-    int		ProcessAndDecimate(CPX &in, CPX &out, int bsize);
-	void	Decimate(CPX &in, CPX &out, int downrate);
-	void	DoConvolutionCPX();
 	void	Normalize(CPX &in, CPX &out, int size);
 
     float filterLo() const ;
     float filterHi() const ;
+    int filterLength() const;
+	// taps of the filter the last ProcessFilter() block ended with; for the
+	// thread that calls ProcessFilter(), unlike filterLength()
+	int activeLength() const;
     int isStreamMode() const;
     void setFilterLo(const float value);
     void setFilterHi(const float value);
@@ -0,0 +1,681 @@
+/**
+* @file  qtdsp_kernels.cpp
+* @brief vectorized DSP kernels for QtDSP
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "qtdsp_kernels.h"
+
+#if defined(QTDSP_X86)
+#include <immintrin.h>
+#endif
+
+#include <math.h>
+
+namespace QtDSP {
+
+//**********************************************************
+// scalar code path, also used for the tails of the vector loops
+
+static void magnitudeSquaredScalar(const cpx *in, float *out, int n) {
+
+	for (int i = 0; i < n; i++)
+		out[i] = in[i].re * in[i].re + in[i].im * in[i].im;
+}
+
+static void magnitudeScalar(const cpx *in, float *out, int n) {
+
+	for (int i = 0; i < n; i++)
+		out[i] = sqrtf(in[i].re * in[i].re + in[i].im * in[i].im);
+}
+
+static float energyScalar(const cpx *in, int n) {
+
+	float sum = 0.0f;
+	for (int i = 0; i < n; i++)
+		sum += in[i].re * in[i].re + in[i].im * in[i].im;
+
+	return sum;
+}
+
+static void powerDbScalar(const float *in, float *out, int n, float baseline, float correction) {
+
+	for (int i = 0; i < n; i++)
+		out[i] = fastDb(in[i] + baseline) + correction;
+}
+
+static void magnitudeDbScalar(const cpx *in, float *out, int n, float baseline, float correction, bool reversed) {
+
+	for (int i = 0; i < n; i++) {
+
+		float value = fastDb(in[i].re * in[i].re + in[i].im * in[i].im + baseline) + correction;
+
+		if (reversed)
+			out[n - 1 - i] = value;
+		else
+			out[i] = value;
+	}
+}
+
+static float maxValueScalar(const float *in, int n, float max) {
+
+	for (int i = 0; i < n; i++)
+		if (in[i] > max) max = in[i];
+
+	return max;
+}
+
+static void peakHoldScalar(float *hold, const float *in, int n) {
+
+	for (int i = 0; i < n; i++)
+		if (in[i] > hold[i]) hold[i] = in[i];
+}
+
+static void multiplyAccumulateScalar(const cpx *a, const cpx *b, cpx *acc, int n) {
+
+	for (int i = 0; i < n; i++) {
+
+		acc[i].re += a[i].re * b[i].re - a[i].im * b[i].im;
+		acc[i].im += a[i].re * b[i].im + a[i].im * b[i].re;
+	}
+}
+
+static inline void segmentScalar(const float *in, int n, float &min, float &max, float &sum) {
+
+	for (int i = 0; i < n; i++) {
+
+		if (in[i] < min) min = in[i];
+		if (in[i] > max) max = in[i];
+		sum += in[i];
+	}
+}
+
+static void envelopeScalar(const float *in, const int *edges, int pixels, float *min, float *max, float *mean) {
+
+	for (int p = 0; p < pixels; p++) {
+
+		int n = edges[p + 1] - edges[p];
+		float lo = FLT_MAX, hi = -FLT_MAX, sum = 0.0f;
+
+		segmentScalar(in + edges[p], n, lo, hi, sum);
+
+		min[p] = lo;
+		max[p] = hi;
+		mean[p] = sum / n;
+	}
+}
+
+#if defined(QTDSP_X86)
+
+//**********************************************************
+// SSE4.1, 4 lanes
+
+// same steps as fastLog2(): exponent from the float bits, mantissa reduced
+// to [0.71, 1.41], atanh series in t = (m - 1)/(m + 1)
+QTDSP_TARGET("sse4.1")
+static inline __m128 log2SSE41(__m128 x) {
+
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	x = _mm_max_ps(x, _mm_set1_ps(FLT_MIN));
+
+	__m128i bits = _mm_castps_si128(x);
+	__m128i e = _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127));
+	__m128 m = _mm_castsi128_ps(_mm_or_si128(
+		_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f800000)));
+
+	__m128 big = _mm_cmpgt_ps(m, _mm_set1_ps(1.41421356f));
+	m = _mm_blendv_ps(m, _mm_mul_ps(m, _mm_set1_ps(0.5f)), big);
+	__m128 ef = _mm_add_ps(_mm_cvtepi32_ps(e), _mm_and_ps(big, one));
+
+	__m128 t = _mm_div_ps(_mm_sub_ps(m, one), _mm_add_ps(m, one));
+	__m128 t2 = _mm_mul_ps(t, t);
+
+	__m128 p = _mm_set1_ps(QTDSP_LOG2_C7);
+	p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(QTDSP_LOG2_C5));
+	p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(QTDSP_LOG2_C3));
+	p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(QTDSP_LOG2_C1));
+
+	return _mm_add_ps(ef, _mm_mul_ps(t, p));
+}
+
+// |x|^2 of four cpx
+QTDSP_TARGET("sse4.1")
+static inline __m128 magSSE41(const cpx *in) {
+
+	__m128 a = _mm_loadu_ps((const float *) in);
+	__m128 b = _mm_loadu_ps((const float *) (in + 2));
+
+	return _mm_hadd_ps(_mm_mul_ps(a, a), _mm_mul_ps(b, b));
+}
+
+QTDSP_TARGET("sse4.1")
+static void magnitudeSquaredSSE41(const cpx *in, float *out, int n) {
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4)
+		_mm_storeu_ps(out + i, magSSE41(in + i));
+
+	magnitudeSquaredScalar(in + i, out + i, n - i);
+}
+
+QTDSP_TARGET("sse4.1")
+static void magnitudeSSE41(const cpx *in, float *out, int n) {
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4)
+		_mm_storeu_ps(out + i, _mm_sqrt_ps(magSSE41(in + i)));
+
+	magnitudeScalar(in + i, out + i, n - i);
+}
+
+QTDSP_TARGET("sse4.1")
+static float energySSE41(const cpx *in, int n) {
+
+	__m128 acc = _mm_setzero_ps();
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4)
+		acc = _mm_add_ps(acc, magSSE41(in + i));
+
+	acc = _mm_hadd_ps(acc, acc);
+	acc = _mm_hadd_ps(acc, acc);
+
+	return _mm_cvtss_f32(acc) + energyScalar(in + i, n - i);
+}
+
+QTDSP_TARGET("sse4.1")
+static void powerDbSSE41(const float *in, float *out, int n, float baseline, float correction) {
+
+	const __m128 base = _mm_set1_ps(baseline);
+	const __m128 scale = _mm_set1_ps(QTDSP_DB_PER_LOG2);
+	const __m128 corr = _mm_set1_ps(correction);
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+
+		__m128 v = log2SSE41(_mm_add_ps(_mm_loadu_ps(in + i), base));
+		_mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(v, scale), corr));
+	}
+
+	powerDbScalar(in + i, out + i, n - i, baseline, correction);
+}
+
+QTDSP_TARGET("sse4.1")
+static void magnitudeDbSSE41(const cpx *in, float *out, int n, float baseline, float correction, bool reversed) {
+
+	const __m128 base = _mm_set1_ps(baseline);
+	const __m128 scale = _mm_set1_ps(QTDSP_DB_PER_LOG2);
+	const __m128 corr = _mm_set1_ps(correction);
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+
+		__m128 v = log2SSE41(_mm_add_ps(magSSE41(in + i), base));
+		v = _mm_add_ps(_mm_mul_ps(v, scale), corr);
+
+		if (reversed)
+			_mm_storeu_ps(out + n - 4 - i, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3)));
+		else
+			_mm_storeu_ps(out + i, v);
+	}
+
+	// the remaining samples go to the front of a reversed output
+	magnitudeDbScalar(in + i, reversed ? out : out + i, n - i, baseline, correction, reversed);
+}
+
+QTDSP_TARGET("sse4.1")
+static float maxValueSSE41(const float *in, int n) {
+
+	__m128 acc = _mm_set1_ps(-FLT_MAX);
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4)
+		acc = _mm_max_ps(acc, _mm_loadu_ps(in + i));
+
+	acc = _mm_max_ps(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1, 0, 3, 2)));
+	acc = _mm_max_ps(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(2, 3, 0, 1)));
+
+	return maxValueScalar(in + i, n - i, _mm_cvtss_f32(acc));
+}
+
+QTDSP_TARGET("sse4.1")
+static void peakHoldSSE41(float *hold, const float *in, int n) {
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4)
+		_mm_storeu_ps(hold + i, _mm_max_ps(_mm_loadu_ps(hold + i), _mm_loadu_ps(in + i)));
+
+	peakHoldScalar(hold + i, in + i, n - i);
+}
+
+// two complex products per register: (ar br - ai bi, ai br + ar bi)
+QTDSP_TARGET("sse4.1")
+static void multiplyAccumulateSSE41(const cpx *a, const cpx *b, cpx *acc, int n) {
+
+	int i = 0;
+	for (; i + 2 <= n; i += 2) {
+
+		__m128 x = _mm_loadu_ps((const float *) (a + i));
+		__m128 y = _mm_loadu_ps((const float *) (b + i));
+
+		__m128 re = _mm_mul_ps(x, _mm_moveldup_ps(y));
+		__m128 im = _mm_mul_ps(_mm_shuffle_ps(x, x, 0xB1), _mm_movehdup_ps(y));
+
+		__m128 s = _mm_add_ps(_mm_loadu_ps((const float *) (acc + i)), _mm_addsub_ps(re, im));
+		_mm_storeu_ps((float *) (acc + i), s);
+	}
+
+	multiplyAccumulateScalar(a + i, b + i, acc + i, n - i);
+}
+
+QTDSP_TARGET("sse4.1")
+static void envelopeSSE41(const float *in, const int *edges, int pixels, float *min, float *max, float *mean) {
+
+	for (int p = 0; p < pixels; p++) {
+
+		const float *x = in + edges[p];
+		int n = edges[p + 1] - edges[p];
+		float lo = FLT_MAX, hi = -FLT_MAX, sum = 0.0f;
+
+		int i = 0;
+		if (n >= 8) {
+
+			__m128 vlo = _mm_loadu_ps(x);
+			__m128 vhi = vlo;
+			__m128 vsum = vlo;
+
+			for (i = 4; i + 4 <= n; i += 4) {
+
+				__m128 v = _mm_loadu_ps(x + i);
+				vlo = _mm_min_ps(vlo, v);
+				vhi = _mm_max_ps(vhi, v);
+				vsum = _mm_add_ps(vsum, v);
+			}
+
+			vlo = _mm_min_ps(vlo, _mm_shuffle_ps(vlo, vlo, _MM_SHUFFLE(1, 0, 3, 2)));
+			vlo = _mm_min_ps(vlo, _mm_shuffle_ps(vlo, vlo, _MM_SHUFFLE(2, 3, 0, 1)));
+			vhi = _mm_max_ps(vhi, _mm_shuffle_ps(vhi, vhi, _MM_SHUFFLE(1, 0, 3, 2)));
+			vhi = _mm_max_ps(vhi, _mm_shuffle_ps(vhi, vhi, _MM_SHUFFLE(2, 3, 0, 1)));
+			vsum = _mm_hadd_ps(vsum, vsum);
+			vsum = _mm_hadd_ps(vsum, vsum);
+
+			lo = _mm_cvtss_f32(vlo);
+			hi = _mm_cvtss_f32(vhi);
+			sum = _mm_cvtss_f32(vsum);
+		}
+		segmentScalar(x + i, n - i, lo, hi, sum);
+
+		min[p] = lo;
+		max[p] = hi;
+		mean[p] = sum / n;
+	}
+}
+
+//**********************************************************
+// AVX2, 8 lanes
+
+QTDSP_TARGET("avx2")
+static inline __m256 log2AVX2(__m256 x) {
+
+	const __m256 one = _mm256_set1_ps(1.0f);
+
+	x = _mm256_max_ps(x, _mm256_set1_ps(FLT_MIN));
+
+	__m256i bits = _mm256_castps_si256(x);
+	__m256i e = _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127));
+	__m256 m = _mm256_castsi256_ps(_mm256_or_si256(
+		_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)), _mm256_set1_epi32(0x3f800000)));
+
+	__m256 big = _mm256_cmp_ps(m, _mm256_set1_ps(1.41421356f), _CMP_GT_OQ);
+	m = _mm256_blendv_ps(m, _mm256_mul_ps(m, _mm256_set1_ps(0.5f)), big);
+	__m256 ef = _mm256_add_ps(_mm256_cvtepi32_ps(e), _mm256_and_ps(big, one));
+
+	__m256 t = _mm256_div_ps(_mm256_sub_ps(m, one), _mm256_add_ps(m, one));
+	__m256 t2 = _mm256_mul_ps(t, t);
+
+	__m256 p = _mm256_set1_ps(QTDSP_LOG2_C7);
+	p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(QTDSP_LOG2_C5));
+	p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(QTDSP_LOG2_C3));
+	p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(QTDSP_LOG2_C1));
+
+	return _mm256_add_ps(ef, _mm256_mul_ps(t, p));
+}
+
+// |x|^2 of eight cpx; hadd works per 128 bit lane, the 64 bit permute
+// restores the order 0..7
+QTDSP_TARGET("avx2")
+static inline __m256 magAVX2(const cpx *in) {
+
+	__m256 a = _mm256_loadu_ps((const float *) in);
+	__m256 b = _mm256_loadu_ps((const float *) (in + 4));
+
+	__m256 h = _mm256_hadd_ps(_mm256_mul_ps(a, a), _mm256_mul_ps(b, b));
+	return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(h), 0xD8));
+}
+
+QTDSP_TARGET("avx2")
+static void magnitudeSquaredAVX2(const cpx *in, float *out, int n) {
+
+	int i = 0;
+	for (; i + 8 <= n; i += 8)
+		_mm256_storeu_ps(out + i, magAVX2(in + i));
+
+	magnitudeSquaredScalar(in + i, out + i, n - i);
+}
+
+QTDSP_TARGET("avx2")
+static void magnitudeAVX2(const cpx *in, float *out, int n) {
+
+	int i = 0;
+	for (; i + 8 <= n; i += 8)
+		_mm256_storeu_ps(out + i, _mm256_sqrt_ps(magAVX2(in + i)));
+
+	magnitudeScalar(in + i, out + i, n - i);
+}
+
+QTDSP_TARGET("avx2")
+static float energyAVX2(const cpx *in, int n) {
+
+	__m256 acc = _mm256_setzero_ps();
+
+	int i = 0;
+	for (; i + 8 <= n; i += 8)
+		acc = _mm256_add_ps(acc, magAVX2(in + i));
+
+	__m128 s = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+	s = _mm_hadd_ps(s, s);
+	s = _mm_hadd_ps(s, s);
+
+	return _mm_cvtss_f32(s) + energyScalar(in + i, n - i);
+}
+
+QTDSP_TARGET("avx2")
+static void powerDbAVX2(const float *in, float *out, int n, float baseline, float correction) {
+
+	const __m256 base = _mm256_set1_ps(baseline);
+	const __m256 scale = _mm256_set1_ps(QTDSP_DB_PER_LOG2);
+	const __m256 corr = _mm256_set1_ps(correction);
+
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+
+		__m256 v = log2AVX2(_mm256_add_ps(_mm256_loadu_ps(in + i), base));
+		_mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(v, scale), corr));
+	}
+
+	powerDbScalar(in + i, out + i, n - i, baseline, correction);
+}
+
+QTDSP_TARGET("avx2")
+static void magnitudeDbAVX2(const cpx *in, float *out, int n, float baseline, float correction, bool reversed) {
+
+	const __m256 base = _mm256_set1_ps(baseline);
+	const __m256 scale = _mm256_set1_ps(QTDSP_DB_PER_LOG2);
+	const __m256 corr = _mm256_set1_ps(correction);
+	const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+
+		__m256 v = log2AVX2(_mm256_add_ps(magAVX2(in + i), base));
+		v = _mm256_add_ps(_mm256_mul_ps(v, scale), corr);
+
+		if (reversed)
+			_mm256_storeu_ps(out + n - 8 - i, _mm256_permutevar8x32_ps(v, reverse));
+		else
+			_mm256_storeu_ps(out + i, v);
+	}
+
+	magnitudeDbScalar(in + i, reversed ? out : out + i, n - i, baseline, correction, reversed);
+}
+
+QTDSP_TARGET("avx2")
+static float maxValueAVX2(const float *in, int n) {
+
+	__m256 acc = _mm256_set1_ps(-FLT_MAX);
+
+	int i = 0;
+	for (; i + 8 <= n; i += 8)
+		acc = _mm256_max_ps(acc, _mm256_loadu_ps(in + i));
+
+	__m128 s = _mm_max_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+	s = _mm_max_ps(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 0, 3, 2)));
+	s = _mm_max_ps(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(2, 3, 0, 1)));
+
+	return maxValueScalar(in + i, n - i, _mm_cvtss_f32(s));
+}
+
+QTDSP_TARGET("avx2")
+static void peakHoldAVX2(float *hold, const float *in, int n) {
+
+	int i = 0;
+	for (; i + 8 <= n; i += 8)
+		_mm256_storeu_ps(hold + i, _mm256_max_ps(_mm256_loadu_ps(hold + i), _mm256_loadu_ps(in + i)));
+
+	peakHoldScalar(hold + i, in + i, n - i);
+}
+
+QTDSP_TARGET("avx2")
+static void multiplyAccumulateAVX2(const cpx *a, const cpx *b, cpx *acc, int n) {
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+
+		__m256 x = _mm256_loadu_ps((const float *) (a + i));
+		__m256 y = _mm256_loadu_ps((const float *) (b + i));
+
+		__m256 re = _mm256_mul_ps(x, _mm256_moveldup_ps(y));
+		__m256 im = _mm256_mul_ps(_mm256_permute_ps(x, 0xB1), _mm256_movehdup_ps(y));
+
+		__m256 s = _mm256_add_ps(_mm256_loadu_ps((const float *) (acc + i)), _mm256_addsub_ps(re, im));
+		_mm256_storeu_ps((float *) (acc + i), s);
+	}
+
+	multiplyAccumulateScalar(a + i, b + i, acc + i, n - i);
+}
+
+QTDSP_TARGET("avx2")
+static void envelopeAVX2(const float *in, const int *edges, int pixels, float *min, float *max, float *mean) {
+
+	for (int p = 0; p < pixels; p++) {
+
+		const float *x = in + edges[p];
+		int n = edges[p + 1] - edges[p];
+		float lo = FLT_MAX, hi = -FLT_MAX, sum = 0.0f;
+
+		// narrow segments (little or no zoom reduction) stay scalar
+		int i = 0;
+		if (n >= 16) {
+
+			__m256 vlo = _mm256_loadu_ps(x);
+			__m256 vhi = vlo;
+			__m256 vsum = vlo;
+
+			for (i = 8; i + 8 <= n; i += 8) {
+
+				__m256 v = _mm256_loadu_ps(x + i);
+				vlo = _mm256_min_ps(vlo, v);
+				vhi = _mm256_max_ps(vhi, v);
+				vsum = _mm256_add_ps(vsum, v);
+			}
+
+			__m128 slo = _mm_min_ps(_mm256_castps256_ps128(vlo), _mm256_extractf128_ps(vlo, 1));
+			__m128 shi = _mm_max_ps(_mm256_castps256_ps128(vhi), _mm256_extractf128_ps(vhi, 1));
+			__m128 ssum = _mm_add_ps(_mm256_castps256_ps128(vsum), _mm256_extractf128_ps(vsum, 1));
+
+			slo = _mm_min_ps(slo, _mm_shuffle_ps(slo, slo, _MM_SHUFFLE(1, 0, 3, 2)));
+			slo = _mm_min_ps(slo, _mm_shuffle_ps(slo, slo, _MM_SHUFFLE(2, 3, 0, 1)));
+			shi = _mm_max_ps(shi, _mm_shuffle_ps(shi, shi, _MM_SHUFFLE(1, 0, 3, 2)));
+			shi = _mm_max_ps(shi, _mm_shuffle_ps(shi, shi, _MM_SHUFFLE(2, 3, 0, 1)));
+			ssum = _mm_hadd_ps(ssum, ssum);
+			ssum = _mm_hadd_ps(ssum, ssum);
+
+			lo = _mm_cvtss_f32(slo);
+			hi = _mm_cvtss_f32(shi);
+			sum = _mm_cvtss_f32(ssum);
+		}
+		segmentScalar(x + i, n - i, lo, hi, sum);
+
+		min[p] = lo;
+		max[p] = hi;
+		mean[p] = sum / n;
+	}
+}
+
+#endif // QTDSP_X86
+
+//**********************************************************
+// dispatch
+
+void magnitudeSquared(const cpx *in, float *out, int n) {
+
+#if defined(QTDSP_X86)
+	switch (simdLevel()) {
+
+		case SimdAVX2:	magnitudeSquaredAVX2(in, out, n); return;
+		case SimdSSE41:	magnitudeSquaredSSE41(in, out, n); return;
+		default:		break;
+	}
+#endif
+	magnitudeSquaredScalar(in, out, n);
+}
+
+void magnitude(const cpx *in, float *out, int n) {
+
+#if defined(QTDSP_X86)
+	switch (simdLevel()) {
+
+		case SimdAVX2:	magnitudeAVX2(in, out, n); return;
+		case SimdSSE41:	magnitudeSSE41(in, out, n); return;
+		default:		break;
+	}
+#endif
+	magnitudeScalar(in, out, n);
+}
+
+float energy(const cpx *in, int n) {
+
+#if defined(QTDSP_X86)
+	switch (simdLevel()) {
+
+		case SimdAVX2:	return energyAVX2(in, n);
+		case SimdSSE41:	return energySSE41(in, n);
+		default:		break;
+	}
+#endif
+	return energyScalar(in, n);
+}
+
+void powerDb(const float *in, float *out, int n, float baseline, float correction) {
+
+#if defined(QTDSP_X86)
+	switch (simdLevel()) {
+
+		case SimdAVX2:	powerDbAVX2(in, out, n, baseline, correction); return;
+		case SimdSSE41:	powerDbSSE41(in, out, n, baseline, correction); return;
+		default:		break;
+	}
+#endif
+	powerDbScalar(in, out, n, baseline, correction);
+}
+
+void magnitudeDb(const cpx *in, float *out, int n, float baseline, float correction) {
+
+#if defined(QTDSP_X86)
+	switch (simdLevel()) {
+
+		case SimdAVX2:	magnitudeDbAVX2(in, out, n, baseline, correction, false); return;
+		case SimdSSE41:	magnitudeDbSSE41(in, out, n, baseline, correction, false); return;
+		default:		break;
+	}
+#endif
+	magnitudeDbScalar(in, out, n, baseline, correction, false);
+}
+
+void magnitudeDbReversed(const cpx *in, float *out, int n, float baseline, float correction) {
+
+#if defined(QTDSP_X86)
+	switch (simdLevel()) {
+
+		case SimdAVX2:	magnitudeDbAVX2(in, out, n, baseline, correction, true); return;
+		case SimdSSE41:	magnitudeDbSSE41(in, out, n, baseline, correction, true); return;
+		default:		break;
+	}
+#endif
+	magnitudeDbScalar(in, out, n, baseline, correction, true);
+}
+
+float maxValue(const float *in, int n) {
+
+#if defined(QTDSP_X86)
+	switch (simdLevel()) {
+
+		case SimdAVX2:	return maxValueAVX2(in, n);
+		case SimdSSE41:	return maxValueSSE41(in, n);
+		default:		break;
+	}
+#endif
+	return maxValueScalar(in, n, -FLT_MAX);
+}
+
+void peakHold(float *hold, const float *in, int n) {
+
+#if defined(QTDSP_X86)
+	switch (simdLevel()) {
+
+		case SimdAVX2:	peakHoldAVX2(hold, in, n); return;
+		case SimdSSE41:	peakHoldSSE41(hold, in, n); return;
+		default:		break;
+	}
+#endif
+	peakHoldScalar(hold, in, n);
+}
+
+void multiplyAccumulate(const cpx *a, const cpx *b, cpx *acc, int n) {
+
+#if defined(QTDSP_X86)
+	switch (simdLevel()) {
+
+		case SimdAVX2:	multiplyAccumulateAVX2(a, b, acc, n); return;
+		case SimdSSE41:	multiplyAccumulateSSE41(a, b, acc, n); return;
+		default:		break;
+	}
+#endif
+	multiplyAccumulateScalar(a, b, acc, n);
+}
+
+void envelope(const float *in, const int *edges, int pixels, float *min, float *max, float *mean) {
+
+#if defined(QTDSP_X86)
+	switch (simdLevel()) {
+
+		case SimdAVX2:	envelopeAVX2(in, edges, pixels, min, max, mean); return;
+		case SimdSSE41:	envelopeSSE41(in, edges, pixels, min, max, mean); return;
+		default:		break;
+	}
+#endif
+	envelopeScalar(in, edges, pixels, min, max, mean);
+}
+
+} // namespace QtDSP
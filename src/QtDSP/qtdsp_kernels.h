@@ -0,0 +1,155 @@
+/**
+* @file  qtdsp_kernels.h
+* @brief vectorized DSP kernels header file for QtDSP
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef _QTDSP_KERNELS_H
+#define _QTDSP_KERNELS_H
+
+#include "qtdsp_simd.h"
+#include "qtdsp_qComplex.h"
+
+#include <cfloat>
+
+// 10 * log10(2)
+#define QTDSP_DB_PER_LOG2	3.01029996f
+
+// odd coefficients of 2/ln(2) * atanh(t), t = (m - 1)/(m + 1)
+#define QTDSP_LOG2_C1		2.88539008f
+#define QTDSP_LOG2_C3		0.96179669f
+#define QTDSP_LOG2_C5		0.57707802f
+#define QTDSP_LOG2_C7		0.41219858f
+
+// odd coefficients of atan(z), z in [-1, 1] (Abramowitz and Stegun 4.4.49)
+#define QTDSP_ATAN_C1		0.9999993329f
+#define QTDSP_ATAN_C3		-0.3333314528f
+#define QTDSP_ATAN_C5		0.1999355085f
+#define QTDSP_ATAN_C7		-0.1420889944f
+#define QTDSP_ATAN_C9		0.1065626393f
+#define QTDSP_ATAN_C11		-0.0752896400f
+#define QTDSP_ATAN_C13		0.0429096138f
+#define QTDSP_ATAN_C15		-0.0161657367f
+#define QTDSP_ATAN_C17		0.0028662257f
+
+
+/*
+	Block kernels for the spectrum and meter paths. Each one runs the AVX2,
+	SSE4.1 or scalar code path selected by simdLevel(); none of them
+	allocates, the arrays need no particular alignment.
+
+	The dB conversion takes the exponent from the float bits and evaluates
+	log2 of the mantissa (reduced to [0.71, 1.41]) by a short atanh series.
+	The error stays below 2e-5 dB; powers below FLT_MIN are clamped to FLT_MIN
+	(-379.3 dB), which only affects digital silence.
+
+	fastAtan2() evaluates atan of the smaller over the larger of |x| and |y|
+	and mirrors the result into the right octant; the error stays below
+	1e-6 rad.
+*/
+namespace QtDSP {
+
+	// out[i] = |in[i]|^2
+	void	magnitudeSquared(const cpx *in, float *out, int n);
+
+	// out[i] = |in[i]|
+	void	magnitude(const cpx *in, float *out, int n);
+
+	// sum of |in[i]|^2
+	float	energy(const cpx *in, int n);
+
+	// out[i] = 10 log10(in[i] + baseline) + correction; in may equal out
+	void	powerDb(const float *in, float *out, int n, float baseline, float correction);
+
+	// out[i] = 10 log10(|in[i]|^2 + baseline) + correction
+	void	magnitudeDb(const cpx *in, float *out, int n, float baseline, float correction);
+
+	// as magnitudeDb(), stored in reverse order: out[n - 1 - i]
+	void	magnitudeDbReversed(const cpx *in, float *out, int n, float baseline, float correction);
+
+	// largest value, -FLT_MAX for n = 0
+	float	maxValue(const float *in, int n);
+
+	// hold[i] = max(hold[i], in[i])
+	void	peakHold(float *hold, const float *in, int n);
+
+	// acc[i] += a[i] * b[i], complex
+	void	multiplyAccumulate(const cpx *a, const cpx *b, cpx *acc, int n);
+
+	// minimum, maximum and mean of in[edges[p]] .. in[edges[p + 1] - 1] for
+	// each of the \a pixels segments; edges holds pixels + 1 ascending indices
+	// and every segment at least one value
+	void	envelope(const float *in, const int *edges, int pixels, float *min, float *max, float *mean);
+
+	inline float fastLog2(float x) {
+
+		union { float f; quint32 i; } u;
+		u.f = x > FLT_MIN ? x : FLT_MIN;
+
+		int e = (int)(u.i >> 23) - 127;
+		u.i = (u.i & 0x007fffff) | 0x3f800000;
+
+		float m = u.f;
+		if (m > 1.41421356f) {
+
+			m *= 0.5f;
+			e++;
+		}
+
+		float t = (m - 1.0f) / (m + 1.0f);
+		float t2 = t * t;
+
+		return (float) e + t * (QTDSP_LOG2_C1 + t2 * (QTDSP_LOG2_C3 + t2 * (QTDSP_LOG2_C5 + t2 * QTDSP_LOG2_C7)));
+	}
+
+	// 10 log10(power)
+	inline float fastDb(float power) {
+
+		return QTDSP_DB_PER_LOG2 * fastLog2(power);
+	}
+
+	// atan2(y, x) in [-pi, pi], 0 for x = y = 0
+	inline float fastAtan2(float y, float x) {
+
+		float ax = x < 0.0f ? -x : x;
+		float ay = y < 0.0f ? -y : y;
+
+		float mx = ax > ay ? ax : ay;
+		float mn = ax > ay ? ay : ax;
+		if (mx == 0.0f) return 0.0f;
+
+		float z = mn / mx;
+		float z2 = z * z;
+
+		float a = z * (QTDSP_ATAN_C1 + z2 * (QTDSP_ATAN_C3 + z2 * (QTDSP_ATAN_C5 + z2 * (QTDSP_ATAN_C7
+				+ z2 * (QTDSP_ATAN_C9 + z2 * (QTDSP_ATAN_C11 + z2 * (QTDSP_ATAN_C13
+				+ z2 * (QTDSP_ATAN_C15 + z2 * QTDSP_ATAN_C17))))))));
+
+		if (ay > ax)	a = 1.57079633f - a;
+		if (x < 0.0f)	a = 3.14159265f - a;
+
+		return y < 0.0f ? -a : a;
+	}
+}
+
+#endif // _QTDSP_KERNELS_H
@@ -0,0 +1,90 @@
+/**
+* @file  qtdsp_nco.cpp
+* @brief numerically controlled oscillator class for QtDSP
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "qtdsp_nco.h"
+
+#include <qmath.h>
+
+
+QNco::QNco()
+	: m_phase(0)
+	, m_increment(0)
+{
+	// the fine entries sit in the middle of the 12 truncated bits, which
+	// halves the phase error
+	for (int k = 0; k < NCO_TABLE_SIZE; k++) {
+
+		double coarse = 2.0 * M_PI * k / NCO_TABLE_SIZE;
+		double fine = 2.0 * M_PI * (k + 0.5) / (NCO_TABLE_SIZE * NCO_TABLE_SIZE);
+
+		m_coarse[k].re = (float) qCos(coarse);
+		m_coarse[k].im = (float) qSin(coarse);
+		m_fine[k].re = (float) qCos(fine);
+		m_fine[k].im = (float) qSin(fine);
+	}
+}
+
+QNco::~QNco() {
+}
+
+void QNco::setFrequency(qreal frequency, qreal sampleRate) {
+
+	if (sampleRate <= 0) return;
+
+	// turns per sample in units of 2^-32, wrapped for negative frequencies
+	qint64 inc = qRound64(frequency / sampleRate * 4294967296.0);
+	m_increment = (quint32) inc;
+}
+
+void QNco::reset() {
+
+	m_phase = 0;
+}
+
+void QNco::mix(const cpx *in, cpx *out, int n) {
+
+	quint32 phase = m_phase;
+	const quint32 inc = m_increment;
+
+	for (int i = 0; i < n; i++) {
+
+		const cpx &c = m_coarse[phase >> (32 - NCO_TABLE_BITS)];
+		const cpx &f = m_fine[(phase >> (32 - 2 * NCO_TABLE_BITS)) & (NCO_TABLE_SIZE - 1)];
+
+		float oscRe = c.re * f.re - c.im * f.im;
+		float oscIm = c.re * f.im + c.im * f.re;
+
+		float re = in[i].re;
+		float im = in[i].im;
+
+		out[i].re = re * oscRe - im * oscIm;
+		out[i].im = re * oscIm + im * oscRe;
+
+		phase += inc;
+	}
+
+	m_phase = phase;
+}
@@ -0,0 +1,94 @@
+/**
+* @file  qtdsp_nco.h
+* @brief numerically controlled oscillator header file for QtDSP
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef _QTDSP_NCO_H
+#define _QTDSP_NCO_H
+
+#include "qtdsp_qComplex.h"
+
+#include <QtGlobal>
+
+// the 32 bit phase: 10 bits coarse table, 10 bits fine table, 12 bits
+// below the resolution of the tables
+#define NCO_TABLE_BITS	10
+#define NCO_TABLE_SIZE	(1 << NCO_TABLE_BITS)
+// phase units per radian, 2^32 / (2 pi)
+#define NCO_PHASE_PER_RAD	683565275.57643158
+
+
+/*!
+	\class QNco
+	\brief Numerically controlled oscillator mixing a complex block with
+	exp(j * phase), the phase kept in a 32 bit accumulator.
+
+	The phasor is the product of a coarse table entry (upper 10 phase bits)
+	and a fine table entry (next 10 bits), i.e. the phase is resolved to
+	2^-20 of a turn. The phase truncation spurs stay near -120 dBc, and the
+	amplitude does not drift, as no sample depends on the previous one.
+
+	setFrequency() only changes the increment, the phase runs on without a
+	jump. mix() does not allocate; the tables are built by the constructor.
+*/
+class QNco {
+
+public:
+	QNco();
+	~QNco();
+
+	// frequency and sample rate in Hz; negative frequencies shift down
+	void	setFrequency(qreal frequency, qreal sampleRate);
+	void	reset();
+
+	quint32	phase() const		{ return m_phase; }
+	quint32	increment() const	{ return m_increment; }
+
+	// out[i] = in[i] * exp(j * phase), advancing the phase; in may equal out
+	void	mix(const cpx *in, cpx *out, int n);
+
+	// single steps, for a PLL that sets the increment sample by sample
+	cpx		phasor() const {
+
+		const cpx &c = m_coarse[m_phase >> (32 - NCO_TABLE_BITS)];
+		const cpx &f = m_fine[(m_phase >> (32 - 2 * NCO_TABLE_BITS)) & (NCO_TABLE_SIZE - 1)];
+
+		cpx z;
+		z.re = c.re * f.re - c.im * f.im;
+		z.im = c.re * f.im + c.im * f.re;
+		return z;
+	}
+
+	// advances the phase by \a radians, taken modulo 2 pi
+	void	advance(float radians)	{ m_phase += (quint32) qRound64(radians * NCO_PHASE_PER_RAD); }
+
+private:
+	cpx		m_coarse[NCO_TABLE_SIZE];
+	cpx		m_fine[NCO_TABLE_SIZE];
+
+	quint32	m_phase;
+	quint32	m_increment;
+};
+
+#endif // _QTDSP_NCO_H
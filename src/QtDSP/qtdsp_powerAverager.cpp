@@ -0,0 +1,127 @@
+/**
+* @file  qtdsp_powerAverager.cpp
+* @brief linear power averager class for QtDSP
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "qtdsp_powerAverager.h"
+#include "qtdsp_kernels.h"
+
+#include <string.h>
+
+
+QPowerAverager::QPowerAverager(int size)
+	: m_mode(ExponentialAveraging)
+	, m_size(0)
+	, m_length(1)
+	, m_cnt(0)
+{
+	setSize(size);
+}
+
+QPowerAverager::~QPowerAverager() {
+
+	m_acc.clear();
+	m_block.clear();
+}
+
+void QPowerAverager::setSize(int size) {
+
+	m_size = qMax(0, size);
+	m_acc.resize(m_size);
+	m_block.resize(m_size);
+
+	reset();
+}
+
+void QPowerAverager::setMode(SpectrumAveragingMode mode, int length) {
+
+	length = qMax(1, length);
+	if (mode == m_mode && length == m_length) return;
+
+	m_mode = mode;
+	m_length = length;
+
+	reset();
+}
+
+void QPowerAverager::reset() {
+
+	m_acc.fill(0.0f);
+	m_block.fill(0.0f);
+	m_cnt = 0;
+}
+
+bool QPowerAverager::ProcessPower(const float *in) {
+
+	float *acc = m_acc.data();
+
+	switch (m_mode) {
+
+		case ExponentialAveraging: {
+
+			// the running mean fills the average without a slow start from zero
+			if (m_cnt < m_length) m_cnt++;
+
+			float k = 1.0f / m_cnt;
+			for (int i = 0; i < m_size; i++)
+				acc[i] += k * (in[i] - acc[i]);
+
+			return true;
+		}
+
+		case WelchAveraging:
+
+			for (int i = 0; i < m_size; i++)
+				acc[i] += in[i];
+			break;
+
+		case PeakHoldAveraging:
+
+			QtDSP::peakHold(acc, in, m_size);
+			break;
+	}
+
+	if (++m_cnt < m_length) return false;
+
+	float *block = m_block.data();
+	if (m_mode == WelchAveraging) {
+
+		float k = 1.0f / m_length;
+		for (int i = 0; i < m_size; i++)
+			block[i] = k * acc[i];
+	}
+	else
+		memcpy(block, acc, m_size * sizeof(float));
+
+	// powers are >= 0, so zero also starts the next maximum
+	m_acc.fill(0.0f);
+	m_cnt = 0;
+
+	return true;
+}
+
+const float *QPowerAverager::result() const {
+
+	return m_mode == ExponentialAveraging ? m_acc.constData() : m_block.constData();
+}
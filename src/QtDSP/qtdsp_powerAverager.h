@@ -0,0 +1,77 @@
+/**
+* @file  qtdsp_powerAverager.h
+* @brief linear power averager header file for QtDSP
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef _QTDSP_POWER_AVERAGER_H
+#define _QTDSP_POWER_AVERAGER_H
+
+#include "../cusdr_settings.h"
+
+#include <QVector>
+
+
+/*!
+	\class QPowerAverager
+	\brief Averages power spectra in the linear domain, before the dB
+	conversion.
+
+	ExponentialAveraging: running mean over the first \a length spectra,
+	then an exponential average with weight 1/length; a result per spectrum.
+	WelchAveraging: mean of each block of \a length spectra; a result per
+	block. PeakHoldAveraging: maximum of each block of \a length spectra.
+
+	All buffers are allocated by setSize(); ProcessPower() does not allocate.
+*/
+class QPowerAverager {
+
+public:
+	QPowerAverager(int size = 0);
+	~QPowerAverager();
+
+	void	setSize(int size);
+	// restarts the average if mode or length changed
+	void	setMode(SpectrumAveragingMode mode, int length);
+	void	reset();
+
+	int		size() const	{ return m_size; }
+	int		length() const	{ return m_length; }
+	SpectrumAveragingMode	mode() const	{ return m_mode; }
+
+	// adds size() power values; returns true if result() holds a new average
+	bool	ProcessPower(const float *in);
+	const float	*result() const;
+
+private:
+	QVector<float>	m_acc;
+	QVector<float>	m_block;	// last finished block (Welch, peak hold)
+
+	SpectrumAveragingMode	m_mode;
+
+	int		m_size;
+	int		m_length;
+	int		m_cnt;
+};
+
+#endif // _QTDSP_POWER_AVERAGER_H
@@ -28,45 +28,44 @@
 #define LOG_POWERSPECTRUM
 
 #include "qtdsp_powerSpectrum.h"
+#include "qtdsp_kernels.h"
 
 PowerSpectrum::PowerSpectrum(QObject *parent, int size)
 	: QObject(parent)
 	, set(Settings::instance())
-	, first(true)
+	, m_averager(size*2)
+	, m_averaging(false)
+	, m_averageReady(false)
 	, m_size(size)
 	, m_spectrumSize(size*2)
 	, m_psswitch(0)
-	, m_averages(4)
+	, m_overlap(-1)
+	, m_hop(size)
+	, m_writePos(0)
+	, m_filled(0)
+	, m_newSamples(0)
 	, m_samplerate(set->getSampleRate())
 	, m_baseline((float)1.0e-15)
 	, m_correction(0.0f)
 {
     m_window = new float[m_size];
-	m_fPsdBm = new float[m_size * 2];
-	m_fAvePsdBm = new float[m_size * 2];
+	m_fPower = new float[m_size * 2];
 
-    windowCPX.resize(m_size);
-    tmpCPX.resize(m_size * 2);
-    dataCPX.resize(0);
-
-    zero.re = 0.0f;
-    zero.im = 0.0f;
+    dataCPX.resize(m_size);
 
     m_fft = new QFFT(m_size * 2);
 
-    memset(m_fPsdBm, 0, m_size * 2 * sizeof(float));
-	memset(m_fAvePsdBm, 0, m_size * 2 * sizeof(float));
+    memset(m_fPower, 0, m_size * 2 * sizeof(float));
     memset(m_window, 0, m_size  * sizeof(float));
 
     QFilter::MakeWindow(BLACKMANHARRIS_WINDOW, size, m_window);
 
-    for (int i = 0; i < m_size; i++) {
-
-        windowCPX[i].re = m_window[i];
-        windowCPX[i].im = m_window[i];
-    }
+	// the former complex window (1 + j) * w doubled the power; keep the
+	// calibration of the dBm values with a real window scaled by sqrt(2).
+	for (int i = 0; i < m_size; i++)
+		m_window[i] *= 1.41421356f;
 
-	cnt = 0;
+	setOverlap(SPECTRUM_OVERLAP);
 }
 
 PowerSpectrum::~PowerSpectrum() {
@@ -74,18 +73,11 @@ PowerSpectrum::~PowerSpectrum() {
 	if (m_fft)
 		delete m_fft;
 
-	windowCPX.clear();
-    tmpCPX.clear();
-    dataCPX.clear();
-
     if (m_window)
-    	delete m_window;
+    	delete [] m_window;
 
-    if (m_fPsdBm)
-    	delete m_fPsdBm;
-
-    if (m_fAvePsdBm)
-    	delete m_fAvePsdBm;
+    if (m_fPower)
+    	delete [] m_fPower;
 }
 
 void PowerSpectrum::setupConnections() {
@@ -121,36 +113,77 @@ void PowerSpectrum::setupConnections() {
 //	}
 //}
 
-void PowerSpectrum::ProcessSpectrum(CPX &in, int size, int maxCnt) {
+// writes \a size samples into the ring; without averaging no FFT here,
+// see spectrumResult()
+void PowerSpectrum::ProcessSpectrum(CPX &in, int size) {
+
+	const cpx *src = in.constData();
 
-	Q_UNUSED(size)
+	m_filled = qMin(m_filled + size, m_size);
+	m_newSamples = qMin(m_newSamples + size, m_size);
 
-	if (cnt < maxCnt) { // maxCnt = 1: 4096, maxCnt = 3: 8192, maxCnt = 7: 16384
+	// only the last m_size samples of a long block are kept
+	if (size > m_size) {
 
-    	dataCPX << in;
-    	//first = false;
-		cnt++;
-		return;
+		src += size - m_size;
+		size = m_size;
 	}
-	else {
 
-		dataCPX << in;
-		tmpCPX.fill(zero, m_size*2);
+	int first = qMin(size, m_size - m_writePos);
+	memcpy(dataCPX.data() + m_writePos, src, first * sizeof(cpx));
+	memcpy(dataCPX.data(), src + first, (size - first) * sizeof(cpx));
 
-		if (dataCPX.size() == m_size) {
+	m_writePos += size;
+	if (m_writePos >= m_size) m_writePos -= m_size;
 
-			for (int i = 0; i < m_size; i++)
-				tmpCPX[i] = MultCPX(dataCPX.at(i), windowCPX.at(i));
+	// averaging takes every hop, at most one per block
+	if (m_averaging && m_filled == m_size && m_newSamples >= m_hop) {
 
-			m_mutex.lock();
-			m_fft->DoFFTWMagnForward(tmpCPX, m_size * 2, m_baseline, m_correction, m_fPsdBm);
-			m_mutex.unlock();
-		}
+		computePower();
+		if (m_averager.ProcessPower(m_fPower))
+			m_averageReady = true;
+	}
+}
+
+// window, zero padding, FFT and |X|^2 in one pass over the ring, oldest
+// sample first
+void PowerSpectrum::computePower() {
 
-		//first = true;
-		cnt = 0;
-		dataCPX.resize(0);
+	m_fft->WindowedPower(dataCPX.constData(), m_window, m_size, m_fPower, m_writePos);
+	m_newSamples = 0;
+}
+
+// the ring starts over, e.g. when this size serves again after a pause
+void PowerSpectrum::clearHistory() {
+
+	m_writePos = 0;
+	m_filled = 0;
+	m_newSamples = 0;
+
+	m_averager.reset();
+	m_averageReady = false;
+}
+
+void PowerSpectrum::setAveraging(bool on, SpectrumAveragingMode mode, int length) {
+
+	if (on != m_averaging) {
+
+		m_averaging = on;
+		m_averager.reset();
+		m_averageReady = false;
 	}
+
+	m_averager.setMode(mode, length);
+}
+
+// 0, 50 or 75 % are the useful values; the hop is rounded to whole samples
+void PowerSpectrum::setOverlap(int percent) {
+
+	percent = qBound(0, percent, 95);
+	if (percent == m_overlap) return;
+
+	m_overlap = percent;
+	m_hop = qMax(1, m_size * (100 - percent) / 100);
 }
 
 void PowerSpectrum::setBaseLine(float value) {
@@ -179,30 +212,57 @@ void PowerSpectrum::setPsOn(int value) {
 //    return dBmSize();
 //}
 
+// Display bin j is X[half - 1 - shift - j], the index taken modulo the FFT
+// size (a power of 2): the upper half of the FFT first, both halves in
+// reverse order.
 int	PowerSpectrum::spectrumResult(qVectorFloat &buffer, int shift) {
 
 	if (buffer.size() == 0) return 0;
-	
+
 	m_mutex.lock();
 
-	memcpy(
-		(float *) buffer.data(),
-		(float *) &m_fPsdBm[shift],
-		4096 * sizeof(float));
+	const float *power;
+	if (m_averaging) {
 
-    m_mutex.unlock();
+		if (!m_averageReady) {
 
-	return buffer.size();
-}
+			m_mutex.unlock();
+			return 0;
+		}
+
+		m_averageReady = false;
+		power = m_averager.result();
+	}
+	else {
 
-void PowerSpectrum::setAverages(int value) {
+		if (m_filled < m_size || m_newSamples < m_hop) {
 
-	m_averages = value;
+			m_mutex.unlock();
+			return 0;
+		}
+
+		computePower();
+		power = m_fPower;
+	}
+
+	float *out = buffer.data();
+	int top = m_size - 1 - shift;
+	int mask = m_spectrumSize - 1;
+
+	for (int j = 0; j < 4096; j++)
+		out[j] = power[(top - j) & mask];
+
+	// the only dB conversion, once per displayed spectrum
+	QtDSP::powerDb(out, out, 4096, m_baseline, m_correction);
+
+    m_mutex.unlock();
+
+	return buffer.size();
 }
 
 float PowerSpectrum::grabPsPoint(int index) {
 	
-	return m_fPsdBm[index]; 
+	return QtDSP::fastDb(m_fPower[(m_size - 1 - index) & (m_spectrumSize - 1)] + m_baseline) + m_correction;
 }
 
 int	PowerSpectrum::dBmSize() const {
@@ -32,6 +32,7 @@
 #include "qtdsp_qComplex.h"
 #include "qtdsp_fft.h"
 #include "qtdsp_filter.h"
+#include "qtdsp_powerAverager.h"
 #include "../cusdr_settings.h"
 
 #include <QObject>
@@ -44,7 +45,27 @@
 #   define POWERSPECTRUM_DEBUG nullDebug()
 #endif
 
+// default overlap of successive spectra in percent
+#define SPECTRUM_OVERLAP	50
 
+
+/*!
+	\class PowerSpectrum
+	\brief Power spectrum in dB of the most recent \a size receiver samples,
+	zero padded to an FFT of 2 * \a size points.
+
+	ProcessSpectrum() writes the samples into a preallocated ring.
+	spectrumResult() runs the FFT on the ring only when the ring is full and
+	at least a hop of new samples came in since the last spectrum; the hop is
+	(100 - overlap) percent of the size. Called at the display rate, large
+	sizes are thus updated as often as the hop allows instead of once per
+	\a size samples.
+
+	With averaging on, ProcessSpectrum() runs the FFT for every hop instead
+	and feeds the linear power to a QPowerAverager; spectrumResult() then
+	returns each new average. Either way only the 4096 bins handed out are
+	converted to dB.
+*/
 class PowerSpectrum : public QObject {
 
 	Q_OBJECT 
@@ -53,23 +74,28 @@ public:
 	PowerSpectrum(QObject *parent = 0, int size = 0);
 	~PowerSpectrum();
 
-	void	ProcessSpectrum(CPX &in, int size, int maxCnt);
+	void	ProcessSpectrum(CPX &in, int size);
 	
 	//int		psdBmResults(float *buffer);
+	// returns 0 if no new spectrum is due
 	int		spectrumResult(qVectorFloat &buffer, int shift);
+	void	clearHistory();
 	
 	float	grabPsPoint(int index);
 
     void	setBaseLine(float value);
     void	setCorrection(float value);
     void	setPsOn(int value);
-	void	setAverages(int value);
+	void	setOverlap(int percent);
+	// \a length spectra per average; restarts the average on a change
+	void	setAveraging(bool on, SpectrumAveragingMode mode, int length);
 
 	int		dBmSize() const;// { return m_size * 2; }
 	int		psIsOn() const  { return m_psswitch;  }
-	int		averages() const { return m_averages; }
+	bool	averaging() const { return m_averaging; }
 	float	baseLine() const { return m_baseline; }
 	float	correction() const { return m_correction; }
+	int		overlap() const { return m_overlap; }
 
 public slots:
 	//void setSampleSize(int rx, int size);
@@ -79,30 +105,33 @@ private:
 
 	QMutex	m_mutex;
 
-	cpx		zero;
-	CPX		windowCPX;
-    CPX		tmpCPX;
-    CPX		dataCPX;
+	CPXBuffer	dataCPX;	// ring of the last m_size samples
 
 	QFFT*	m_fft;
 
-	bool	first;
+	QPowerAverager	m_averager;
+
+	bool	m_averaging;
+	bool	m_averageReady;
 
 	int		m_size;
 	int		m_spectrumSize;
 	int		m_psswitch;
-	int		m_averages;
-	int		cnt;
+	int		m_overlap;
+	int		m_hop;
+	int		m_writePos;
+	int		m_filled;
+	int		m_newSamples;
 
 	float	m_samplerate;
 	float	m_baseline;
     float	m_correction;
     
     float*	m_window;
-	float*	m_fPsdBm;
-	float*	m_fAvePsdBm;
+	float*	m_fPower;	// |X|^2 of the last FFT in FFT order
 
 	void	setupConnections();
+	void	computePower();
 };
 
 #endif // _QTDSP_POWERSPECTRUM_H
@@ -31,6 +31,7 @@
 
 #include <cmath>
 #include <limits>
+#include <string.h>
 #include <QString>
 #include <QVector>
 #include <QVector2D>
@@ -53,6 +54,64 @@ typedef QVector<cpx> CPX;
 
 Q_DECLARE_METATYPE (CPX)
 
+// alignment of CPXBuffer: covers SSE/AVX loads and fftwf_malloc
+#define CPX_ALIGNMENT	64
+
+/*!
+	\class CPXBuffer
+	\brief Fixed size cpx array on a CPX_ALIGNMENT byte boundary.
+
+	QVector (CPX) cannot take an allocator and does not guarantee more than
+	pointer alignment; arrays handed to the in-place QFFT functions and to
+	SIMD kernels are CPXBuffers instead. Not implicitly shared, the memory
+	only changes on resize().
+*/
+class CPXBuffer {
+
+public:
+	CPXBuffer(int size = 0)
+		: m_data(0)
+		, m_size(0)
+	{
+		resize(size);
+	}
+
+	~CPXBuffer() {
+
+		qFreeAligned(m_data);
+	}
+
+	// reallocates and clears the buffer if the size changes
+	void resize(int size) {
+
+		if (size == m_size) return;
+
+		qFreeAligned(m_data);
+		m_data = size > 0 ? (cpx *) qMallocAligned(size * sizeof(cpx), CPX_ALIGNMENT) : 0;
+		m_size = size;
+
+		clear();
+	}
+
+	void clear() {
+
+		if (m_data) memset(m_data, 0, m_size * sizeof(cpx));
+	}
+
+	cpx*		data()					{ return m_data; }
+	const cpx*	constData() const		{ return m_data; }
+	int			size() const			{ return m_size; }
+
+	cpx&		operator[](int i)		{ return m_data[i]; }
+	const cpx&	at(int i) const			{ return m_data[i]; }
+
+private:
+	Q_DISABLE_COPY(CPXBuffer)
+
+	cpx*	m_data;
+	int		m_size;
+};
+
 inline void InitCPX(CPX &vec, int size, float value) {
 
 	cpx zero;
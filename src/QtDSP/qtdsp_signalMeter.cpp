@@ -31,14 +31,48 @@
 
 #include "qtdsp_signalMeter.h"
 
+// the reading of a receiver without signal
+#define SMETER_FLOOR_DB		-80.0f
+
+// per-block factor of a first order smoothing with time constant \a tau;
+// 1 (no smoothing) for tau <= 0
+static inline float smoothingCoeff(float blockMs, float tau) {
+
+	return tau > 0.0f ? 1.0f - expf(-blockMs / tau) : 1.0f;
+}
+
 SignalMeter::SignalMeter(QObject *parent, int size)
 	: QObject(parent)
 	, set(Settings::instance())
 	, m_size(size)
-	, m_instValue(-80.0)
-	//, m_correction(59.0f)
-	, m_correction(-8.0f)
+	, m_coeffSize(0)
+	, m_holdLeft(0)
+	, m_holdLength(0)
+	, m_attackCoeff(1.0f)
+	, m_decayCoeff(1.0f)
+	, m_averageCoeff(1.0f)
+	, m_fallPerBlock(0.0f)
 {
+	m_setup.sampleRate = 48000;
+	//m_setup.correction = 59.0f;
+	m_setup.correction = -8.0f;
+	m_setup.attackMs = SMETER_RMS_ATTACK_MS;
+	m_setup.decayMs = SMETER_RMS_DECAY_MS;
+	m_setup.averageMs = SMETER_AVERAGE_MS;
+	m_setup.holdMs = SMETER_PEAK_HOLD_MS;
+	m_setup.fallDb = SMETER_PEAK_FALL_DB;
+
+	publishParams();
+	m_p = *m_params.readSlot();
+
+	m_rms = m_average = powf(10.0f, 0.1f * SMETER_FLOOR_DB);
+	m_peak = SMETER_FLOOR_DB;
+
+	m_reading.instant = SMETER_FLOOR_DB;
+	m_reading.rms = SMETER_FLOOR_DB;
+	m_reading.average = SMETER_FLOOR_DB;
+	m_reading.peak = SMETER_FLOOR_DB;
+	m_reading.blocks = 0;
 }
 
 SignalMeter::~SignalMeter() {
@@ -46,29 +80,132 @@ SignalMeter::~SignalMeter() {
 
 void SignalMeter::ProcessBlock(CPX &in, int bsize) {
 
-	Q_UNUSED(bsize)
+	const SMeterParams *params = m_params.readSlot();
+	if (params) {
+
+		m_p = *params;
+		m_coeffSize = 0;
+	}
+
+	if (bsize <= 0) return;
+	if (bsize != m_coeffSize)
+		updateCoefficients(bsize);
+
+    float power = QtDSP::energy(in.constData(), bsize);
+
+	// a decimated block has fewer samples of the same power: scale the
+	// sum to m_size samples so that the reading does not depend on the rate
+	if (bsize != m_size)
+		power *= (float) m_size / bsize;
+
+	power += 1.5E-45f;
 
-    float tmp = 0.0f;
+	m_rms += (power > m_rms ? m_attackCoeff : m_decayCoeff) * (power - m_rms);
+	m_average += m_averageCoeff * (power - m_average);
+
+	float instant = QtDSP::fastDb(power);
+
+	if (instant >= m_peak) {
+
+		m_peak = instant;
+		m_holdLeft = m_holdLength;
+	}
+	else if (m_holdLeft > 0)
+		m_holdLeft--;
+	else
+		m_peak = qMax(instant, m_peak - m_fallPerBlock);
+
+	m_reading.instant = instant;
+	m_reading.rms = QtDSP::fastDb(m_rms);
+	m_reading.average = QtDSP::fastDb(m_average);
+	m_reading.peak = m_peak;
+	m_reading.blocks++;
+}
+
+void SignalMeter::updateCoefficients(int bsize) {
+
+	float blockMs = 1000.0f * bsize / m_p.sampleRate;
+
+	m_attackCoeff = smoothingCoeff(blockMs, m_p.attackMs);
+	m_decayCoeff = smoothingCoeff(blockMs, m_p.decayMs);
+	m_averageCoeff = smoothingCoeff(blockMs, m_p.averageMs);
+
+	m_holdLength = qRound(m_p.holdMs / blockMs);
+	if (m_holdLeft > m_holdLength)
+		m_holdLeft = m_holdLength;
+
+	m_fallPerBlock = m_p.fallDb * blockMs / 1000.0f;
+	m_coeffSize = bsize;
+}
 
-    for (int i = 0; i < m_size; i++)
-    	tmp += (in.at(i).re * in.at(i).re + in.at(i).im * in.at(i).im);
+void SignalMeter::getReading(TSMeterReading &reading) const {
 
-    m_instValue = (float)(10.0f * log10(tmp + 1.5E-45));
+	reading.instant = m_reading.instant + m_p.correction;
+	reading.rms = m_reading.rms + m_p.correction;
+	reading.average = m_reading.average + m_p.correction;
+	reading.peak = m_reading.peak + m_p.correction;
+	reading.blocks = m_reading.blocks;
 }
 
 float SignalMeter::getInstFValue() const {
 
-	return m_instValue + m_correction;
+	return m_reading.instant + m_p.correction;
 }
 
 float SignalMeter::getCorrection() const {
 
-	return m_correction;
+	return m_p.correction;
 }
 
 void SignalMeter::setCorrection(const float value) {
 
-	if (m_correction == value) return;
-	
-	m_correction = value;
+	QMutexLocker locker(&m_mutex);
+
+	if (m_setup.correction == value) return;
+
+	m_setup.correction = value;
+	publishParams();
+}
+
+void SignalMeter::setSampleRate(int value) {
+
+	QMutexLocker locker(&m_mutex);
+
+	if (m_setup.sampleRate == value || value <= 0) return;
+
+	m_setup.sampleRate = value;
+	publishParams();
+}
+
+void SignalMeter::setRmsBallistics(float attackMs, float decayMs) {
+
+	QMutexLocker locker(&m_mutex);
+
+	m_setup.attackMs = attackMs;
+	m_setup.decayMs = decayMs;
+	publishParams();
+}
+
+void SignalMeter::setAverageTime(float ms) {
+
+	QMutexLocker locker(&m_mutex);
+
+	m_setup.averageMs = ms;
+	publishParams();
+}
+
+void SignalMeter::setPeakHold(float holdMs, float fallDb) {
+
+	QMutexLocker locker(&m_mutex);
+
+	m_setup.holdMs = holdMs;
+	m_setup.fallDb = fallDb;
+	publishParams();
+}
+
+// called with m_mutex held (or from the constructor)
+void SignalMeter::publishParams() {
+
+	m_params.writeSlot() = m_setup;
+	m_params.commitWrite();
 }
@@ -34,13 +34,51 @@
 
 #define SPECDBMOFFSET 100.50
 
+// default ballistics
+#define SMETER_RMS_ATTACK_MS	10.0f
+#define SMETER_RMS_DECAY_MS		300.0f
+#define SMETER_AVERAGE_MS		3000.0f
+#define SMETER_PEAK_HOLD_MS		2000.0f
+#define SMETER_PEAK_FALL_DB		40.0f	// per second, after the hold time
+
 #include <cmath>
 #include "qtdsp_qComplex.h"
+#include "qtdsp_kernels.h"
 #include "../cusdr_settings.h"
+#include "../Util/cusdr_frameRing.h"
 
 #include <QObject>
 #include <QMutex>
 
+struct SMeterParams {
+
+	int		sampleRate;		// of the metered signal
+	float	correction;		// dB
+	float	attackMs;		// rms track
+	float	decayMs;
+	float	averageMs;		// average track
+	float	holdMs;			// peak track
+	float	fallDb;			// dB per second
+};
+
+/*!
+	\class SignalMeter
+	\brief Meters the filtered signal at the decimated rate.
+
+	ProcessBlock() takes the block power from the vectorized
+	QtDSP::energy() kernel, scaled to m_size samples so that the reading
+	does not depend on the rate, and updates the tracks of a TSMeterReading:
+	the instantaneous block power, an rms track with separate attack and
+	decay time constants, a long-term average and a peak that is held for
+	holdMs and then falls by fallDb per second. rms and average are smoothed
+	on the linear power, not on the dB values.
+
+	The setters run on the GUI side and hand a SMeterParams snapshot to
+	ProcessBlock() through a QHMailbox; the per-block coefficients are
+	recomputed only when a snapshot arrives or the block size changes.
+	getReading() copies the current tracks, e.g. into the meter mailbox
+	the display polls.
+*/
 class SignalMeter : public QObject {
 
 	Q_OBJECT 
@@ -51,19 +89,43 @@ public:
 
 	void 	ProcessBlock(CPX &in, int bsize);
 
+	void	getReading(TSMeterReading &reading) const;
 	float 	getInstFValue() const;
 	float 	getCorrection() const;
 
 public slots:
 	void 	setCorrection(const float value);
+	void	setSampleRate(int value);
+	void	setRmsBallistics(float attackMs, float decayMs);
+	void	setAverageTime(float ms);
+	void	setPeakHold(float holdMs, float fallDb);
 
 private:
 	Settings	*set;
 
+	QHMailbox<SMeterParams>	m_params;
+	SMeterParams			m_p;		// copy of the DSP thread
+	SMeterParams			m_setup;	// of the setters, under m_mutex
+	QMutex					m_mutex;
+
+	TSMeterReading	m_reading;
+
     int 		m_size;
-    
-    float 		m_instValue;
-    float 		m_correction;
+    int			m_coeffSize;	// block size the coefficients are for
+
+    float		m_rms;			// linear power
+    float		m_average;
+    float		m_peak;			// dB
+    int			m_holdLeft;		// blocks before the peak starts falling
+
+    float		m_attackCoeff;
+    float		m_decayCoeff;
+    float		m_averageCoeff;
+    int			m_holdLength;	// hold time in blocks
+    float		m_fallPerBlock;	// dB
+
+    void		publishParams();
+    void		updateCoefficients(int bsize);
 };
 
 #endif // _QTDSP_SIGNALMETER_H
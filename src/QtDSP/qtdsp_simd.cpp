@@ -0,0 +1,153 @@
+/**
+* @file  qtdsp_simd.cpp
+* @brief SIMD support for QtDSP
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "qtdsp_simd.h"
+
+#if defined(QTDSP_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#elif defined(QTDSP_X86) && defined(__GNUC__)
+#include <cpuid.h>
+#endif
+
+#include <string.h>
+
+namespace QtDSP {
+
+#if defined(QTDSP_X86)
+
+static SimdLevel detectSimdLevel() {
+
+#if defined(__GNUC__)
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx2"))		return SimdAVX2;
+	if (__builtin_cpu_supports("sse4.1"))	return SimdSSE41;
+
+	return SimdNone;
+
+#elif defined(_MSC_VER)
+	int info[4];
+
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	bool sse41   = (info[2] & (1 << 19)) != 0;
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx     = (info[2] & (1 << 28)) != 0;
+
+	bool avx2 = false;
+	if (maxLeaf >= 7 && osxsave && avx) {
+
+		// the OS must save the YMM registers on context switches
+		if ((_xgetbv(0) & 0x6) == 0x6) {
+
+			__cpuidex(info, 7, 0);
+			avx2 = (info[1] & (1 << 5)) != 0;
+		}
+	}
+
+	if (avx2)	return SimdAVX2;
+	if (sse41)	return SimdSSE41;
+
+	return SimdNone;
+
+#else
+	return SimdNone;
+#endif
+}
+
+#endif // QTDSP_X86
+
+SimdLevel simdLevel() {
+
+#if defined(QTDSP_X86)
+	static const SimdLevel level = detectSimdLevel();
+	return level;
+#else
+	return SimdNone;
+#endif
+}
+
+#if defined(QTDSP_X86)
+
+// leaves 0x80000002 .. 0x80000004 hold the 48 character brand string
+static void readCpuModelName(char *name) {
+
+	unsigned int regs[12];
+	memset(regs, 0, sizeof(regs));
+
+#if defined(__GNUC__)
+	if (__get_cpuid_max(0x80000000, 0) < 0x80000004) return;
+
+	for (unsigned int i = 0; i < 3; i++)
+		__get_cpuid(0x80000002 + i, &regs[4*i], &regs[4*i + 1], &regs[4*i + 2], &regs[4*i + 3]);
+
+#elif defined(_MSC_VER)
+	int info[4];
+
+	__cpuid(info, 0x80000000);
+	if ((unsigned int) info[0] < 0x80000004) return;
+
+	for (int i = 0; i < 3; i++)
+		__cpuid((int *) &regs[4*i], 0x80000002 + i);
+#endif
+
+	memcpy(name, regs, 48);
+	name[48] = 0;
+
+	// the brand string may be padded with leading blanks
+	char *start = name;
+	while (*start == ' ') start++;
+	memmove(name, start, strlen(start) + 1);
+}
+
+#endif // QTDSP_X86
+
+const char *cpuModelName() {
+
+	static char name[49] = { 0 };
+
+#if defined(QTDSP_X86)
+	if (!name[0])
+		readCpuModelName(name);
+#endif
+
+	return name[0] ? name : "unknown";
+}
+
+const char *simdLevelName(SimdLevel level) {
+
+	switch (level) {
+
+		case SimdAVX2:	return "AVX2";
+		case SimdSSE41:	return "SSE4.1";
+		default:		return "scalar";
+	}
+}
+
+} // namespace QtDSP
@@ -0,0 +1,61 @@
+/**
+* @file  qtdsp_simd.h
+* @brief SIMD support header for QtDSP
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef _QTDSP_SIMD_H
+#define _QTDSP_SIMD_H
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#	define QTDSP_X86
+#endif
+
+// The SIMD code paths are compiled with per-function target attributes
+// (gcc, clang) so that the whole program does not need -mavx2; MSVC
+// accepts the intrinsics without any switch. Which path is taken is
+// decided once at run time.
+#if defined(QTDSP_X86) && defined(__GNUC__)
+#	define QTDSP_TARGET(t) __attribute__((target(t)))
+#else
+#	define QTDSP_TARGET(t)
+#endif
+
+namespace QtDSP {
+
+	enum SimdLevel {
+
+		SimdNone = 0,
+		SimdSSE41,
+		SimdAVX2
+	};
+
+	// highest instruction set supported by CPU and OS
+	SimdLevel	simdLevel();
+	const char*	simdLevelName(SimdLevel level);
+
+	// processor brand string (cpuid), "unknown" if not available
+	const char*	cpuModelName();
+}
+
+#endif // _QTDSP_SIMD_H
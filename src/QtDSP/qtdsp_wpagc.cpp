@@ -36,6 +36,7 @@
 QWPAGC::QWPAGC(QObject *parent, int size)
 	: QObject(parent)
 	, set(Settings::instance())
+	, m_agcMode(agcOFF)
 	, m_size(size)
 	, m_samplerate(set->getSampleRate())
 	, m_nTau(4)
@@ -45,6 +46,9 @@ QWPAGC::QWPAGC(QObject *parent, int size)
 	, m_state(0)
 	, m_hangCounter(0)
 	, m_decayType(0)
+	, m_resetCount(0)
+	, m_queueHead(0)
+	, m_queueCount(0)
 	, m_fixedGain(1000)
 	, m_tauAttack(0.001)
 	, m_tauDecay(0.250)
@@ -84,7 +88,6 @@ QWPAGC::QWPAGC(QObject *parent, int size)
 	, m_hang_decay_mult(0.0)
 	, SinAverage(0.637)
 {
-	InitCPX(buf, m_size, 0.0f);
 	InitCPX(ring, RINGBUFFERSIZE, 0.0f);
 
 	outSample.re = 0.0f;
@@ -93,12 +96,16 @@ QWPAGC::QWPAGC(QObject *parent, int size)
 	absRing.resize(RINGBUFFERSIZE);
 	absRing.fill(0.0);
 
+	m_maxQueue.resize(RINGBUFFERSIZE);
+
+	publishParams();
+	m_p = *m_params.readSlot();
+
 	initWcpAGC();
 }
 
 QWPAGC::~QWPAGC() {
 
-	buf.clear();
 	ring.clear();
 }
 
@@ -108,23 +115,26 @@ QWPAGC::~QWPAGC() {
 
 void  QWPAGC::ProcessAGC(CPX &in, CPX &out, int size) {
 
-	Q_UNUSED(size)
+	// the latest settings, if any were published since the last block
+	const WcpAGCParams *params = m_params.readSlot();
+	if (params)
+		applyParams(*params);
 
-	if (m_agcMode == agcOFF) {
+	// size is the decimated block size, at most m_size
+	if (m_p.agcMode == agcOFF) {
 		
-		for (int i = 0; i < m_size; i++)
-			out[i] = ScaleCPX(in.at(i), m_fixedGain);
+		for (int i = 0; i < size; i++)
+			out[i] = ScaleCPX(in.at(i), m_p.fixedGain);
 
 		return;
 	}
 
-	memcpy(buf.data(), in.data(), sizeof(cpx) * m_size);
+	const cpx *x = in.constData();
+	cpx *y = out.data();
+	cpx *r = ring.data();
+	qreal *peak = absRing.data();
 
-	int i, j, k;
-	//qreal mult;
-	
-	mutex.lock();
-	for (i = 0; i < m_size; i++) {
+	for (int i = 0; i < size; i++) {
 
 		if (++m_outIndex >= RINGBUFFERSIZE)
 			m_outIndex -= RINGBUFFERSIZE;
@@ -132,38 +142,25 @@ void  QWPAGC::ProcessAGC(CPX &in, CPX &out, int size) {
 		if (++m_inIndex >= RINGBUFFERSIZE)
 			m_inIndex -= RINGBUFFERSIZE;
 		
-		outSample.re = ring.at(m_outIndex).re;
-		outSample.im = ring.at(m_outIndex).im;
+		outSample = r[m_outIndex];
+		m_abs_out_sample = peak[m_outIndex];
 
-		//m_abs_out_sample = absRing[m_out_index];
-		m_abs_out_sample = absRing.at(m_outIndex);
-
-		ring[m_inIndex].re = buf.at(i).re;
-		ring[m_inIndex].im = buf.at(i).im;
-
-		absRing[m_inIndex] = qMax(qAbs(ring.at(m_inIndex).re), qAbs(ring.at(m_inIndex).im));
+		r[m_inIndex] = x[i];
+		peak[m_inIndex] = qMax(qAbs(x[i].re), qAbs(x[i].im));
 		
-		m_fast_backaverage = m_fast_backmult * m_abs_out_sample + m_onemfast_backmult * m_fast_backaverage;
-		m_hang_backaverage = m_hang_backmult * m_abs_out_sample + m_onemhang_backmult * m_hang_backaverage;
+		m_fast_backaverage = m_p.fast_backmult * m_abs_out_sample + m_p.onemfast_backmult * m_fast_backaverage;
+		m_hang_backaverage = m_p.hang_backmult * m_abs_out_sample + m_p.onemhang_backmult * m_hang_backaverage;
 		
-		if ((m_abs_out_sample >= m_ring_max) && (m_abs_out_sample > 0)) {
-			
-			m_ring_max = 0.0;
-			k = m_outIndex;
-			
-			for (j = 0; j < m_attackBuffersize; j++) {
-				
-				if (++k == RINGBUFFERSIZE)
-					k = 0;
-				if (absRing[k] > m_ring_max)
-					//m_ring_max = absRing[k];
-					m_ring_max = absRing.at(k);
-			}
+		// the outgoing sample leaves the window, the incoming one enters it
+		if (m_queueCount > 0 && m_maxQueue[m_queueHead] == m_outIndex) {
+
+			if (++m_queueHead == RINGBUFFERSIZE)
+				m_queueHead = 0;
+			m_queueCount--;
 		}
-		
-		if (absRing[m_inIndex] > m_ring_max)
-			//m_ring_max = absRing[m_in_index];
-			m_ring_max = absRing.at(m_inIndex);
+
+		pushMax(m_inIndex);
+		m_ring_max = peak[m_maxQueue[m_queueHead]];
 		
 		if (m_hangCounter > 0)
 			--m_hangCounter;
@@ -174,26 +171,26 @@ void  QWPAGC::ProcessAGC(CPX &in, CPX &out, int size) {
 				
 				if (m_ring_max >= m_volts) {
 
-					m_volts += (m_ring_max - m_volts) * m_attack_mult;
+					m_volts += (m_ring_max - m_volts) * m_p.attack_mult;
 				}				
 				else {
 					if (m_volts > m_pop_ratio * m_fast_backaverage) {
 						
 						m_state = 1;
-						m_volts += (m_ring_max - m_volts) * m_fast_decay_mult;
+						m_volts += (m_ring_max - m_volts) * m_p.fast_decay_mult;
 					}
 					else {
 						
-						if (m_hang_backaverage > m_hangLevel) {
+						if (m_hang_backaverage > m_p.hangLevel) {
 							
 							m_state = 2;
-							m_hangCounter = (int)(m_hangtime * m_samplerate);
+							m_hangCounter = m_p.hangSamples;
 							m_decayType = 1;
 						}
 						else {
 							
 							m_state = 3;
-							m_volts += (m_ring_max - m_volts) * m_decay_mult;
+							m_volts += (m_ring_max - m_volts) * m_p.decay_mult;
 							m_decayType = 0;
 						}
 					}
@@ -205,13 +202,13 @@ void  QWPAGC::ProcessAGC(CPX &in, CPX &out, int size) {
 				if (m_ring_max >= m_volts) {
 					
 					m_state = 0;
-					m_volts += (m_ring_max - m_volts) * m_attack_mult;
+					m_volts += (m_ring_max - m_volts) * m_p.attack_mult;
 				}
 				else {
 					
 					if (m_volts > m_save_volts) {
 
-						m_volts += (m_ring_max - m_volts) * m_fast_decay_mult;
+						m_volts += (m_ring_max - m_volts) * m_p.fast_decay_mult;
 					}
 					else {
 						
@@ -224,12 +221,12 @@ void  QWPAGC::ProcessAGC(CPX &in, CPX &out, int size) {
 							if (m_decayType == 0) {
 								
 								m_state = 3;
-								m_volts += (m_ring_max - m_volts) * m_decay_mult;
+								m_volts += (m_ring_max - m_volts) * m_p.decay_mult;
 							}
 							else {
 								
 								m_state = 4;
-								m_volts += (m_ring_max - m_volts) * m_hang_decay_mult;
+								m_volts += (m_ring_max - m_volts) * m_p.hang_decay_mult;
 							}
 						}
 					}
@@ -242,14 +239,14 @@ void  QWPAGC::ProcessAGC(CPX &in, CPX &out, int size) {
 					
 					m_state = 0;
 					m_save_volts = m_volts;
-					m_volts += (m_ring_max - m_volts) * m_attack_mult;
+					m_volts += (m_ring_max - m_volts) * m_p.attack_mult;
 				}
 				else {
 					
 					if (m_hangCounter == 0) {
 						
 						m_state = 4;
-						m_volts += (m_ring_max - m_volts) * m_hang_decay_mult;
+						m_volts += (m_ring_max - m_volts) * m_p.hang_decay_mult;
 					}
 				}
 				break;
@@ -260,11 +257,11 @@ void  QWPAGC::ProcessAGC(CPX &in, CPX &out, int size) {
 					
 					m_state = 0;
 					m_save_volts = m_volts;
-					m_volts += (m_ring_max - m_volts) * m_attack_mult;
+					m_volts += (m_ring_max - m_volts) * m_p.attack_mult;
 				}
 				else {
 
-					m_volts += (m_ring_max - m_volts) * m_decay_mult;
+					m_volts += (m_ring_max - m_volts) * m_p.decay_mult;
 				}
 				break;
 			
@@ -274,27 +271,117 @@ void  QWPAGC::ProcessAGC(CPX &in, CPX &out, int size) {
 					
 					m_state = 0;
 					m_save_volts = m_volts;
-					m_volts += (m_ring_max - m_volts) * m_attack_mult;
+					m_volts += (m_ring_max - m_volts) * m_p.attack_mult;
 				}
 				else {
 					
-					m_volts += (m_ring_max - m_volts) * m_hang_decay_mult;
+					m_volts += (m_ring_max - m_volts) * m_p.hang_decay_mult;
 				}
 				
 				break;
 		} // end switch on state
 		
-		if (m_volts < m_minVolts)
-			m_volts = m_minVolts;
+		if (m_volts < m_p.minVolts)
+			m_volts = m_p.minVolts;
 		
-		mult = (m_out_target - m_slope_constant * qMin(0.0, log10 (m_inv_max_input * m_volts))) / m_volts;
+		qreal mult = (m_p.out_target - m_p.slope_constant * qMin(0.0, log10 (m_p.inv_max_input * m_volts))) / m_volts;
 		
-		out[i].re = (float)(outSample.re * mult);
-		out[i].im = (float)(outSample.im * mult);
+		y[i].re = (float)(outSample.re * mult);
+		y[i].im = (float)(outSample.im * mult);
 	}
-	mutex.unlock();
 }
 
+// appends ring position k behind all entries with a larger magnitude
+inline void QWPAGC::pushMax(int k) {
+
+	const qreal *peak = absRing.constData();
+	qreal value = peak[k];
+
+	while (m_queueCount > 0) {
+
+		int back = m_queueHead + m_queueCount - 1;
+		if (back >= RINGBUFFERSIZE)
+			back -= RINGBUFFERSIZE;
+
+		if (peak[m_maxQueue[back]] > value)
+			break;
+
+		m_queueCount--;
+	}
+
+	int pos = m_queueHead + m_queueCount;
+	if (pos >= RINGBUFFERSIZE)
+		pos -= RINGBUFFERSIZE;
+
+	m_maxQueue[pos] = k;
+	m_queueCount++;
+}
+
+// puts the input index attackBuffersize samples ahead of the output index
+// and refills the deque from the window between them
+void QWPAGC::alignWindow() {
+
+	m_inIndex = m_outIndex + m_p.attackBuffersize;
+	if (m_inIndex >= RINGBUFFERSIZE)
+		m_inIndex -= RINGBUFFERSIZE;
+
+	m_queueHead = 0;
+	m_queueCount = 0;
+
+	int k = m_outIndex;
+	for (int j = 0; j < m_p.attackBuffersize; j++) {
+
+		if (++k == RINGBUFFERSIZE)
+			k = 0;
+		pushMax(k);
+	}
+
+	m_ring_max = (m_queueCount > 0) ? absRing.at(m_maxQueue[m_queueHead]) : 0.0;
+}
+
+// DSP side: takes over a snapshot published by the setters
+void QWPAGC::applyParams(const WcpAGCParams &params) {
+
+	bool reset = params.resetCount != m_p.resetCount;
+	bool resize = params.attackBuffersize != m_p.attackBuffersize;
+
+	m_p = params;
+
+	if (reset)
+		initWcpAGC();
+	else if (resize)
+		alignWindow();
+}
+
+// GUI side: hands the current constants to ProcessAGC()
+void QWPAGC::publishParams() {
+
+	WcpAGCParams &p = m_params.writeSlot();
+
+	p.agcMode = m_agcMode;
+	p.resetCount = m_resetCount;
+	p.attackBuffersize = m_attackBuffersize;
+	p.hangSamples = (int)(m_hangtime * m_samplerate);
+
+	p.fixedGain = m_fixedGain;
+	p.attack_mult = m_attack_mult;
+	p.decay_mult = m_decay_mult;
+	p.fast_decay_mult = m_fast_decay_mult;
+	p.fast_backmult = m_fast_backmult;
+	p.onemfast_backmult = m_onemfast_backmult;
+	p.hang_backmult = m_hang_backmult;
+	p.onemhang_backmult = m_onemhang_backmult;
+	p.hang_decay_mult = m_hang_decay_mult;
+	p.out_target = m_out_target;
+	p.minVolts = m_minVolts;
+	p.slope_constant = m_slope_constant;
+	p.inv_max_input = m_inv_max_input;
+	p.hangLevel = m_hangLevel;
+
+	m_params.commitWrite();
+}
+
+
 void QWPAGC::initWcpAGC() {
 
 	m_outIndex = -1;
@@ -318,6 +405,8 @@ void QWPAGC::initWcpAGC() {
 	outSample.im = 0.0f;
 	m_abs_out_sample = 0.0f;
 	m_decayType = 0;
+
+	alignWindow();
 }
 
 void QWPAGC::loadWcpAGC() {
@@ -325,8 +414,6 @@ void QWPAGC::loadWcpAGC() {
 	qreal tmp;
 	m_attackBuffersize = (int)qCeil(m_samplerate * m_nTau * m_tauAttack);
 	
-	m_inIndex = m_attackBuffersize + m_outIndex;
-	
 	m_attack_mult = 1.0 - qExp(-1.0 / (m_samplerate * m_tauAttack));
 	m_decay_mult = 1.0 - qExp(-1.0 / (m_samplerate * m_tauDecay));
 	m_fast_decay_mult = 1.0 - qExp(-1.0 / (m_samplerate * m_tau_fast_decay));
@@ -362,6 +449,8 @@ void QWPAGC::loadWcpAGC() {
 	
 	m_hang_decay_mult = 1.0 - qExp(-1.0 / (m_samplerate * m_tau_hang_decay));
 
+	publishParams();
+
 	emit displayValues(this, m_receiver, m_minVolts, 20.0 * log10(m_hangLevel / SinAverage));
 }
 
@@ -372,8 +461,9 @@ void QWPAGC::setReceiver(int rx) {
 
 void QWPAGC::setMode(AGCMode mode) {
 
-    //mutex.lock();
-	if ((m_agcMode == (AGCMode) agcOFF) && (mode != 0)) initWcpAGC();
+    mutex.lock();
+	// ProcessAGC() clears the ring when it sees the new reset count
+	if ((m_agcMode == (AGCMode) agcOFF) && (mode != 0)) m_resetCount++;
 
     m_agcMode = mode;
 	
@@ -424,7 +514,9 @@ void QWPAGC::setMode(AGCMode mode) {
 			m_tauDecay = 2.0;
 			break;
     }
-    //mutex.unlock();
+
+    publishParams();
+    mutex.unlock();
 }
 
 void QWPAGC::setAGCHangEnable(bool value) {
@@ -435,7 +527,10 @@ void QWPAGC::setAGCHangEnable(bool value) {
 // fixed_gain when AGC is OFF (set to 'fixed'), linear
 void QWPAGC::setAGCFixedGain(qreal value) {
 
+	mutex.lock();
 	m_fixedGain = value;
+	publishParams();
+	mutex.unlock();
 }
 
 qreal QWPAGC::getAGCFixedGain() {
@@ -449,8 +544,11 @@ void QWPAGC::setAGCFixedGainDb(qreal value) {
 	qreal tmp = value;
 	if (tmp > 60.0) tmp = 60.0;
 
+	mutex.lock();
 	m_fixedGain = qPow(10.0, tmp / 20.0);
 	//WPAGC_DEBUG << "m_fixedGain = " << m_fixedGain;
+	publishParams();
+	mutex.unlock();
 }
 
 qreal QWPAGC::getAGCFixedGainDb() {
@@ -462,11 +560,11 @@ void QWPAGC::setSampleRate(QObject *sender, int value) {
 
 	Q_UNUSED(sender)
 
-	//mutex.lock();
+	mutex.lock();
 	m_samplerate = value;
-	initWcpAGC();
+	m_resetCount++;
 	loadWcpAGC();
-	//mutex.unlock();
+	mutex.unlock();
 }
 
 // attack time constant in SECONDS
@@ -35,6 +35,7 @@
 
 #include "qtdsp_qComplex.h"
 #include "../cusdr_settings.h"
+#include "../Util/cusdr_frameRing.h"
 
 #include <QObject>
 #include <QMutex>
@@ -49,6 +50,21 @@
 #endif
 
 
+/*!
+	\class QWPAGC
+	\brief Look-ahead AGC after Warren Pratt, NR0V.
+
+	The peak of the attack window in absRing is kept by a monotonic deque of
+	ring positions with decreasing magnitudes: the front is the window
+	maximum, each sample is pushed and popped at most once, so the peak costs
+	amortized O(1) per sample whatever the signal.
+
+	The setters run on the GUI side. They compute the loop constants under
+	their own mutex and hand them to ProcessAGC() as a WcpAGCParams snapshot
+	through a QHMailbox, which ProcessAGC() picks up at the start of a block
+	without taking a lock. Resets of the ring are requested in the snapshot
+	and carried out by ProcessAGC() itself.
+*/
 class QWPAGC : public QObject {
 
 	Q_OBJECT 
@@ -89,15 +105,42 @@ public slots:
 	qreal getHangLevelDb();
 
 private:
+	// everything ProcessAGC() reads from the settings
+	struct WcpAGCParams {
+
+		AGCMode	agcMode;
+		int		resetCount;
+		int		attackBuffersize;
+		int		hangSamples;
+
+		qreal	fixedGain;
+		qreal	attack_mult;
+		qreal	decay_mult;
+		qreal	fast_decay_mult;
+		qreal	fast_backmult;
+		qreal	onemfast_backmult;
+		qreal	hang_backmult;
+		qreal	onemhang_backmult;
+		qreal	hang_decay_mult;
+		qreal	out_target;
+		qreal	minVolts;
+		qreal	slope_constant;
+		qreal	inv_max_input;
+		qreal	hangLevel;
+	};
+
 	Settings		*set;
 
+	// serializes the setters; ProcessAGC() does not take it
 	QMutex			mutex;
 	//QVector<qreal>	m_abs_ring;
 
+	QHMailbox<WcpAGCParams>	m_params;
+	WcpAGCParams	m_p;		// the snapshot ProcessAGC() works with
+
 	AGCMode			m_agcMode;
 
 	CPX				ring;
-	CPX				buf;
 	cpx				outSample;
 
 	bool	m_agcHangEnable;
@@ -112,6 +155,12 @@ private:
 	int		m_state;
 	int		m_hangCounter;
 	int		m_decayType;
+	int		m_resetCount;
+
+	// monotonic deque of absRing positions, front = window maximum
+	QVector<int>	m_maxQueue;
+	int		m_queueHead;
+	int		m_queueCount;
 
 	qreal	m_fixedGain;
 	qreal	m_tauAttack;
@@ -148,8 +197,6 @@ private:
 	qreal	m_hang_backmult;
 	qreal	m_onemhang_backmult;
 	
-	qreal mult;
-	
 	qreal	m_hangtime;
 	qreal	m_hangThresh;
 	qreal	m_hangLevel;
@@ -162,6 +209,10 @@ private:
 	
 	void	initWcpAGC();
 	void	loadWcpAGC();
+	void	publishParams();
+	void	applyParams(const WcpAGCParams &params);
+	void	alignWindow();
+	void	pushMax(int k);
 
 	bool	getAGCHangEnable()	{ return m_agcHangEnable; }
 
@@ -0,0 +1,477 @@
+/**
+* @file  cusdr_frameRing.h
+* @brief lock-free single-producer/single-consumer frame ring header file for cuSDR
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef CUSDR_FRAMERING_H
+#define CUSDR_FRAMERING_H
+
+#include <QtGlobal>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+
+#include <string.h>
+
+#define FRAMERING_CACHE_LINE	64
+
+// Producer and consumer indices of the rings live on separate cache lines,
+// each together with the cached copy of the other side's index.
+struct QHRingProducer {
+
+	QAtomicInt	head;
+	quint32		tailCache;
+	char		pad[FRAMERING_CACHE_LINE - sizeof(QAtomicInt) - sizeof(quint32)];
+};
+
+struct QHRingConsumer {
+
+	QAtomicInt	tail;
+	quint32		headCache;
+	char		pad[FRAMERING_CACHE_LINE - sizeof(QAtomicInt) - sizeof(quint32)];
+};
+
+/*!
+	\class QHFrameRing
+	\brief Fixed capacity ring of preallocated frame slots for exactly one
+	producer thread and one consumer thread.
+
+	The producer copies a frame into the next free slot (or fills it in place
+	via writeSlot()/commitWrite()), the consumer reads it in place via
+	readSlot()/commitRead(). No locks and no heap allocations are involved as
+	long as the consumer finds data; only an empty ring makes the consumer
+	sleep on a wait condition. A full ring drops the new frame and counts an
+	overrun instead of blocking the producer (the network thread).
+
+	\a Slots must be a power of two, \a SlotSize is the slot size in bytes.
+*/
+template<int Slots, int SlotSize> class QHFrameRing {
+
+	Q_STATIC_ASSERT((Slots & (Slots - 1)) == 0);
+
+public:
+	QHFrameRing()
+		: m_released(0)
+		, m_overruns(0)
+		, m_maxCount(0)
+	{
+		// vector loads of a reader may run FRAMERING_CACHE_LINE bytes over the last slot
+		m_data = (char *) qMallocAligned((size_t) Slots * SlotSize + FRAMERING_CACHE_LINE, FRAMERING_CACHE_LINE);
+		memset(m_data, 0, (size_t) Slots * SlotSize + FRAMERING_CACHE_LINE);
+		memset(m_length, 0, sizeof(m_length));
+		memset(m_timestamp, 0, sizeof(m_timestamp));
+
+		m_prod.tailCache = 0;
+		m_cons.headCache = 0;
+	}
+
+	~QHFrameRing() {
+
+		qFreeAligned(m_data);
+	}
+
+	// producer side
+
+	char *writeSlot() {
+
+		quint32 head = (quint32) m_prod.head.load();
+
+		if (head - m_prod.tailCache == (quint32) Slots) {
+
+			m_prod.tailCache = (quint32) m_cons.tail.loadAcquire();
+			if (head - m_prod.tailCache == (quint32) Slots) {
+
+				m_overruns.fetchAndAddRelaxed(1);
+				return 0;
+			}
+		}
+		return m_data + (head & (Slots - 1)) * SlotSize;
+	}
+
+	// number of slots the producer can fill before the next commit
+	int freeSlots() {
+
+		quint32 head = (quint32) m_prod.head.load();
+		m_prod.tailCache = (quint32) m_cons.tail.loadAcquire();
+
+		return Slots - (int)(head - m_prod.tailCache);
+	}
+
+	// slot \a offset positions after the next one to be committed; the caller
+	// must have checked freeSlots() and commits the slots in order.
+	char *writeSlotAt(int offset) {
+
+		quint32 head = (quint32) m_prod.head.load();
+		return m_data + ((head + offset) & (Slots - 1)) * SlotSize;
+	}
+
+	void countOverrun() {
+
+		m_overruns.fetchAndAddRelaxed(1);
+	}
+
+	void commitWrite(int length = SlotSize, qint64 timestamp = 0) {
+
+		quint32 head = (quint32) m_prod.head.load();
+		m_length[head & (Slots - 1)] = length;
+		m_timestamp[head & (Slots - 1)] = timestamp;
+
+		// the cached tail only lags behind, so the count taken from it is an
+		// upper bound; refresh it only when that bound exceeds the high-water
+		// mark, which keeps the consumer's cache line mostly untouched
+		int count = (int)(head + 1 - m_prod.tailCache);
+		if (count > m_maxCount.load()) {
+
+			m_prod.tailCache = (quint32) m_cons.tail.loadAcquire();
+			count = (int)(head + 1 - m_prod.tailCache);
+			if (count > m_maxCount.load()) m_maxCount.store(count);
+		}
+
+		// full barrier: pairs with the consumer publishing m_waiting
+		m_prod.head.fetchAndStoreOrdered((int)(head + 1));
+
+		if (m_waiting.load()) {
+
+			QMutexLocker locker(&m_waitMutex);
+			m_wakeUp.wakeOne();
+		}
+	}
+
+	bool enqueue(const char *data, int length, qint64 timestamp = 0) {
+
+		char *slot = writeSlot();
+		if (!slot) return false;
+
+		if (length > SlotSize) length = SlotSize;
+		memcpy(slot, data, length);
+		commitWrite(length, timestamp);
+
+		return true;
+	}
+
+	// consumer side
+
+	// blocks until a frame is available; returns 0 if woken by releaseWaiting().
+	const char *readSlot(int *length = 0) {
+
+		quint32 tail = (quint32) m_cons.tail.load();
+
+		if (tail == m_cons.headCache) {
+
+			m_cons.headCache = (quint32) m_prod.head.loadAcquire();
+			if (tail == m_cons.headCache) {
+
+				QMutexLocker locker(&m_waitMutex);
+				m_waiting.fetchAndStoreOrdered(1);
+
+				while ((m_cons.headCache = (quint32) m_prod.head.loadAcquire()) == tail) {
+
+					if (m_released.fetchAndStoreOrdered(0)) {
+
+						m_waiting.fetchAndStoreOrdered(0);
+						return 0;
+					}
+					m_wakeUp.wait(&m_waitMutex);
+				}
+				m_waiting.fetchAndStoreOrdered(0);
+			}
+		}
+
+		if (length) *length = m_length[tail & (Slots - 1)];
+		return m_data + (tail & (Slots - 1)) * SlotSize;
+	}
+
+	const char *tryReadSlot(int *length = 0) {
+
+		quint32 tail = (quint32) m_cons.tail.load();
+
+		if (tail == m_cons.headCache) {
+
+			m_cons.headCache = (quint32) m_prod.head.loadAcquire();
+			if (tail == m_cons.headCache) return 0;
+		}
+
+		if (length) *length = m_length[tail & (Slots - 1)];
+		return m_data + (tail & (Slots - 1)) * SlotSize;
+	}
+
+	// receive time stamp (ns) of the frame returned by the last readSlot()
+	qint64 readTimestamp() const {
+
+		return m_timestamp[(quint32) m_cons.tail.load() & (Slots - 1)];
+	}
+
+	void commitRead() {
+
+		m_cons.tail.storeRelease(m_cons.tail.load() + 1);
+	}
+
+	// drops all pending frames; must be called from the consumer side
+	// or while the consumer is stopped.
+	void clear() {
+
+		m_cons.tail.storeRelease(m_prod.head.loadAcquire());
+		m_released.store(0);
+	}
+
+	// wakes a consumer blocked in readSlot() without a frame.
+	void releaseWaiting() {
+
+		QMutexLocker locker(&m_waitMutex);
+		m_released.fetchAndStoreOrdered(1);
+		m_wakeUp.wakeAll();
+	}
+
+	// occupancy and overrun counters
+
+	bool isEmpty() const	{ return count() == 0; }
+	bool isFull() const		{ return count() == Slots; }
+	int  capacity() const	{ return Slots; }
+	int  slotSize() const	{ return SlotSize; }
+
+	int count() const {
+
+		return (int)((quint32) m_prod.head.loadAcquire() - (quint32) m_cons.tail.loadAcquire());
+	}
+
+	int overruns() const	{ return m_overruns.load(); }
+	int maxCount() const	{ return m_maxCount.load(); }
+
+	void resetCounters() {
+
+		m_overruns.store(0);
+		m_maxCount.store(0);
+	}
+
+private:
+	Q_DISABLE_COPY(QHFrameRing)
+
+	QHRingProducer	m_prod;
+	QHRingConsumer	m_cons;
+
+	char*			m_data;
+	int				m_length[Slots];
+	qint64			m_timestamp[Slots];
+
+	QAtomicInt		m_waiting;
+	QAtomicInt		m_released;
+	QAtomicInt		m_overruns;
+	QAtomicInt		m_maxCount;
+
+	QMutex			m_waitMutex;
+	QWaitCondition	m_wakeUp;
+};
+
+/*!
+	\class QHBlockRing
+	\brief Lock-free single-producer/single-consumer ring of \a Slots
+	preallocated objects of type \a T (e.g. DSP sample blocks).
+
+	The producer fills writeSlot() in place and publishes it with
+	commitWrite(), the consumer processes readSlot() in place and hands it
+	back with commitRead(). Nothing is copied or allocated; the ring never
+	blocks, a full ring returns 0 from writeSlot() and counts an overrun.
+*/
+template<class T, int Slots> class QHBlockRing {
+
+	Q_STATIC_ASSERT((Slots & (Slots - 1)) == 0);
+
+public:
+	QHBlockRing()
+		: m_overruns(0)
+	{
+		m_prod.tailCache = 0;
+		m_cons.headCache = 0;
+	}
+
+	// direct access for initialization, before the ring is in use
+	T &at(int i)	{ return m_slots[i]; }
+
+	// producer side
+
+	T *writeSlot() {
+
+		quint32 head = (quint32) m_prod.head.load();
+
+		if (head - m_prod.tailCache == (quint32) Slots) {
+
+			m_prod.tailCache = (quint32) m_cons.tail.loadAcquire();
+			if (head - m_prod.tailCache == (quint32) Slots) return 0;
+		}
+		return &m_slots[head & (Slots - 1)];
+	}
+
+	void commitWrite() {
+
+		m_prod.head.storeRelease(m_prod.head.load() + 1);
+	}
+
+	void countOverrun() {
+
+		m_overruns.fetchAndAddRelaxed(1);
+	}
+
+	// consumer side
+
+	T *readSlot() {
+
+		quint32 tail = (quint32) m_cons.tail.load();
+
+		if (tail == m_cons.headCache) {
+
+			m_cons.headCache = (quint32) m_prod.head.loadAcquire();
+			if (tail == m_cons.headCache) return 0;
+		}
+		return &m_slots[tail & (Slots - 1)];
+	}
+
+	void commitRead() {
+
+		m_cons.tail.storeRelease(m_cons.tail.load() + 1);
+	}
+
+	void clear() {
+
+		m_cons.tail.storeRelease(m_prod.head.loadAcquire());
+	}
+
+	bool isEmpty() const	{ return count() == 0; }
+	int  capacity() const	{ return Slots; }
+	int  overruns() const	{ return m_overruns.load(); }
+
+	int count() const {
+
+		return (int)((quint32) m_prod.head.loadAcquire() - (quint32) m_cons.tail.loadAcquire());
+	}
+
+private:
+	Q_DISABLE_COPY(QHBlockRing)
+
+	QHRingProducer	m_prod;
+	QHRingConsumer	m_cons;
+
+	T				m_slots[Slots];
+	QAtomicInt		m_overruns;
+};
+
+/*!
+	\class QHMailbox
+	\brief Lock-free triple buffer handing the newest object of type \a T
+	(a display spectrum, a meter value) from one producer thread to one
+	consumer thread, latest wins.
+
+	The producer fills writeSlot() in place and publishes it with
+	commitWrite(), which hands back the previously published slot if the
+	consumer has not taken it (counted as dropped). The consumer takes the
+	newest object with readSlot() and may use it until its next call.
+	commitWrite() returns true only for the first object published after the
+	consumer took the last one, so a producer that posts a notification
+	only then never has more than one in the consumer's event queue.
+*/
+template<class T> class QHMailbox {
+
+public:
+	QHMailbox()
+		: m_middle(1)
+		, m_published(0)
+		, m_presented(0)
+		, m_dropped(0)
+		, m_back(0)
+		, m_front(2)
+	{
+	}
+
+	// direct access for initialization, before the mailbox is in use
+	T &at(int i)	{ return m_slots[i]; }
+
+	// producer side
+
+	T &writeSlot()	{ return m_slots[m_back]; }
+
+	bool commitWrite() {
+
+		int old = m_middle.fetchAndStoreOrdered(m_back | Fresh);
+		m_back = old & Index;
+
+		m_published.fetchAndAddRelaxed(1);
+		if (old & Fresh) {
+
+			m_dropped.fetchAndAddRelaxed(1);
+			return false;
+		}
+		return true;
+	}
+
+	// consumer side
+
+	// the newest object, 0 if none was published since the last call
+	const T *readSlot() {
+
+		if (!(m_middle.loadAcquire() & Fresh)) return 0;
+
+		m_front = m_middle.fetchAndStoreOrdered(m_front) & Index;
+		m_presented.fetchAndAddRelaxed(1);
+
+		return &m_slots[m_front];
+	}
+
+	// drops an unread object, e.g. left behind by a former consumer, so
+	// that the next commitWrite() returns true again
+	void discard() {
+
+		int middle = m_middle.loadAcquire();
+		while ((middle & Fresh) && !m_middle.testAndSetOrdered(middle, middle & Index))
+			middle = m_middle.loadAcquire();
+	}
+
+	int  published() const	{ return m_published.load(); }
+	int  presented() const	{ return m_presented.load(); }
+	int  dropped() const	{ return m_dropped.load(); }
+
+	void resetCounters() {
+
+		m_published.store(0);
+		m_presented.store(0);
+		m_dropped.store(0);
+	}
+
+private:
+	Q_DISABLE_COPY(QHMailbox)
+
+	enum { Index = 3, Fresh = 4 };
+
+	T				m_slots[3];
+
+	// index of the published slot, with Fresh set until the consumer takes it
+	QAtomicInt		m_middle;
+	QAtomicInt		m_published;
+	QAtomicInt		m_presented;
+	QAtomicInt		m_dropped;
+
+	int				m_back;		// producer only
+	int				m_front;	// consumer only
+};
+
+#endif // CUSDR_FRAMERING_H
@@ -68,6 +68,7 @@ DisplayOptionsWidget::DisplayOptionsWidget(QWidget *parent)
 	m_widebandOptions = set->getWidebandOptions();
 	m_panadapterMode = set->getPanadapterMode(m_currentReceiver);
 	m_waterColorMode = set->getWaterfallColorMode(m_currentReceiver);
+	m_avgMode = set->getSpectrumAveragingMode(m_currentReceiver);
 	
 	fonts = new CFonts(this);
 	m_fonts = fonts->getFonts();
@@ -199,6 +200,12 @@ void DisplayOptionsWidget::setupConnections() {
 		SIGNAL(framesPerSecondChanged(QObject*, int, int)),
 		this,
 		SLOT(setFramesPerSecond(QObject*, int, int)));
+
+	CHECKED_CONNECT(
+		set,
+		SIGNAL(spectrumAveragingModeChanged(QObject *, int, SpectrumAveragingMode)),
+		this,
+		SLOT(setSpectrumAveragingMode(QObject *, int, SpectrumAveragingMode)));
 }
 
 void DisplayOptionsWidget::systemStateChanged(
@@ -401,6 +408,49 @@ void DisplayOptionsWidget::createPanSpectrumOptions() {
 	m_avgLabel->setFrameStyle(QFrame::Box | QFrame::Raised);
 	m_avgLabel->setStyleSheet(set->getLabelStyle());
 
+	// averaging of the linear power in the receiver's PowerSpectrum
+	m_avgExponentialBtn = new AeroButton("Exp", this);
+	m_avgExponentialBtn->setRoundness(0);
+	m_avgExponentialBtn->setFixedSize(btn_widths, btn_height);
+	m_avgModeBtnList.append(m_avgExponentialBtn);
+
+	CHECKED_CONNECT(
+		m_avgExponentialBtn,
+		SIGNAL(clicked()),
+		this,
+		SLOT(avgModeChanged()));
+
+	m_avgWelchBtn = new AeroButton("Welch", this);
+	m_avgWelchBtn->setRoundness(0);
+	m_avgWelchBtn->setFixedSize(btn_widths, btn_height);
+	m_avgModeBtnList.append(m_avgWelchBtn);
+
+	CHECKED_CONNECT(
+		m_avgWelchBtn,
+		SIGNAL(clicked()),
+		this,
+		SLOT(avgModeChanged()));
+
+	m_avgPeakHoldBtn = new AeroButton("Peak", this);
+	m_avgPeakHoldBtn->setRoundness(0);
+	m_avgPeakHoldBtn->setFixedSize(btn_widths, btn_height);
+	m_avgModeBtnList.append(m_avgPeakHoldBtn);
+
+	CHECKED_CONNECT(
+		m_avgPeakHoldBtn,
+		SIGNAL(clicked()),
+		this,
+		SLOT(avgModeChanged()));
+
+	foreach(AeroButton *btn, m_avgModeBtnList)
+		btn->setBtnState(AeroButton::OFF);
+
+	m_avgModeBtnList.at(m_avgMode)->setBtnState(AeroButton::ON);
+
+	m_avgModeLabel = new QLabel("Avg Mode:", this);
+	m_avgModeLabel->setFrameStyle(QFrame::Box | QFrame::Raised);
+	m_avgModeLabel->setStyleSheet(set->getLabelStyle());
+
 	QHBoxLayout *hbox1 = new QHBoxLayout;
 	hbox1->setSpacing(4);
 	hbox1->addStretch();
@@ -416,11 +466,21 @@ void DisplayOptionsWidget::createPanSpectrumOptions() {
 	hbox2->addWidget(m_avgSlider);
 	hbox2->addWidget(m_avgLevelLabel);
 
+	QHBoxLayout *hbox3 = new QHBoxLayout;
+	hbox3->setSpacing(4);
+	hbox3->setMargin(0);
+	hbox3->addWidget(m_avgModeLabel);
+	hbox3->addStretch();
+	hbox3->addWidget(m_avgExponentialBtn);
+	hbox3->addWidget(m_avgWelchBtn);
+	hbox3->addWidget(m_avgPeakHoldBtn);
+
 	QVBoxLayout *vbox = new QVBoxLayout;
 	vbox->setSpacing(6);
 	vbox->addSpacing(6);
 	vbox->addLayout(hbox1);
 	vbox->addLayout(hbox2);
+	vbox->addLayout(hbox3);
 
 	m_panSpectrumOptions = new QGroupBox(tr("Panadapter Spectrum"), this);
 	m_panSpectrumOptions->setMinimumWidth(m_minimumGroupBoxWidth);
@@ -952,6 +1012,50 @@ void DisplayOptionsWidget::setWidebandAveragingCnt(int value) {
 	set->setSpectrumAveragingCnt(this, -1, value);
 }
 
+void DisplayOptionsWidget::avgModeChanged() {
+
+	AeroButton *button = qobject_cast<AeroButton *>(sender());
+	int btnHit = m_avgModeBtnList.indexOf(button);
+
+	foreach(AeroButton *btn, m_avgModeBtnList) {
+
+		btn->setBtnState(AeroButton::OFF);
+		btn->update();
+	}
+
+	button->setBtnState(AeroButton::ON);
+	button->update();
+
+	switch (btnHit) {
+
+		case 0:
+			m_avgMode = ExponentialAveraging;
+			DISPLAYOPTIONS_DEBUG << "set spectrum averaging to exponential.";
+			break;
+
+		case 1:
+			m_avgMode = WelchAveraging;
+			DISPLAYOPTIONS_DEBUG << "set spectrum averaging to Welch.";
+			break;
+
+		case 2:
+			m_avgMode = PeakHoldAveraging;
+			DISPLAYOPTIONS_DEBUG << "set spectrum averaging to peak hold.";
+			break;
+	}
+
+	set->setSpectrumAveragingMode(this, m_currentReceiver, m_avgMode);
+}
+
+void DisplayOptionsWidget::setSpectrumAveragingMode(QObject *sender, int rx, SpectrumAveragingMode mode) {
+
+	Q_UNUSED (sender)
+	Q_UNUSED (mode)
+
+	if (m_currentReceiver == rx)
+		setAveragingMode(m_currentReceiver);
+}
+
 void DisplayOptionsWidget::sampleRateChanged(QObject *sender, int value) {
 
 	Q_UNUSED(sender)
@@ -997,6 +1101,7 @@ void DisplayOptionsWidget::setCurrentReceiver(QObject *sender, int rx) {
 
 	setPanadapterMode(m_currentReceiver);
 	setWaterfallColorMode(m_currentReceiver);
+	setAveragingMode(m_currentReceiver);
 
 	int sliderValue = set->getSpectrumAveragingCnt(m_currentReceiver);
 	m_avgSlider->blockSignals(true);
@@ -1045,6 +1150,25 @@ void DisplayOptionsWidget::setWaterfallColorMode(int rx) {
 	}
 }
 
+void DisplayOptionsWidget::setAveragingMode(int rx) {
+
+	SpectrumAveragingMode avgMode = set->getSpectrumAveragingMode(rx);
+
+	if (avgMode != m_avgMode) {
+
+		foreach(AeroButton *btn, m_avgModeBtnList) {
+
+			btn->setBtnState(AeroButton::OFF);
+			btn->update();
+		}
+
+		m_avgModeBtnList.at(avgMode)->setBtnState(AeroButton::ON);
+		m_avgModeBtnList.at(avgMode)->update();
+
+		m_avgMode = avgMode;
+	}
+}
+
 void DisplayOptionsWidget::callSignTextChanged(const QString& text) {
 
 	m_callSingText = text;
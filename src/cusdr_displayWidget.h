@@ -69,6 +69,7 @@ private:
 	PanGraphicsMode				m_panadapterMode;
 	PanGraphicsMode				m_wbPanadapterMode;
 	WaterfallColorMode			m_waterColorMode;
+	SpectrumAveragingMode		m_avgMode;
 
 	QList<TReceiver>		m_rxDataList;
 	TWideband				m_widebandOptions;
@@ -102,6 +103,7 @@ private:
 	QLabel*					m_avgLabel;
 	QLabel*					m_wbAvgLabel;
 	QLabel*					m_avgLevelLabel;
+	QLabel*					m_avgModeLabel;
 	QLabel*					m_wbAvgLevelLabel;
 	QLabel*					m_resolutionLabel;
 	QLabel*					m_waterfallTimeLabel;
@@ -112,6 +114,9 @@ private:
 	AeroButton*				m_PanLineBtn;
 	AeroButton*				m_PanFilledLineBtn;
 	AeroButton*				m_PanSolidBtn;
+	AeroButton*				m_avgExponentialBtn;
+	AeroButton*				m_avgWelchBtn;
+	AeroButton*				m_avgPeakHoldBtn;
 	AeroButton*				m_wbPanLineBtn;
 	AeroButton*				m_wbPanFilledLineBtn;
 	AeroButton*				m_wbPanSolidBtn;
@@ -122,6 +127,7 @@ private:
 
 	QList<AeroButton* >		m_panadapterBtnList;
 	QList<AeroButton* >		m_wbpanadapterBtnList;
+	QList<AeroButton* >		m_avgModeBtnList;
 	QList<AeroButton* >		m_waterfallColorBtnList;
 	
 	int		m_fontHeight;
@@ -153,6 +159,7 @@ private:
 
 	void	setPanadapterMode(int rx);
 	void	setWaterfallColorMode(int rx);
+	void	setAveragingMode(int rx);
 
 private slots:
 	void	systemStateChanged(
@@ -181,6 +188,8 @@ private slots:
 	void 	fpsValueChanged(int value);
 	void	averagingFilterCntChanged(int value);
 	void	setWidebandAveragingCnt(int value);
+	void	avgModeChanged();
+	void	setSpectrumAveragingMode(QObject *sender, int rx, SpectrumAveragingMode mode);
 	void	sampleRateChanged(QObject *sender, int value);
 	void	callSignTextChanged(const QString &text);
 	void	callSignChanged();
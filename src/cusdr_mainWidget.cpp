@@ -207,6 +207,12 @@ void MainWindow::setupConnections() {
 		this, 
 		SLOT(updateStatusBar(short)));
 
+	CHECKED_CONNECT(
+		set,
+		SIGNAL(dspLoadChanged(int, float, float)), 
+		this, 
+		SLOT(updateDSPLoad(int, float, float)));
+
 	CHECKED_CONNECT(
 		set,
 		SIGNAL(masterSwitchChanged(QObject *, bool)), 
@@ -638,12 +644,16 @@ void MainWindow::createStatusToolBar() {
 	m_cpuLoadLabel = new QLabel(m_cpuLoadString, this);
 	m_cpuLoadLabel->setStyleSheet(set->getLabelStyle());
 
+	m_dspLoadLabel = new QLabel("DSP load:     ", this);
+	m_dspLoadLabel->setStyleSheet(set->getLabelStyle());
+
 	m_dateTimeLabel = new QLabel(m_dateTimeString, this);
 	m_dateTimeLabel->setStyleSheet(set->getLabelStyle());
 
 	statusBar()->setStyleSheet(set->getStatusbarStyle());
+	statusBar()->addPermanentWidget(m_dspLoadLabel);
 	statusBar()->addPermanentWidget(m_cpuLoadLabel);
-	statusBar()->insertPermanentWidget(1, m_dateTimeLabel, 0);
+	statusBar()->insertPermanentWidget(2, m_dateTimeLabel, 0);
 }
 
 /*!
@@ -663,6 +673,18 @@ void MainWindow::updateStatusBar(short load) {
 	statusBar()->update();
 }
 
+/*!
+	\brief show the DSP time of the current receiver
+	relative to the real-time budget of one block.
+*/
+void MainWindow::updateDSPLoad(int rx, float load, float peakLoad) {
+
+	if (rx != set->getCurrentReceiver()) return;
+
+	QString str = "DSP load Rx%1: %2 % (peak %3 %) \t";
+	m_dspLoadLabel->setText(str.arg(rx + 1).arg(qRound(100 * load)).arg(qRound(100 * peakLoad)));
+}
+
 /*!
 	\brief create the display panel tool bar.
 */
@@ -1060,6 +1082,23 @@ void MainWindow::createMainBtnToolBar() {
 		this,
 		SLOT(muteBtnClickedEvent()));
 
+	binauralBtn = new AeroButton("I/Q", this);
+	binauralBtn->setRoundness(10);
+    binauralBtn->setFont(m_fonts.normalFont);
+    binauralBtn->setTextColor(btnCol);
+	binauralBtn->setFixedSize(btn_width3, btn_height1);
+
+	if (set->getBinaural(set->getCurrentReceiver()))
+		binauralBtn->setBtnState(AeroButton::ON);
+	else
+		binauralBtn->setBtnState(AeroButton::OFF);
+
+	CHECKED_CONNECT(
+		binauralBtn,
+		SIGNAL(clicked()),
+		this,
+		SLOT(binauralBtnClickedEvent()));
+
 //	lastFreqBtn = new AeroButton(" ", this);
 //	lastFreqBtn->setRoundness(10);
 //	lastFreqBtn->setFixedSize(btn_width1, btn_height3);
@@ -1109,6 +1148,8 @@ void MainWindow::createMainBtnToolBar() {
 	secondBtnLayout->addWidget(m_volLevelLabel);
 	secondBtnLayout->addSpacing(2);
 	secondBtnLayout->addWidget(muteBtn);
+	secondBtnLayout->addSpacing(2);
+	secondBtnLayout->addWidget(binauralBtn);
 	//secondBtnLayout->addWidget(lastFreqBtn);
 	
 	/*QHBoxLayout *thirdBtnLayout = new QHBoxLayout;
@@ -1707,6 +1748,13 @@ void MainWindow::setCurrentReceiver(QObject *sender, int rx) {
 	//m_dataEngine->io.currentReceiver = rx;
 	m_volumeSlider->setValue((int)(set->getMainVolume(rx) * 100));
 	m_agcGainSlider->setValue(set->getAGCMaximumGain_dB(rx));
+
+	if (set->getBinaural(rx))
+		binauralBtn->setBtnState(AeroButton::ON);
+	else
+		binauralBtn->setBtnState(AeroButton::OFF);
+
+	binauralBtn->update();
 }
 
 /*!
@@ -1780,6 +1828,25 @@ void MainWindow::muteBtnClickedEvent() {
 	}
 }
 
+/*!
+	\brief I and Q of the current receiver on the left and right audio channel.
+*/
+void MainWindow::binauralBtnClickedEvent() {
+
+	if (binauralBtn->btnState() == AeroButton::OFF) {
+
+		binauralBtn->setBtnState(AeroButton::ON);
+		set->setBinaural(this, set->getCurrentReceiver(), true);
+	}
+	else if (binauralBtn->btnState() == AeroButton::ON) {
+
+		binauralBtn->setBtnState(AeroButton::OFF);
+		set->setBinaural(this, set->getCurrentReceiver(), false);
+	}
+
+	binauralBtn->update();
+}
+
 void MainWindow::setTxAllowed(QObject *sender, bool value) {
 
 	Q_UNUSED(sender)
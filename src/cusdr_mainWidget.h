@@ -98,6 +98,7 @@ public slots:
 	//void	peakHoldBtnClickedEvent();
 	void	alexBtnClickedEvent();
 	void	muteBtnClickedEvent();
+	void	binauralBtnClickedEvent();
 	//void	resizeWidget();
 	
 	void	showWidgetEvent(QObject *sender);
@@ -185,6 +186,7 @@ private:
 	QLabel			*m_agcGainLabel;
 	QLabel			*m_agcGainLevelLabel;
 	QLabel			*m_cpuLoadLabel;
+	QLabel			*m_dspLoadLabel;
 	QLabel			*m_dateTimeLabel;
 	QLabel			*m_statusBarMessage;
 
@@ -243,6 +245,7 @@ private:
 	AeroButton			*lastFreqBtn;
 	AeroButton			*attenuatorBtn;
 	AeroButton			*muteBtn;
+	AeroButton			*binauralBtn;
 
 	QList<AeroButton* >	mainBtnList;
 
@@ -302,6 +305,7 @@ private slots:
 	void setMainWindowGeometry();
 	void updateTitle();
 	void updateStatusBar(short load);
+	void updateDSPLoad(int rx, float load, float peakLoad);
 	void setFullScreen();
 	void getRegion();
 
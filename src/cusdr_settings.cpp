@@ -30,8 +30,32 @@
 #include "cusdr_settings.h"
 #include "Util/cusdr_styles.h"
 
+#if defined(Q_OS_WIN32)
+#include <windows.h>
+#elif defined(Q_OS_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 Settings *Settings::m_instance = NULL;		/*!< set m_instance to NULL. */
 
+void QThreadEx::applyCpuAffinity() {
+
+	if (m_cpu < 0) return;
+
+#if defined(Q_OS_WIN32)
+	if (SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR) 1 << m_cpu) == 0)
+		qDebug() << "QThreadEx::\tcould not pin thread to CPU " << m_cpu;
+#elif defined(Q_OS_LINUX)
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+	CPU_SET(m_cpu, &cpuset);
+
+	if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) != 0)
+		qDebug() << "QThreadEx::\tcould not pin thread to CPU " << m_cpu;
+#endif
+}
+
 /*!
 	\class Settings
 	\brief Settings class implements application specific and user defined variables for the application.
@@ -61,10 +85,16 @@ Settings::Settings(QObject *parent)
 	qRegisterMetaType<DSPMode>();
 	qRegisterMetaType<AGCMode>();
 	qRegisterMetaType<TDefaultFilterMode>();
+	qRegisterMetaType<SpectrumAveragingMode>();
 	qRegisterMetaType<TNetworkDevicecard>();
 	qRegisterMetaType<QList<TNetworkDevicecard> >();
 	qRegisterMetaType<qVectorFloat>("qVectorFloat");
 
+	// PowerSpectrum::spectrumResult() fills the spectrum slots in place
+	for (int rx = 0; rx < MAX_RECEIVERS; rx++)
+		for (int i = 0; i < 3; i++)
+			m_spectrumMailbox[rx].at(i).resize(BUFFER_SIZE*4);
+
 	startTime = QDateTime::currentDateTime();
 
 	qDebug() << "************************************************************************";
@@ -877,6 +907,20 @@ int Settings::loadSettings() {
 		if (value < 0 || value > 200) value = 25;
 		m_receiverDataList[i].framesPerSecond = value;
 
+		// overlap of successive panadapter spectra in percent
+		cstr = m_rxStringList.at(i);
+		cstr.append("/spectrumOverlap");
+		value = settings->value(cstr, 50).toInt();
+		if (value != 0 && value != 50 && value != 75) value = 50;
+		m_receiverDataList[i].spectrumOverlap = value;
+
+		// receiver filter length in taps, 0 for the filter block size
+		cstr = m_rxStringList.at(i);
+		cstr.append("/filterLength");
+		value = settings->value(cstr, 0).toInt();
+		if (value < 0 || value > 8192) value = 0;
+		m_receiverDataList[i].filterLength = value;
+
 		cstr = m_rxStringList.at(i);
 		cstr.append("/waterfallOffsetLo");
 		value = settings->value(cstr, -5).toInt();
@@ -915,6 +959,26 @@ int Settings::loadSettings() {
 		if ((value < 1) || (value > 100)) value = 5;
 		m_receiverDataList[i].averagingCnt = value;
 
+		cstr = m_rxStringList.at(i);
+		cstr.append("/averagingMode");
+		str = settings->value(cstr, "EXPONENTIAL").toString();
+		if (str == "WELCH")
+			m_receiverDataList[i].averagingMode = WelchAveraging;
+		else if (str == "PEAK")
+			m_receiverDataList[i].averagingMode = PeakHoldAveraging;
+		else
+			m_receiverDataList[i].averagingMode = ExponentialAveraging;
+
+		// SSB, CW, DIGI and DSB audio as I on the left and Q on the right
+		// channel, as before the real valued audio path
+		cstr = m_rxStringList.at(i);
+		cstr.append("/binaural");
+		str = settings->value(cstr, "on").toString();
+		if (str.toLower() == "on")
+			m_receiverDataList[i].binaural = true;
+		else
+			m_receiverDataList[i].binaural = false;
+
 		cstr = m_rxStringList.at(i);
 		cstr.append("/grid");
 		str = settings->value(cstr, "on").toString();
@@ -1829,6 +1893,14 @@ int Settings::saveSettings() {
 		str.append("/framesPerSecond");
 		settings->setValue(str, m_receiverDataList[i].framesPerSecond);
 
+		str = m_rxStringList.at(i);
+		str.append("/spectrumOverlap");
+		settings->setValue(str, m_receiverDataList[i].spectrumOverlap);
+
+		str = m_rxStringList.at(i);
+		str.append("/filterLength");
+		settings->setValue(str, m_receiverDataList[i].filterLength);
+
 		str = m_rxStringList.at(i);
 		str.append("/waterfallOffsetLo");
 		settings->setValue(str, m_receiverDataList[i].waterfallOffsetLo);
@@ -1856,6 +1928,23 @@ int Settings::saveSettings() {
 		str.append("/averagingCnt");
 		settings->setValue(str, m_receiverDataList[i].averagingCnt);
 
+		str = m_rxStringList.at(i);
+		str.append("/averagingMode");
+
+		if (m_receiverDataList[i].averagingMode == WelchAveraging)
+			settings->setValue(str, "WELCH");
+		else if (m_receiverDataList[i].averagingMode == PeakHoldAveraging)
+			settings->setValue(str, "PEAK");
+		else
+			settings->setValue(str, "EXPONENTIAL");
+
+		str = m_rxStringList.at(i);
+		str.append("/binaural");
+		if (m_receiverDataList[i].binaural)
+			settings->setValue(str, "on");
+		else
+			settings->setValue(str, "off");
+
 		str = m_rxStringList.at(i);
 		str.append("/grid");
 		if (m_receiverDataList[i].panGrid)
@@ -2741,6 +2830,11 @@ void Settings::setCPULoad(short load) {
 	emit cpuLoadChanged(load);
 }
 
+void Settings::setDSPLoad(int rx, float load, float peakLoad) {
+
+	emit dspLoadChanged(rx, load, peakLoad);
+}
+
 void Settings::setCallsign(const QString &callsign) {
 
 	QString cs = callsign.trimmed();
@@ -3904,9 +3998,10 @@ void Settings::setIQPort(QObject *sender, int rx, int port) {
 	emit iqPortChanged(sender, rx, port);
 }
  
-void Settings::setSpectrumBuffer(int rx, const qVectorFloat& buffer) {
+// the spectrum of \a rx is waiting in spectrumMailbox(rx)
+void Settings::setSpectrumBuffer(int rx) {
 
-	emit spectrumBufferChanged(rx, buffer);
+	emit spectrumBufferChanged(rx);
 }
 
 void Settings::setPostSpectrumBuffer(int rx, const float* buffer) {
@@ -3914,11 +4009,6 @@ void Settings::setPostSpectrumBuffer(int rx, const float* buffer) {
 	emit postSpectrumBufferChanged(rx, buffer);
 }
 
-void Settings::setSMeterValue(int rx, float value) {
-
-	emit sMeterValueChanged(rx, value);
-}
-
 void Settings::setReceiverDataReady() {
 
 	emit receiverDataReady();
@@ -4308,9 +4398,9 @@ void Settings::setAudioBuffer(QObject *sender, qint64 position, qint64 length, c
 //**********************************************************************************
 // wideband data & options
 
-void Settings::setWidebandSpectrumBuffer(const qVectorFloat &buffer) {
+void Settings::setWidebandSpectrumBuffer() {
 
-	emit widebandSpectrumBufferChanged(buffer);
+	emit widebandSpectrumBufferChanged();
 }
 
 void Settings::resetWidebandSpectrumBuffer() {
@@ -4627,10 +4717,44 @@ int	Settings::getFramesPerSecond(int rx) {
 	return m_receiverDataList.at(rx).framesPerSecond;
 }
 
+void Settings::setSpectrumOverlap(QObject* sender, int rx, int value) {
+
+	Q_UNUSED(sender)
+
+	QMutexLocker locker(&settingsMutex);
+
+	if (m_receiverDataList.at(rx).spectrumOverlap == value) return;
+	m_receiverDataList[rx].spectrumOverlap = value;
+
+	emit spectrumOverlapChanged(this, rx, value);
+}
+
+int	Settings::getSpectrumOverlap(int rx) {
+
+	return m_receiverDataList.at(rx).spectrumOverlap;
+}
+
+void Settings::setFilterLength(QObject* sender, int rx, int value) {
+
+	Q_UNUSED(sender)
+
+	QMutexLocker locker(&settingsMutex);
+
+	if (m_receiverDataList.at(rx).filterLength == value) return;
+	m_receiverDataList[rx].filterLength = value;
+
+	emit filterLengthChanged(this, rx, value);
+}
+
+int	Settings::getFilterLength(int rx) {
+
+	return m_receiverDataList.at(rx).filterLength;
+}
+
 void Settings::setSpectrumAveraging(QObject* sender, int rx, bool value) {
 	
 	if (rx == -1) {
-		m_widebandOptions.averagingCnt = value;
+		m_widebandOptions.averaging = value;
 	}
 	else {
 		m_receiverDataList[rx].spectrumAveraging = value;
@@ -4675,6 +4799,36 @@ void Settings::setSpectrumAveragingCnt(QObject *sender, int rx, int value) {
 	emit spectrumAveragingCntChanged(sender, rx, value);
 }
 
+void Settings::setSpectrumAveragingMode(QObject *sender, int rx, SpectrumAveragingMode mode) {
+
+	QMutexLocker locker(&settingsMutex);
+
+	if (m_receiverDataList.at(rx).averagingMode == mode) return;
+	m_receiverDataList[rx].averagingMode = mode;
+
+	emit spectrumAveragingModeChanged(sender, rx, mode);
+}
+
+SpectrumAveragingMode Settings::getSpectrumAveragingMode(int rx) {
+
+	return m_receiverDataList.at(rx).averagingMode;
+}
+
+void Settings::setBinaural(QObject *sender, int rx, bool value) {
+
+	QMutexLocker locker(&settingsMutex);
+
+	if (m_receiverDataList.at(rx).binaural == value) return;
+	m_receiverDataList[rx].binaural = value;
+
+	emit binauralChanged(sender, rx, value);
+}
+
+bool Settings::getBinaural(int rx) {
+
+	return m_receiverDataList.at(rx).binaural;
+}
+
 
 
 void Settings::setPanGrid(bool value, int rx) {
@@ -122,6 +122,7 @@ static int my_fftw_read_char(void *f) { return fgetc((FILE *) f); }
 #define MAX_RECEIVERS				7
 #define MAX_BANDS					12
 #define BUFFER_SIZE					1024
+#define RX_BLOCK_BUFFERS			32
 #define SAMPLE_BUFFER_SIZE			4096
 #define BANDSCOPE_BUFFER_SIZE		4096
 
@@ -137,6 +138,10 @@ static int my_fftw_read_char(void *f) { return fgetc((FILE *) f); }
 #define IO_BUFFERS					16
 #define IO_BUFFER_SIZE				512
 #define IO_HEADER_SIZE				8
+#define IQ_RING_SLOTS				256
+#define WB_RING_SLOTS				4
+#define CHIRP_RING_SLOTS			16
+#define CHIRP_BLOCK_SIZE			2048	// complex samples per chirp ring slot
 #define IO_AUDIOBUFFER_SIZE			8192
 
 #define SYNC						0x7F
@@ -146,6 +151,7 @@ static int my_fftw_read_char(void *f) { return fgetc((FILE *) f); }
 
 #define METIS_HEADER_SIZE			8
 #define METIS_DATA_SIZE				1032
+#define IQ_RING_SLOT_SIZE			1088	// one Metis datagram, padded to full cache lines
 
 #define ALEX_PARAMETERS				15
 
@@ -209,6 +215,7 @@ static int my_fftw_read_char(void *f) { return fgetc((FILE *) f); }
 //#include "cusdr_about.h"
 #include "AudioEngine/cusdr_fspectrum.h"
 #include "Util/cusdr_queue.h"
+#include "Util/cusdr_frameRing.h"
 
 
 // **************************************
@@ -445,10 +452,18 @@ typedef struct _hpsdrParameter {
 
 	QByteArray				audioDatagram;
 	
-	QHQueue<QByteArray>		iq_queue;
+	// Metis datagrams (received in place) and collected EP4 buffers (wide band)
+	// from the network thread
+	QHFrameRing<IQ_RING_SLOTS, IQ_RING_SLOT_SIZE>	iq_queue;
 	QHQueue<QByteArray>		au_queue;
-	QHQueue<QByteArray>		wb_queue;
-	QHQueue<QList<qreal> >	chirp_queue;
+	QHFrameRing<WB_RING_SLOTS, 2*BIGWIDEBANDSIZE>	wb_queue;
+
+	// heap allocations on the frame path between DataIO and the receivers;
+	// stays 0 in the steady state.
+	QAtomicInt				frameAllocations;
+	// chirp file samples as interleaved I/Q floats, CHIRP_BLOCK_SIZE per
+	// slot, time stamped with the sample position of the slot
+	QHFrameRing<CHIRP_RING_SLOTS, CHIRP_BLOCK_SIZE * 2 * sizeof(float)>	chirp_queue;
 	QHQueue<QList<qreal> >	data_queue;
 
 	QList<qreal> inputBuffer;
@@ -541,7 +556,17 @@ typedef enum _waterfallColorMode {
 
 } WaterfallColorMode;
 
+// spectrum averaging of the receiver, done on the linear power
+typedef enum _spectrumAveragingMode {
+
+	ExponentialAveraging,	// 0
+	WelchAveraging,			// 1
+	PeakHoldAveraging		// 2
+
+} SpectrumAveragingMode;
+
 Q_DECLARE_METATYPE (TNetworkDevicecard)
+Q_DECLARE_METATYPE (SpectrumAveragingMode)
 Q_DECLARE_METATYPE (QList<TNetworkDevicecard>)
 
 typedef struct _receiver {
@@ -555,6 +580,7 @@ typedef struct _receiver {
 	TDefaultFilterMode	defaultFilterMode;
 	PanGraphicsMode		panMode;
 	WaterfallColorMode	waterfallMode;
+	SpectrumAveragingMode	averagingMode;
 
 	QList<long>			lastCenterFrequencyList;
 	QList<long>			lastVfoFrequencyList;
@@ -572,6 +598,7 @@ typedef struct _receiver {
 	bool	peakHold;
 	bool	clickVFO;
 	bool	fftAuto;
+	bool	binaural;		// I and Q on the left and right channel
 
 	long	ctrFrequency;
 	long	vfoFrequency;
@@ -601,6 +628,8 @@ typedef struct _receiver {
 	int		waterfallOffsetHi;
 	int		averagingCnt;
 	int		fftFactor;
+	int		spectrumOverlap;
+	int		filterLength;
 
 } TReceiver;
 
@@ -657,6 +686,18 @@ typedef struct t_panadapterColors {
 
 } TPanadapterColors;
 
+// snapshot of the signal meter of one receiver, in dB including the
+// meter correction; see SignalMeter
+typedef struct _sMeterReading {
+
+	float	instant;	// power of the last block
+	float	rms;		// power with attack/decay ballistics
+	float	average;	// long-term average of the power
+	float	peak;		// block peak, held and then falling
+	quint32	blocks;		// blocks metered so far
+
+} TSMeterReading;
+
 
 typedef enum _smeterType {
 
@@ -709,9 +750,19 @@ class Receiver;
 
 class QThreadEx : public QThread {
 
+public:
+	QThreadEx() : QThread(), m_cpu(-1) {}
+
+	// pin the thread to one CPU core when it is started (-1 = no affinity)
+	void setCpuAffinity(int cpu) { m_cpu = cpu; }
+
 protected:
-    void run() { exec(); }
+    void run() { applyCpuAffinity(); exec(); }
+
+private:
+	int		m_cpu;
 
+	void	applyCpuAffinity();
 };
 
 // **************************************
@@ -776,10 +827,10 @@ signals:
 	void modelChanged(QObject *sender, QSDR::_SDRModel model);
 
 	void cpuLoadChanged(short load);
+	void dspLoadChanged(int rx, float load, float peakLoad);
 	void txAllowedChanged(QObject* sender, bool value);
 	void multiRxViewChanged(int view);
-	void sMeterValueChanged(int rx, float value);
-	void spectrumBufferChanged(int rx, const qVectorFloat& buffer);
+	void spectrumBufferChanged(int rx);
 	void postSpectrumBufferChanged(int rx, const float* buffer);
 
 	void sampleSizeChanged(int rx, int size);
@@ -797,6 +848,8 @@ signals:
 	void clientDisconnectedEvent(int client);
 	void rxConnectedStatusChanged(QObject* sender, int rx, bool value);
 	void framesPerSecondChanged(QObject* sender, int rx, int value);
+	void spectrumOverlapChanged(QObject* sender, int rx, int value);
+	void filterLengthChanged(QObject* sender, int rx, int value);
 	
 	void settingsFilenameChanged(QString filename);
 	void settingsLoadedChanged(bool loaded);
@@ -878,7 +931,7 @@ signals:
 	void ncoFrequencyChanged(int rx, long frequency);
 
 	// wideband data
-	void widebandSpectrumBufferChanged(const qVectorFloat& buffer);
+	void widebandSpectrumBufferChanged();
 	void widebandOptionsChanged(QObject* sender, TWideband options);
 	void widebandSpectrumBufferReset();
 	void widebandStatusChanged(QObject* sender, bool value);
@@ -954,6 +1007,8 @@ signals:
 
 	void spectrumAveragingChanged(QObject *sender, int rx, bool value);
 	void spectrumAveragingCntChanged(QObject *sender, int rx, int value);
+	void spectrumAveragingModeChanged(QObject *sender, int rx, SpectrumAveragingMode mode);
+	void binauralChanged(QObject *sender, int rx, bool value);
 	
 
 	void waterfallTimeChanged(int rx, int value);
@@ -972,6 +1027,15 @@ signals:
 public:
 	void	debugSystemState();
 
+	// display data hand-over from the DSP threads, latest wins: the producer
+	// fills the mailbox and notifies via the set.. slots below, the display
+	// takes the newest object when it gets the notification. The S-meter
+	// readings of all receivers are published every block without
+	// notification; the display polls them.
+	QHMailbox<qVectorFloat>*	spectrumMailbox(int rx)		{ return &m_spectrumMailbox[rx]; }
+	QHMailbox<qVectorFloat>*	widebandMailbox()			{ return &m_widebandMailbox; }
+	QHMailbox<TSMeterReading>*	sMeterMailbox(int rx)		{ return &m_sMeterMailbox[rx]; }
+
 	int 	loadSettings();
 	int 	saveSettings();
 
@@ -1066,6 +1130,8 @@ public:
 	QList<int>					getRxJ6Pins()				{ return m_rxJ6pinList; }
 	QList<int>					getTxJ6Pins()				{ return m_txJ6pinList; }
 	int							getFramesPerSecond(int rx);
+	int							getSpectrumOverlap(int rx);
+	int							getFilterLength(int rx);
 	QString						getDSPModeString(int mode);
 
 	HamBand						getCurrentHamBand(int rx);
@@ -1178,6 +1244,8 @@ public:
 
 	bool getSpectrumAveraging(int rx);
 	int getSpectrumAveragingCnt(int rx);
+	SpectrumAveragingMode getSpectrumAveragingMode(int rx);
+	bool getBinaural(int rx);
 	int getFFTMultiplicator(int rx);//			{ return m_fft; }
 
 	QMutex 		debugMutex;
@@ -1190,6 +1258,7 @@ public slots:
 	void setSystemMessage(const QString &msg, int time);
 	void setSettingsLoaded(bool loaded);
 	void setCPULoad(short load);
+	void setDSPLoad(int rx, float load, float peakLoad);
 	void setCallsign(const QString &callsign);
 
 	void setPBOPresence(bool value);
@@ -1215,8 +1284,7 @@ public slots:
 
 	void setTxAllowed(QObject* sender, bool value);
 	void setMultiRxView(int view);
-	void setSMeterValue(int rx, float value);
-	void setSpectrumBuffer(int rx, const qVectorFloat &buffer);
+	void setSpectrumBuffer(int rx);
 	void setPostSpectrumBuffer(int rx, const float*);
 	void setSampleSize(QObject* sender, int rx, int size);
 	void setRxList(QList<Receiver *> rxList);
@@ -1312,6 +1380,8 @@ public slots:
 		
 	void clientDisconnected(int client);
 	void setFramesPerSecond(QObject *sender, int rx, int value);
+	void setSpectrumOverlap(QObject *sender, int rx, int value);
+	void setFilterLength(QObject *sender, int rx, int value);
 	void setMouseWheelFreqStep(QObject *sender, int rx, qreal value);
 	void setSocketBufferSize(QObject *sender, int value);
 	void setManualSocketBufferSize(QObject *sender, bool value);
@@ -1347,7 +1417,7 @@ public slots:
 
 	// wideband data & options
 	void setWidebandBuffers(QObject *sender, int value);
-	void setWidebandSpectrumBuffer(const qVectorFloat &buffer);
+	void setWidebandSpectrumBuffer();
 	void resetWidebandSpectrumBuffer();
 	void setWidebandOptions(QObject* sender, TWideband options);
 	void setWidebandStatus(QObject* sender, bool value);
@@ -1409,6 +1479,8 @@ public slots:
 	
 	void setSpectrumAveraging(QObject *sender, int rx, bool value);
 	void setSpectrumAveragingCnt(QObject *sender, int rx, int value);
+	void setSpectrumAveragingMode(QObject *sender, int rx, SpectrumAveragingMode mode);
+	void setBinaural(QObject *sender, int rx, bool value);
 	
 
 	void setWaterfallTime(int rx, int value);
@@ -1428,6 +1500,10 @@ public slots:
 private slots:
 
 private:
+	QHMailbox<qVectorFloat>		m_spectrumMailbox[MAX_RECEIVERS];
+	QHMailbox<qVectorFloat>		m_widebandMailbox;
+	QHMailbox<TSMeterReading>	m_sMeterMailbox[MAX_RECEIVERS];
+
 	QSDR::_Error				m_systemError;
 	QSDR::_ServerMode			m_serverMode;
 	QSDR::_HWInterfaceMode		m_hwInterface;
@@ -36,6 +36,7 @@
 #endif
 
 #include "cusdr_mainWidget.h"
+#include "QtDSP/qtdsp_fft.h"
 //#include "fftw3.h"
 
 //#include <QtGui>
@@ -143,93 +144,6 @@ void cuSDRMessageHandler(QtMsgType type, const QMessageLogContext &context, cons
 	*/
 }
 
-void runFFTWWisdom() {
-
-	QString directory = QDir::currentPath();	
-	QDir currentDir = QDir(directory);
-
-	errno_t err;
-	FILE* wisdomFile;
-
-	qDebug() << "Init::\tcurrent path: " << qPrintable(currentDir.absolutePath());
-	
-	if (currentDir.exists("fftwf_wisdom")) {
-	
-		qDebug() << "Init::\tfftwf_wisdom exists.";
-
-		/*errno_t err;
-		FILE* wisdomFile;*/
-		err = fopen_s(&wisdomFile, "fftwf_wisdom", "r");
-		if (err == 0) {
-
-			qDebug() << "Init::\tfound fftwf_wisdom - this will be quick!";
-			fftwf_import_wisdom_from_file(wisdomFile);
-			fclose(wisdomFile);
-		}
-		else {
-
-			qDebug() << "Init::\tfound fftwf_wisdom but could not open.";
-			return;
-		}
-
-	}
-	else {
-	
-		qDebug() << "Init::\tfftw_wisdom does not exist - planning FFT...";
-	
-		//string fname = "F:\\Eigene Dokumente\\Visual Studio 2010\\Projects\\cuSDR64\\fftwf_wisdom";
-		//FILE* wis = fopen (fname.c_str(), "r");
-	
-		/*if (wis) {
-
-			qDebug() << "Init::\tfound fftwf_wisdom - this will be quick!";
-			fftwf_import_wisdom_from_file(wis);
-			fclose (wis);
-		}
-		else {*/
-			
-			int size = 64;
-		
-			QString str = "Init::\tplanning FFT size %1 ...";
-
-			fftwf_complex* cpxbuf;
-			fftwf_plan plan_fwd;
-			fftwf_plan plan_rev;
-
-			while (size <= MAX_FFTSIZE) {
-			//while (size <= 256) {
-
-				qDebug() << qPrintable(str.arg(size));
-				cpxbuf = (fftwf_complex *) fftwf_malloc(sizeof(fftwf_complex) * size);
-			
-				plan_fwd = fftwf_plan_dft_1d(size , cpxbuf, cpxbuf, FFTW_FORWARD, FFTW_PATIENT);
-				fftwf_execute(plan_fwd);
-				fftwf_destroy_plan(plan_fwd);
-
-				plan_rev = fftwf_plan_dft_1d(size, cpxbuf, cpxbuf, FFTW_BACKWARD, FFTW_PATIENT);
-				fftwf_execute(plan_rev);
-				fftwf_destroy_plan(plan_rev);
-
-				size *= 2;
-			}
-			//FILE* wis = fopen (fname.c_str(), "w");
-			//if (wis) {
-			
-			err = fopen_s(&wisdomFile, "fftwf_wisdom", "w");
-			if (err == 0) {
-				
-				qDebug() << "Init::\texporting fftwf_wisdom for quick measurement.";
-				fftwf_export_wisdom_to_file(wisdomFile);
-				qDebug() << "Init::\texported fftwf_wisdom.";
-				fclose(wisdomFile);
-			}
-			else {
-
-				qDebug() << "Init::\tcould not write fftwf_wisdom.";
-			}
-		}
-}
-
 int main(int argc, char *argv[]) {
 
 	#ifndef DEBUG
@@ -238,6 +152,9 @@ int main(int argc, char *argv[]) {
 
     QApplication app(argc, argv);
 
+	QElapsedTimer startupTimer;
+	startupTimer.start();
+
     Settings::instance(&app);
 
     app.setApplicationName(Settings::instance()->getTitleStr());
@@ -315,6 +232,20 @@ int main(int argc, char *argv[]) {
 		//splash->showMessage("\n      " + QObject::tr(copyright), Qt::AlignBottom | Qt::AlignLeft, Qt::black);
     }
 
+	// ****************************
+	// FFTW wisdom
+
+	// imported before the first QFFT is created; sizes missing in the
+	// wisdom are planned on first use and added to the file.
+	splash->showMessage(
+			"\n      " + 
+			Settings::instance()->getTitleStr() + " " +
+			Settings::instance()->getVersionStr() +
+			QObject::tr(":   Loading FFTW wisdom .."),
+			Qt::AlignTop | Qt::AlignLeft, Qt::yellow);
+
+	QFFTPlanner::loadWisdom(QFileInfo(Settings::instance()->getSettingsFilename()).absolutePath());
+
 	// ****************************
 	// check for OpenGL
 
@@ -528,94 +459,6 @@ int main(int argc, char *argv[]) {
 
 	SleeperThread::msleep(300);
 	
-	//*************************************************************************
-	// FFTW wisdom
-
-	QString directory = QDir::currentPath();	
-	QDir currentDir = QDir(directory);
-
-	errno_t err;
-	FILE* wisdomFile;
-
-	qDebug() << "Init::\tcurrent path: " << qPrintable(currentDir.absolutePath());
-
-	if (currentDir.exists("fftwf_wisdom")) {
-	
-		qDebug() << "Init::\tfftwf_wisdom exists.";
-
-		err = fopen_s(&wisdomFile, "fftwf_wisdom", "r");
-		if (err == 0) {
-
-			qDebug() << "Init::\tfound fftwf_wisdom - this will be quick!";
-			splash->showMessage(
-				"\n      " +
-				Settings::instance()->getTitleStr() + " " +
-				Settings::instance()->getVersionStr() +
-				QObject::tr(":   found fftwf_wisdom - loading .."),
-				Qt::AlignTop | Qt::AlignLeft, Qt::yellow);
-
-			fftwf_import_wisdom_from_file(wisdomFile);
-			fclose(wisdomFile);
-		}
-		else {
-
-			qDebug() << "Init::\tfound fftwf_wisdom but could not open.";
-			return -1;
-		}
-
-	}
-	else {
-	
-		qDebug() << "Init::\tfftw_wisdom does not exist - planning FFT...";
-	
-		QString msg = "First time FFT planning. Please be patient, this may take up to 10 min!";
-		mainWindow.showWarningDialog(msg);
-
-		int size = 64;
-		QString str = "planning FFT size %1 ...";
-
-		fftwf_complex* cpxbuf;
-		fftwf_plan plan_fwd;
-		fftwf_plan plan_rev;
-
-		while (size <= MAX_FFTSIZE) {
-		//while (size <= 2048) {
-
-			qDebug() << qPrintable(str.arg(size));
-			splash->showMessage(
-				"\n      " +
-				Settings::instance()->getTitleStr() + " " +
-				Settings::instance()->getVersionStr() +
-				QObject::tr(":   ") + str.arg(size),
-				Qt::AlignTop | Qt::AlignLeft, Qt::yellow);
-
-			cpxbuf = (fftwf_complex *) fftwf_malloc(sizeof(fftwf_complex) * size);
-			
-			plan_fwd = fftwf_plan_dft_1d(size , cpxbuf, cpxbuf, FFTW_FORWARD, FFTW_PATIENT);
-			fftwf_execute(plan_fwd);
-			fftwf_destroy_plan(plan_fwd);
-
-			plan_rev = fftwf_plan_dft_1d(size, cpxbuf, cpxbuf, FFTW_BACKWARD, FFTW_PATIENT);
-			fftwf_execute(plan_rev);
-			fftwf_destroy_plan(plan_rev);
-
-			size *= 2;
-		}
-			
-		err = fopen_s(&wisdomFile, "fftwf_wisdom", "w");
-		if (err == 0) {
-				
-			qDebug() << "Init::\texporting fftwf_wisdom for quick measurement.";
-			fftwf_export_wisdom_to_file(wisdomFile);
-			qDebug() << "Init::\texported fftwf_wisdom.";
-			fclose(wisdomFile);
-		}
-		else {
-
-			qDebug() << "Init::\tcould not write fftwf_wisdom.";
-		}
-	}
-
 	mainWindow.show();
     app.processEvents();
 
@@ -635,6 +478,8 @@ int main(int argc, char *argv[]) {
 	mainWindow.update();
 	mainWindow.setFocus();
 
+	qDebug()	<< "Init::\tstartup took " << startupTimer.elapsed() << " ms, FFT planning "
+				<< QFFTPlanner::planningTime() << " ms.";
 	qDebug() << "Init::\trunning application ...\n";
 	
     return app.exec();
@@ -0,0 +1,37 @@
+# settings shared by all test projects; each one adds the sources under test
+
+QT += core gui network multimedia opengl testlib
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+CONFIG += qt warn_on console testcase
+CONFIG -= app_bundle
+
+CUSDR_ROOT = $$PWD/..
+
+INCLUDEPATH += \
+	$$CUSDR_ROOT \
+	$$CUSDR_ROOT/src \
+	$$CUSDR_ROOT/src/AudioEngine \
+	$$CUSDR_ROOT/src/DataEngine \
+	$$CUSDR_ROOT/src/GL \
+	$$CUSDR_ROOT/src/QtDSP \
+	$$CUSDR_ROOT/src/Util
+
+# the QtDSP classes take their sample rate from the Settings singleton
+HEADERS += \
+	$$CUSDR_ROOT/src/cusdr_settings.h
+
+SOURCES += \
+	$$CUSDR_ROOT/src/cusdr_settings.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_simd.cpp
+
+unix:LIBS += -lfftw3f
+
+win32:LIBS += \
+	-L"$$CUSDR_ROOT/lib" \
+	-llibfftw3f-3 \
+	-luser32 \
+	-lKernel32
+
+OBJECTS_DIR = ./bld/o
+MOC_DIR = ./bld/moc
@@ -0,0 +1,20 @@
+# Unit tests and benchmarks of the DSP and data path classes.
+#
+#   qmake tests.pro && make && make check
+#
+# The benchmarks are QBENCHMARK test functions; run a single test binary with
+# -tickcounter or -iterations n for more stable figures.
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+	tst_chirpProcessor \
+	tst_demodulation \
+	tst_displayPrep \
+	tst_fftPlanner \
+	tst_filter \
+	tst_iqUnpacker \
+	tst_kernels \
+	tst_nco \
+	tst_powerSpectrum \
+	tst_wpagc
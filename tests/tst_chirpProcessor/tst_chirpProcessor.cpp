@@ -0,0 +1,259 @@
+/**
+* @file  tst_chirpProcessor.cpp
+* @brief ChirpProcessor distance and throughput tests on a synthetic chirp file
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <QtTest/QtTest>
+
+#include "cusdr_chirpProcessor.h"
+
+#include <qmath.h>
+
+// the chirp file: CHIRP_FILE_SECONDS of I/Q floats at CHIRP_FILE_RATE, one
+// chirp of CHIRP_DURATION_US per second, received CHIRP_DELAY samples after
+// the 1PPS
+#define CHIRP_FILE_RATE		48000
+#define CHIRP_FILE_SECONDS	10
+#define CHIRP_DURATION_US	500000
+#define CHIRP_DELAY			4800
+
+#define CHIRP_SLOT_BYTES	(CHIRP_BLOCK_SIZE * 2 * (int) sizeof(float))
+
+
+/*!
+	\brief Reads the chirp file into the chirp ring, as DataEngine does, and
+	stops the processor when it has taken the last block.
+*/
+class ChirpFeeder : public QThread {
+
+public:
+	ChirpFeeder(THPSDRParameter *io, ChirpProcessor *chirp, const QString &filename)
+		: QThread()
+		, m_io(io)
+		, m_chirp(chirp)
+		, m_filename(filename)
+	{
+	}
+
+protected:
+	void run() {
+
+		QFile file(m_filename);
+
+		if (file.open(QIODevice::ReadOnly)) {
+
+			qint64 position = 0;
+
+			forever {
+
+				// the ring is not allowed to drop blocks here
+				char *slot;
+				while (!(slot = m_io->chirp_queue.writeSlot()))
+					yieldCurrentThread();
+
+				if (file.read(slot, CHIRP_SLOT_BYTES) != CHIRP_SLOT_BYTES)
+					break;
+
+				m_io->chirp_queue.commitWrite(CHIRP_SLOT_BYTES, position);
+				position += CHIRP_BLOCK_SIZE;
+			}
+		}
+
+		while (!m_io->chirp_queue.isEmpty())
+			yieldCurrentThread();
+
+		m_chirp->stop();
+		m_io->chirp_queue.releaseWaiting();
+	}
+
+private:
+	THPSDRParameter	*m_io;
+	ChirpProcessor	*m_chirp;
+	QString			m_filename;
+};
+
+
+class tst_ChirpProcessor : public QObject {
+
+	Q_OBJECT
+
+public slots:
+	void distanceSpectrum(int sampleRate, qint64 length, const float *buffer);
+
+private slots:
+	void initTestCase();
+	void distance();
+	void throughput();
+
+private:
+	QTemporaryDir	m_dir;
+	QString			m_filename;
+
+	int		m_frames;
+	int		m_peakLag;
+
+	void	writeChirpFile();
+	int		streamFile(ChirpProcessor *chirp, THPSDRParameter *io);
+};
+
+// the chirp of ChirpProcessor::generateLocalChirp() at the file rate, with
+// a little noise
+void tst_ChirpProcessor::writeChirpFile() {
+
+	Settings *set = Settings::instance();
+
+	const qreal time = CHIRP_DURATION_US / 1.0E6;
+	const qint64 length = (qint64)(CHIRP_FILE_RATE * time);
+	const qreal a = ONEPI * (set->getUpperChirpFreq() - set->getLowerChirpFreq()) / time;
+	const qreal b = TWOPI * set->getLowerChirpFreq();
+
+	QVector<float> second(2 * CHIRP_FILE_RATE);
+	quint32 seed = 1;
+
+	for (int n = 0; n < CHIRP_FILE_RATE; n++) {
+
+		seed = seed * 1664525u + 1013904223u;
+		float re = 0.01f * (qint32)seed / 2147483648.0f;
+		seed = seed * 1664525u + 1013904223u;
+		float im = 0.01f * (qint32)seed / 2147483648.0f;
+
+		qint64 m = n - CHIRP_DELAY;
+		if (m >= 0 && m < length) {
+
+			qreal t = (qreal)m / length;
+			re += 0.5f * qSin(a * t * t + b * t);
+			im += 0.5f * qCos(a * t * t + b * t);
+		}
+
+		second[2 * n] = re;
+		second[2 * n + 1] = im;
+	}
+
+	m_filename = m_dir.path() + "/chirp.iq";
+
+	QFile file(m_filename);
+	QVERIFY(file.open(QIODevice::WriteOnly));
+
+	for (int s = 0; s < CHIRP_FILE_SECONDS; s++)
+		file.write((const char *) second.constData(), second.size() * sizeof(float));
+
+	file.close();
+}
+
+void tst_ChirpProcessor::distanceSpectrum(int sampleRate, qint64 length, const float *buffer) {
+
+	Q_UNUSED(sampleRate)
+
+	int peak = 0;
+	for (int i = 1; i < length; i++)
+		if (buffer[i] > buffer[peak])
+			peak = i;
+
+	m_peakLag = peak;
+	m_frames++;
+}
+
+// the whole file through the ring; returns the number of frames shown
+int tst_ChirpProcessor::streamFile(ChirpProcessor *chirp, THPSDRParameter *io) {
+
+	m_frames = 0;
+	m_peakLag = -1;
+
+	io->chirp_queue.clear();
+
+	ChirpFeeder feeder(io, chirp, m_filename);
+	feeder.start();
+
+	chirp->processChirpData();
+	feeder.wait();
+
+	return m_frames;
+}
+
+void tst_ChirpProcessor::initTestCase() {
+
+	Settings *set = Settings::instance();
+
+	set->loadSettings();
+	set->setSampleRate(this, CHIRP_FILE_RATE);
+	set->setChirpBufferDurationUs(CHIRP_DURATION_US);
+
+	QVERIFY(m_dir.isValid());
+	writeChirpFile();
+
+	QVERIFY(connect(
+		set,
+		SIGNAL(chirpSpectrumBufferChanged(int, qint64, const float *)),
+		this,
+		SLOT(distanceSpectrum(int, qint64, const float *)),
+		Qt::DirectConnection));
+}
+
+// A frame is shown once per second, apart from the first one and the one in
+// progress when the chirp is loaded. The peak is at the delay of the echo in
+// decimated samples.
+void tst_ChirpProcessor::distance() {
+
+	THPSDRParameter *io = new THPSDRParameter;
+	ChirpProcessor chirp(io);
+	chirp.generateLocalChirp();
+
+	int frames = streamFile(&chirp, io);
+	int lag = CHIRP_DELAY / Settings::instance()->getChirpDownSampleRate();
+
+	qDebug() << "frames:" << frames << "peak at lag" << m_peakLag << "expected" << lag;
+	QVERIFY(frames >= CHIRP_FILE_SECONDS - 2);
+	QVERIFY(qAbs(m_peakLag - lag) <= 1);
+
+	delete io;
+}
+
+// CHIRP_FILE_SECONDS of samples per iteration, from the file to the
+// distance spectrum
+void tst_ChirpProcessor::throughput() {
+
+	THPSDRParameter *io = new THPSDRParameter;
+	ChirpProcessor chirp(io);
+	chirp.generateLocalChirp();
+
+	QElapsedTimer timer;
+	qint64 nsecs = 0;
+	int runs = 0;
+
+	QBENCHMARK {
+
+		timer.start();
+		streamFile(&chirp, io);
+		nsecs += timer.nsecsElapsed();
+		runs++;
+	}
+
+	qDebug() << "real time factor:" << CHIRP_FILE_SECONDS * 1.0E9 * runs / nsecs;
+
+	delete io;
+}
+
+QTEST_MAIN(tst_ChirpProcessor)
+
+#include "tst_chirpProcessor.moc"
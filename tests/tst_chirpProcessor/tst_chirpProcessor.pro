@@ -0,0 +1,15 @@
+TARGET = tst_chirpProcessor
+
+include(../tests.pri)
+
+HEADERS += \
+	$$CUSDR_ROOT/src/DataEngine/cusdr_chirpProcessor.h \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_fft.h \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_filter.h
+
+SOURCES += \
+	tst_chirpProcessor.cpp \
+	$$CUSDR_ROOT/src/DataEngine/cusdr_chirpProcessor.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_fft.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_filter.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_kernels.cpp
@@ -0,0 +1,332 @@
+/**
+* @file  tst_demodulation.cpp
+* @brief Demodulation accuracy tests and per mode benchmark
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <QtTest/QtTest>
+
+#include "qtdsp_demodulation.h"
+
+#include <qmath.h>
+
+// one benchmark iteration demodulates DEMOD_BLOCKS blocks of DEMOD_BLOCK
+// samples, 10^6 samples: "msecs per iteration" reads as ns per sample
+#define DEMOD_BLOCK		1000
+#define DEMOD_BLOCKS	1000
+
+// samples of the accuracy test and the settling time left out of it
+#define DEMOD_SAMPLES	(64 * DEMOD_BLOCK)
+#define DEMOD_SETTLE	(8 * DEMOD_BLOCK)
+
+
+/*
+	The AM, SAM and FMN demodulators before the table phasor: the PLL
+	oscillator from qCos/qSin, the phase error from qAtan2, the envelope from
+	sqrt, the phase wrapped with while loops. Loop gains as in
+	Demodulation::setDemodMode().
+*/
+class ReferenceDemodulation {
+
+public:
+	ReferenceDemodulation(DSPMode mode, float sampleRate)
+		: m_mode(mode)
+		, m_phase(0.0f)
+		, m_dc(0.0f)
+		, m_afc(0.0f)
+		, m_lockcurrent(0.5f)
+		, m_pll_frequency(0.0f)
+		, m_pll_lo_limit(-1000.0f)
+		, m_pll_hi_limit(1000.0f)
+	{
+		float bandwidth = (mode == FMN) ? 10000.0f : 500.0f;
+
+		m_alpha = 0.3 * bandwidth * (TWOPI / sampleRate);
+		m_beta = m_alpha * m_alpha * 0.25;
+		m_cvt = ((0.45f * sampleRate) / ONEPI) / bandwidth;
+	}
+
+	void ProcessBlock(const cpx *in, float *out, int size) {
+
+		switch (m_mode) {
+
+			case AM:	DoMagnitude(in, out, size); break;
+			case SAM:	DoSAM(in, out, size); break;
+			case FMN:	DoFMN(in, out, size); break;
+			default:	break;
+		}
+	}
+
+private:
+	DSPMode	m_mode;
+
+	float	m_phase;
+	float	m_alpha;
+	float	m_beta;
+	float	m_cvt;
+	float	m_dc;
+	float	m_afc;
+	float	m_lockcurrent;
+	float	m_pll_frequency;
+	float	m_pll_lo_limit;
+	float	m_pll_hi_limit;
+
+	void DoMagnitude(const cpx *in, float *out, int size) {
+
+		for (int i = 0; i < size; i++)
+			out[i] = sqrt(in[i].re * in[i].re + in[i].im * in[i].im);
+	}
+
+	void DoSAM(const cpx *in, float *out, int size) {
+
+		for (int i = 0; i < size; i++) {
+
+			float oscRe = qCos(m_phase);
+			float oscIm = qSin(m_phase);
+
+			float re = oscRe * in[i].re + oscIm * in[i].im;
+			float im = -oscIm * in[i].re + oscRe * in[i].im;
+
+			if (im == 0.0 && re == 0.0)
+				re = 0.000000000001f;
+
+			float difference = sqrt(in[i].re * in[i].re + in[i].im * in[i].im) * qAtan2(im, re);
+
+			m_pll_frequency += m_beta * difference;
+
+			if (m_pll_frequency < m_pll_lo_limit)
+				m_pll_frequency = m_pll_lo_limit;
+
+			if (m_pll_frequency > m_pll_hi_limit)
+				m_pll_frequency = m_pll_hi_limit;
+
+			m_phase += m_pll_frequency + m_alpha * difference;
+
+			while (m_phase >= TWOPI)
+				m_phase -= (float)TWOPI;
+
+			while (m_phase < 0)
+				m_phase += (float)TWOPI;
+
+			m_lockcurrent = 0.999 * m_lockcurrent + 0.001 * qAbs(re);
+			m_dc = (0.999 * m_dc) + (0.001 * re);
+
+			out[i] = re - m_dc;
+		}
+	}
+
+	void DoFMN(const cpx *in, float *out, int size) {
+
+		for (int i = 0; i < size; i++) {
+
+			float oscRe = qCos(m_phase);
+			float oscIm = qSin(m_phase);
+
+			float re = oscRe * in[i].re + oscIm * in[i].im;
+			float im = -oscIm * in[i].re + oscRe * in[i].im;
+
+			if (im == 0.0 && re == 0.0)
+				re = 0.000000000001f;
+
+			float difference = qAtan2(im, re);
+
+			m_pll_frequency += m_beta * difference;
+
+			if (m_pll_frequency < m_pll_lo_limit)
+				m_pll_frequency = m_pll_lo_limit;
+
+			if (m_pll_frequency > m_pll_hi_limit)
+				m_pll_frequency = m_pll_hi_limit;
+
+			m_phase += m_pll_frequency + m_alpha * difference;
+
+			while (m_phase >= TWOPI)
+				m_phase -= (float)TWOPI;
+
+			while (m_phase < 0)
+				m_phase += (float)TWOPI;
+
+			m_afc = 0.99 * m_afc + 0.01 * m_pll_frequency;
+			out[i] = (m_pll_frequency - m_afc) * m_cvt;
+		}
+	}
+};
+
+
+class tst_Demodulation : public QObject {
+
+	Q_OBJECT
+
+private slots:
+	void accuracy_data();
+	void accuracy();
+
+	void benchmark_data();
+	void benchmark();
+
+private:
+	void	addRows(bool implementations);
+	CPX		testSignal(DSPMode mode, float sampleRate, int size);
+};
+
+void tst_Demodulation::addRows(bool implementations) {
+
+	QTest::addColumn<int>("mode");
+	QTest::addColumn<int>("sampleRate");
+	QTest::addColumn<bool>("reference");
+
+	const int modes[3] = { AM, SAM, FMN };
+	const char *names[3] = { "AM", "SAM", "FMN" };
+	const int rates[2] = { 48000, 384000 };
+
+	for (int m = 0; m < 3; m++) {
+
+		for (int r = 0; r < 2; r++) {
+
+			QString row = QString("%1 %2 kHz").arg(names[m]).arg(rates[r] / 1000);
+
+			if (implementations) {
+
+				QTest::newRow(qPrintable(row + " libm (before)")) << modes[m] << rates[r] << true;
+				QTest::newRow(qPrintable(row + " table (now)")) << modes[m] << rates[r] << false;
+			}
+			else
+				QTest::newRow(qPrintable(row)) << modes[m] << rates[r] << false;
+		}
+	}
+}
+
+// A carrier 300 Hz off the tuned frequency, AM modulated 50 % with 700 Hz
+// for AM and SAM, FM modulated with 1 kHz at 3 kHz deviation for FMN.
+CPX tst_Demodulation::testSignal(DSPMode mode, float sampleRate, int size) {
+
+	CPX signal(size);
+
+	double phase = 0.0;
+	for (int i = 0; i < size; i++) {
+
+		double t = i / (double) sampleRate;
+		double amplitude = 0.1;
+
+		if (mode == FMN)
+			phase = 2.0 * M_PI * 300.0 * t + 3.0 * sin(2.0 * M_PI * 1000.0 * t);
+		else {
+
+			phase = 2.0 * M_PI * 300.0 * t;
+			amplitude *= 1.0 + 0.5 * sin(2.0 * M_PI * 700.0 * t);
+		}
+
+		signal[i].re = (float)(amplitude * cos(phase));
+		signal[i].im = (float)(amplitude * sin(phase));
+	}
+
+	return signal;
+}
+
+void tst_Demodulation::accuracy_data() {
+
+	addRows(false);
+}
+
+// After the loops have settled, the audio of the table demodulators must
+// match that of the libm ones to within -80 dB of its power.
+void tst_Demodulation::accuracy() {
+
+	QFETCH(int, mode);
+	QFETCH(int, sampleRate);
+
+	Demodulation demod(0, DEMOD_BLOCK);
+	demod.setSampleRate(0, sampleRate);
+	demod.setDemodMode((DSPMode) mode);
+
+	ReferenceDemodulation reference((DSPMode) mode, sampleRate);
+
+	CPX signal = testSignal((DSPMode) mode, sampleRate, DEMOD_SAMPLES);
+	QVector<float> out(DEMOD_SAMPLES);
+	QVector<float> ref(DEMOD_SAMPLES);
+
+	for (int i = 0; i < DEMOD_SAMPLES; i += DEMOD_BLOCK) {
+
+		CPX block(DEMOD_BLOCK);
+		memcpy(block.data(), signal.constData() + i, DEMOD_BLOCK * sizeof(cpx));
+
+		demod.ProcessBlock(block, out.data() + i, DEMOD_BLOCK);
+		reference.ProcessBlock(block.constData(), ref.data() + i, DEMOD_BLOCK);
+	}
+
+	double power = 0.0;
+	double error = 0.0;
+	for (int i = DEMOD_SETTLE; i < DEMOD_SAMPLES; i++) {
+
+		power += (double) ref.at(i) * ref.at(i);
+		error += (double)(out.at(i) - ref.at(i)) * (out.at(i) - ref.at(i));
+	}
+
+	QVERIFY(power > 0.0);
+
+	double errorDb = 10.0 * log10(error / power + 1e-30);
+	qDebug() << "error:" << errorDb << "dB";
+	QVERIFY(errorDb < -80.0);
+}
+
+void tst_Demodulation::benchmark_data() {
+
+	addRows(true);
+}
+
+void tst_Demodulation::benchmark() {
+
+	QFETCH(int, mode);
+	QFETCH(int, sampleRate);
+	QFETCH(bool, reference);
+
+	Demodulation demod(0, DEMOD_BLOCK);
+	demod.setSampleRate(0, sampleRate);
+	demod.setDemodMode((DSPMode) mode);
+
+	ReferenceDemodulation ref((DSPMode) mode, sampleRate);
+
+	CPX block = testSignal((DSPMode) mode, sampleRate, DEMOD_BLOCK);
+	QVector<float> out(DEMOD_BLOCK);
+
+	if (reference) {
+
+		QBENCHMARK {
+
+			for (int b = 0; b < DEMOD_BLOCKS; b++)
+				ref.ProcessBlock(block.constData(), out.data(), DEMOD_BLOCK);
+		}
+	}
+	else {
+
+		QBENCHMARK {
+
+			for (int b = 0; b < DEMOD_BLOCKS; b++)
+				demod.ProcessBlock(block, out.data(), DEMOD_BLOCK);
+		}
+	}
+}
+
+QTEST_MAIN(tst_Demodulation)
+
+#include "tst_demodulation.moc"
@@ -0,0 +1,12 @@
+TARGET = tst_demodulation
+
+include(../tests.pri)
+
+HEADERS += \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_demodulation.h
+
+SOURCES += \
+	tst_demodulation.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_demodulation.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_kernels.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_nco.cpp
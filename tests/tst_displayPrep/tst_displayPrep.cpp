@@ -0,0 +1,349 @@
+/**
+* @file  tst_displayPrep.cpp
+* @brief DisplayPrep tests and waterfall colour benchmark
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <QtTest/QtTest>
+
+#include "cusdr_oglDisplayPrep.h"
+
+// displayed bins, one pixel each
+#define PREP_BINS		4096
+
+// dBm scale of the panel and DisplayPrep's initial log gain
+#define PREP_DBM_MIN	-140
+#define PREP_DBM_MAX	-40
+#define PREP_LOG_GAIN	47
+
+
+// The Enhanced branch of QGLReceiverPanel::getWaterfallColorAtPixel() for a
+// black to white waterfall without offsets: the per bin colour step before
+// the palette.
+static QColor waterfallColor(qreal value) {
+
+	const QColor loColor(0, 0, 0);
+	const QColor hiColor(255, 255, 255);
+
+	int lowerThreshold = PREP_DBM_MIN;
+	int upperThreshold = PREP_DBM_MAX;
+	int r, g, b;
+
+	if (value <= lowerThreshold)
+		return loColor;
+
+	if (value >= upperThreshold)
+		return hiColor;
+
+	float offset = value - lowerThreshold;
+	float globalRange = offset / (PREP_DBM_MAX - PREP_DBM_MIN);
+	float localRange;
+
+	if (globalRange < (float)2/9) {
+
+		localRange = globalRange / ((float)2/9);
+		r = (int)((1.0 - localRange) * loColor.red());
+		g = (int)((1.0 - localRange) * loColor.green());
+		b = (int)(loColor.blue() + localRange * (255 - loColor.blue()));
+	}
+	else
+	if (globalRange < (float)3/9) {
+
+		localRange = (globalRange - (float)2/9) / ((float)1/9);
+		r = 0;
+		g = (int)(localRange * 255);
+		b = 255;
+	}
+	else
+	if (globalRange < (float)4/9) {
+
+		localRange = (globalRange - (float)3/9) / ((float)1/9);
+		r = 0;
+		g = 255;
+		b = (int)((1.0 - localRange) * 255);
+	}
+	else
+	if (globalRange < (float)5/9) {
+
+		localRange = (globalRange - (float)4/9) / ((float)1/9);
+		r = (int)(localRange * 255);
+		g = 255;
+		b = 0;
+	}
+	else
+	if (globalRange < (float)7/9) {
+
+		localRange = (globalRange - (float)5/9) / ((float)2/9);
+		r = 255;
+		g = (int)((1.0 - localRange) * 255);
+		b = 0;
+	}
+	else
+	if (globalRange < (float)8/9) {
+
+		localRange = (globalRange - (float)7/9) / ((float)1/9);
+		r = 255;
+		g = 0;
+		b = (int)(localRange * 255);
+	}
+	else {
+
+		localRange = (globalRange - (float)8/9) / ((float)1/9);
+		r = (int)((0.75 + 0.25 * (1.0 - localRange)) * 255);
+		g = (int)(localRange * 255 * 0.5);
+		b = 255;
+	}
+
+	return QColor(qBound(0, r, 255), qBound(0, g, 255), qBound(0, b, 255), 255);
+}
+
+
+class tst_DisplayPrep : public QObject {
+
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+
+	void waterfallRow();
+	void sampleSize();
+
+	void benchmark_data();
+	void benchmark();
+
+private:
+	DisplayPrep			*m_prep;
+	TDisplayPrepParams	m_params;
+	TDisplayFrame		m_frame;
+	QVector<float>		m_spectrum;
+	QVector<float>		m_values;
+
+	void	processSpectrum();
+};
+
+// The palette is built the way QGLReceiverPanel::updateWaterfallLut() does.
+void tst_DisplayPrep::initTestCase() {
+
+	// receiver data from the defaults, FFT auto off
+	Settings::instance()->loadSettings();
+
+	m_params.serverMode = QSDR::SDRMode;
+	m_params.dataEngineState = QSDR::DataEngineUp;
+	m_params.spectrumSize = PREP_BINS;
+	m_params.panRectWidth = PREP_BINS;
+	m_params.freqScaleZoomFactor = 1.0;
+	m_params.dBmPanMin = PREP_DBM_MIN;
+	m_params.mercuryAttenuator = false;
+	m_params.peakHold = true;
+	m_params.peakHoldReset = 0;
+
+	m_params.waterfallLut.resize(WATERFALL_LUT_SIZE + 2);
+
+	qreal step = (qreal)(PREP_DBM_MAX - PREP_DBM_MIN) / WATERFALL_LUT_SIZE;
+
+	for (int i = 0; i < WATERFALL_LUT_SIZE + 2; i++) {
+
+		qreal value;
+		if (i == 0)
+			value = PREP_DBM_MIN;
+		else if (i == WATERFALL_LUT_SIZE + 1)
+			value = PREP_DBM_MAX;
+		else
+			value = PREP_DBM_MIN + (i - 0.5) * step;
+
+		QColor pColor = waterfallColor(value);
+
+		m_params.waterfallLut[i].red   = (uchar)(pColor.red());
+		m_params.waterfallLut[i].green = (uchar)(pColor.green());
+		m_params.waterfallLut[i].blue  = (uchar)(pColor.blue());
+		m_params.waterfallLut[i].alpha = 255;
+	}
+
+	m_params.waterfallLutLo = PREP_DBM_MIN;
+	m_params.waterfallLutScale = (float) WATERFALL_LUT_SIZE / (PREP_DBM_MAX - PREP_DBM_MIN);
+
+	// a ramp from 10 dB below to 10 dB above the colour range, off the
+	// palette grid, so that every colour segment and both clamps are hit
+	m_spectrum.resize(PREP_BINS);
+	m_values.resize(PREP_BINS);
+	for (int i = 0; i < PREP_BINS; i++) {
+
+		m_values[i] = PREP_DBM_MIN - 10 + (i + 0.37f) * (PREP_DBM_MAX - PREP_DBM_MIN + 20) / PREP_BINS;
+		m_spectrum[i] = m_values.at(i) + PREP_LOG_GAIN;
+	}
+
+	m_prep = new DisplayPrep(0, PREP_BINS);
+	m_prep->setParams(m_params);
+}
+
+void tst_DisplayPrep::cleanupTestCase() {
+
+	delete m_prep;
+}
+
+// publishes the spectrum and runs the worker's slot on this thread
+void tst_DisplayPrep::processSpectrum() {
+
+	QHMailbox<qVectorFloat> *mailbox = Settings::instance()->spectrumMailbox(0);
+
+	mailbox->writeSlot() = m_spectrum;
+	mailbox->commitWrite();
+
+	m_prep->processSpectrum(0);
+}
+
+// The palette colour of each bin may differ from the direct colour by the
+// rounding of half a palette step, one level at most.
+void tst_DisplayPrep::waterfallRow() {
+
+	processSpectrum();
+	QVERIFY(m_prep->takeFrame(m_frame));
+
+	QCOMPARE(m_frame.scaleMult, 1.0);
+	QCOMPARE(m_frame.panadapterBins.size(), PREP_BINS);
+	QVERIFY(m_frame.waterfallRow.size() >= PREP_BINS);
+
+	int worst = 0;
+	for (int i = 0; i < PREP_BINS; i++) {
+
+		QColor ref = waterfallColor(m_values.at(i));
+		const TGL_ubyteRGBA &color = m_frame.waterfallRow.at(i);
+
+		worst = qMax(worst, qAbs(color.red - ref.red()));
+		worst = qMax(worst, qAbs(color.green - ref.green()));
+		worst = qMax(worst, qAbs(color.blue - ref.blue()));
+		QCOMPARE((int) color.alpha, 255);
+	}
+
+	qDebug() << "worst colour level difference:" << worst;
+	QVERIFY(worst <= 1);
+
+	QVERIFY(!m_prep->takeFrame(m_frame));
+}
+
+// Zooming in to a quarter leaves 1024 bins, so DisplayPrep asks for the 8k
+// FFT; back at full width it asks for the 4k FFT again. The spectrum that
+// triggered a switch is dropped.
+void tst_DisplayPrep::sampleSize() {
+
+	QVERIFY2(!Settings::instance()->getFFTAutoStatus(0), "FFT auto is on for receiver 0");
+
+	QSignalSpy spy(m_prep, SIGNAL(sampleSizeRequested(int, int)));
+
+	TDisplayPrepParams params = m_params;
+	params.freqScaleZoomFactor = 0.25;
+	m_prep->setParams(params);
+
+	processSpectrum();
+	QVERIFY(!m_prep->takeFrame(m_frame));
+	QCOMPARE(spy.count(), 1);
+	QCOMPARE(spy.at(0).at(0).toInt(), 0);
+	QCOMPARE(spy.at(0).at(1).toInt(), 8192);
+
+	processSpectrum();
+	QVERIFY(m_prep->takeFrame(m_frame));
+	QCOMPARE(m_frame.fftMult, 2);
+	QCOMPARE(spy.count(), 1);
+
+	m_prep->setParams(m_params);
+
+	processSpectrum();
+	QVERIFY(!m_prep->takeFrame(m_frame));
+	QCOMPARE(spy.count(), 2);
+	QCOMPARE(spy.at(1).at(1).toInt(), 4096);
+
+	processSpectrum();
+	QVERIFY(m_prep->takeFrame(m_frame));
+	QCOMPARE(m_frame.fftMult, 1);
+}
+
+// One iteration colours PREP_BINS bins. The first two rows time the colour
+// step alone: the direct colour with the QColor copy into the row as
+// computeDisplayBins did it before, and the palette lookup of
+// DisplayPrep::waterfallLutColor(). The last row is the whole of
+// computeDisplayBins for one spectrum, including the mailbox hand over.
+void tst_DisplayPrep::benchmark_data() {
+
+	QTest::addColumn<int>("step");
+
+	QTest::newRow("getWaterfallColorAtPixel (before)") << 0;
+	QTest::newRow("palette lookup (now)") << 1;
+	QTest::newRow("computeDisplayBins (now)") << 2;
+}
+
+void tst_DisplayPrep::benchmark() {
+
+	QFETCH(int, step);
+
+	QVector<TGL_ubyteRGBA> row(PREP_BINS);
+	TGL_ubyteRGBA *out = row.data();
+	const float *values = m_values.constData();
+
+	const TGL_ubyteRGBA *lut = m_params.waterfallLut.constData();
+	const float lo = m_params.waterfallLutLo;
+	const float scale = m_params.waterfallLutScale;
+
+	switch (step) {
+
+		case 0:
+			QBENCHMARK {
+
+				for (int i = 0; i < PREP_BINS; i++) {
+
+					QColor pColor = waterfallColor(values[i]);
+
+					out[i].red   = (uchar)(pColor.red());
+					out[i].green = (uchar)(pColor.green());
+					out[i].blue  = (uchar)(pColor.blue());
+					out[i].alpha = 255;
+				}
+			}
+			break;
+
+		case 1:
+			QBENCHMARK {
+
+				for (int i = 0; i < PREP_BINS; i++) {
+
+					float x = (values[i] - lo) * scale;
+					int idx = x <= 0.0f ? 0 : (x >= WATERFALL_LUT_SIZE ? WATERFALL_LUT_SIZE + 1 : 1 + (int) x);
+
+					out[i] = lut[idx];
+				}
+			}
+			break;
+
+		case 2:
+			QBENCHMARK {
+
+				processSpectrum();
+				m_prep->takeFrame(m_frame);
+			}
+			break;
+	}
+}
+
+QTEST_MAIN(tst_DisplayPrep)
+
+#include "tst_displayPrep.moc"
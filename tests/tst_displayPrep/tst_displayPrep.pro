@@ -0,0 +1,11 @@
+TARGET = tst_displayPrep
+
+include(../tests.pri)
+
+HEADERS += \
+	$$CUSDR_ROOT/src/GL/cusdr_oglDisplayPrep.h
+
+SOURCES += \
+	tst_displayPrep.cpp \
+	$$CUSDR_ROOT/src/GL/cusdr_oglDisplayPrep.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_envelope.cpp
@@ -0,0 +1,109 @@
+/**
+* @file  tst_fftPlanner.cpp
+* @brief FFTW wisdom store test and cold/warm start benchmark
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+
+#include "qtdsp_fft.h"
+
+// smallest and largest FFT size planned by the QFFT users (QFilter
+// partitions at 384 kHz .. the largest panadapter spectrum)
+#define PLANNER_MIN_SIZE	256
+#define PLANNER_MAX_SIZE	262144
+
+
+/*
+	Plans every power of two size from PLANNER_MIN_SIZE to PLANNER_MAX_SIZE
+	the way the application does, once without wisdom (first start) and
+	once after importing the wisdom file the first run has written (every
+	later start). The wall time of each run is the benchmark result.
+*/
+class tst_QFFTPlanner : public QObject {
+
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+
+	void coldStart();
+	void warmStart();
+
+private:
+	QTemporaryDir	m_dir;
+
+	qint64	planSizes();
+};
+
+void tst_QFFTPlanner::initTestCase() {
+
+	QVERIFY(m_dir.isValid());
+}
+
+// both directions of each size, as in the QFFT constructor
+qint64 tst_QFFTPlanner::planSizes() {
+
+	QElapsedTimer timer;
+	timer.start();
+
+	for (int size = PLANNER_MIN_SIZE; size <= PLANNER_MAX_SIZE; size *= 2)
+		delete new QFFT(size);
+
+	return timer.elapsed();
+}
+
+void tst_QFFTPlanner::coldStart() {
+
+	fftwf_forget_wisdom();
+	QVERIFY(!QFFTPlanner::loadWisdom(m_dir.path()));
+
+	qint64 planned = QFFTPlanner::planningTime();
+	qint64 elapsed = planSizes();
+
+	// every size was measured and went into the wisdom file
+	QVERIFY(QFile::exists(QFFTPlanner::wisdomFilename()));
+
+	qDebug() << "cold start:" << elapsed << "ms," << QFFTPlanner::planningTime() - planned << "ms of it measuring plans";
+	QTest::setBenchmarkResult(elapsed, QTest::WalltimeMilliseconds);
+}
+
+void tst_QFFTPlanner::warmStart() {
+
+	fftwf_forget_wisdom();
+	QVERIFY(QFFTPlanner::loadWisdom(m_dir.path()));
+
+	qint64 planned = QFFTPlanner::planningTime();
+	qint64 elapsed = planSizes();
+
+	// no size had to be measured again
+	QCOMPARE(QFFTPlanner::planningTime(), planned);
+
+	qDebug() << "warm start:" << elapsed << "ms";
+	QTest::setBenchmarkResult(elapsed, QTest::WalltimeMilliseconds);
+}
+
+QTEST_MAIN(tst_QFFTPlanner)
+
+#include "tst_fftPlanner.moc"
@@ -0,0 +1,11 @@
+TARGET = tst_fftPlanner
+
+include(../tests.pri)
+
+HEADERS += \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_fft.h
+
+SOURCES += \
+	tst_fftPlanner.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_fft.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_kernels.cpp
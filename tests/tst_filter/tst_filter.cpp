@@ -0,0 +1,203 @@
+/**
+* @file  tst_filter.cpp
+* @brief QFilter accuracy, design latency and processing benchmarks
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <QtTest/QtTest>
+
+#include "qtdsp_filter.h"
+
+#include <qmath.h>
+
+// block size of the receiver filter at 48 kHz
+#define FILTER_BLOCK	1024
+
+
+// reproducible noise in -1 .. 1
+static float noise(quint32 &state) {
+
+	state = state * 1664525u + 1013904223u;
+	return (qint32)state / 2147483648.0f;
+}
+
+static CPX noiseBuffer(int length, quint32 seed) {
+
+	CPX buf(length);
+	for (int i = 0; i < length; i++) {
+
+		buf[i].re = noise(seed);
+		buf[i].im = noise(seed);
+	}
+	return buf;
+}
+
+
+class tst_QFilter : public QObject {
+
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+	void convolution_data();
+	void convolution();
+	void design_data();
+	void design();
+	void process_data();
+	void process();
+};
+
+void tst_QFilter::initTestCase() {
+
+	Settings::instance()->loadSettings();
+}
+
+void tst_QFilter::convolution_data() {
+
+	QTest::addColumn<int>("taps");
+
+	QTest::newRow("1000 taps") << 1000;
+	QTest::newRow("3000 taps") << 3000;
+	QTest::newRow("8192 taps") << 8192;
+}
+
+// a stream through loaded taps equals their direct convolution with it,
+// whatever the number of partitions
+void tst_QFilter::convolution() {
+
+	QFETCH(int, taps);
+
+	const int blocks = taps / FILTER_BLOCK + 3;
+
+	CPX h = noiseBuffer(taps, 1);
+	CPX x = noiseBuffer(blocks * FILTER_BLOCK, 2);
+
+	QFilter filter(0, FILTER_BLOCK, 2, 12);
+	filter.loadTaps(h, taps);
+	filter.waitForDesign();
+
+	CPX in(FILTER_BLOCK);
+	CPX out(FILTER_BLOCK);
+
+	double error = 0.0;
+	double power = 0.0;
+
+	for (int b = 0; b < blocks; b++) {
+
+		memcpy(in.data(), x.constData() + b * FILTER_BLOCK, sizeof(cpx) * FILTER_BLOCK);
+		filter.ProcessFilter(in, out, FILTER_BLOCK);
+
+		// the filter taken before the first block is not faded in
+		for (int i = 0; i < FILTER_BLOCK; i++) {
+
+			int n = b * FILTER_BLOCK + i;
+			double re = 0.0;
+			double im = 0.0;
+
+			for (int k = 0; k < taps && k <= n; k++) {
+
+				re += (double)h.at(k).re * x.at(n - k).re - (double)h.at(k).im * x.at(n - k).im;
+				im += (double)h.at(k).re * x.at(n - k).im + (double)h.at(k).im * x.at(n - k).re;
+			}
+
+			error += (out.at(i).re - re) * (out.at(i).re - re) + (out.at(i).im - im) * (out.at(i).im - im);
+			power += re * re + im * im;
+		}
+	}
+
+	double snr = 10.0 * log10(power / error);
+
+	qDebug() << "error:" << -snr << "dB";
+	QVERIFY(snr > 100.0);
+}
+
+void tst_QFilter::design_data() {
+
+	QTest::addColumn<int>("taps");
+
+	QTest::newRow("1024 taps") << 1024;
+	QTest::newRow("2048 taps") << 2048;
+	QTest::newRow("4096 taps") << 4096;
+	QTest::newRow("8192 taps") << 8192;
+}
+
+// Latency of a retune, from setFilter() until the design thread has
+// published the new filter; ProcessFilter() takes it with the next block.
+// The time setFilter() itself keeps the calling thread is printed apart.
+void tst_QFilter::design() {
+
+	QFETCH(int, taps);
+
+	QFilter filter(0, FILTER_BLOCK, 2, 12);
+	filter.setFilterLength(taps);
+	filter.waitForDesign();
+
+	QElapsedTimer timer;
+	qint64 posting = 0;
+	int retunes = 0;
+
+	QBENCHMARK {
+
+		float hi = (retunes & 1) ? 2700.0f : 3000.0f;
+
+		timer.start();
+		filter.setFilter(150.0f, hi);
+		posting += timer.nsecsElapsed();
+		retunes++;
+
+		filter.waitForDesign();
+	}
+
+	qDebug() << "setFilter() on the calling thread:" << posting / retunes / 1000.0 << "us";
+}
+
+void tst_QFilter::process_data() {
+
+	design_data();
+}
+
+// CPU time per block of 1024 samples, one forward and one inverse FFT plus
+// one complex multiply accumulate per partition
+void tst_QFilter::process() {
+
+	QFETCH(int, taps);
+
+	QFilter filter(0, FILTER_BLOCK, 2, 12);
+	filter.setFilterLength(taps);
+	filter.waitForDesign();
+
+	CPX in = noiseBuffer(FILTER_BLOCK, 3);
+	CPX out(FILTER_BLOCK);
+
+	// the new length is faded in over the first block
+	filter.ProcessFilter(in, out, FILTER_BLOCK);
+
+	QBENCHMARK {
+
+		filter.ProcessFilter(in, out, FILTER_BLOCK);
+	}
+}
+
+QTEST_MAIN(tst_QFilter)
+
+#include "tst_filter.moc"
@@ -0,0 +1,13 @@
+TARGET = tst_filter
+
+include(../tests.pri)
+
+HEADERS += \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_fft.h \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_filter.h
+
+SOURCES += \
+	tst_filter.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_fft.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_filter.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_kernels.cpp
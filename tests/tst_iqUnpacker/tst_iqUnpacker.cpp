@@ -0,0 +1,248 @@
+/**
+* @file  tst_iqUnpacker.cpp
+* @brief IQ frame unpacker test and benchmark
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <QtTest/QtTest>
+
+#include "cusdr_iqUnpacker.h"
+#include "qtdsp_qComplex.h"
+
+// full USB frame: 3 sync bytes, 5 C&C bytes and the payload
+#define USB_FRAME_SIZE		512
+// frames per benchmark iteration
+#define BENCH_FRAMES		64
+
+
+/*
+	The byte by byte decoder DataProcessor::processInputBuffer used before
+	IQFrameUnpacker, including its per receiver count sample limits. It is
+	kept here as the reference for the results and the benchmark.
+*/
+static int decodeReference(const QByteArray &buffer, int receivers, CPX *rx, float *mic) {
+
+	int s = 8;
+	int maxSamples = 0;
+
+	switch (receivers) {
+
+		case 1: maxSamples = 512-0;  break;
+		case 2: maxSamples = 512-0;  break;
+		case 3: maxSamples = 512-4;  break;
+		case 4: maxSamples = 512-10; break;
+		case 5: maxSamples = 512-24; break;
+		case 6: maxSamples = 512-10; break;
+		case 7: maxSamples = 512-20; break;
+		case 8: maxSamples = 512-4;  break;
+	}
+
+	int samples = 0;
+	while (s < maxSamples) {
+
+		for (int r = 0; r < receivers; r++) {
+
+			int leftSample   = (int)((  signed char) buffer.at(s++)) << 16;
+			leftSample      += (int)((unsigned char) buffer.at(s++)) << 8;
+			leftSample      += (int)((unsigned char) buffer.at(s++));
+			int rightSample  = (int)((  signed char) buffer.at(s++)) << 16;
+			rightSample     += (int)((unsigned char) buffer.at(s++)) << 8;
+			rightSample     += (int)((unsigned char) buffer.at(s++));
+
+			rx[r][samples].re = (float)(leftSample / 8388607.0f);
+			rx[r][samples].im = (float)(rightSample / 8388607.0f);
+		}
+
+		int micSample  = (int)((signed char) buffer.at(s++)) << 8;
+		micSample     += (int)((unsigned char) buffer.at(s++));
+		mic[samples] = (float) micSample / 32767.0f;
+
+		samples++;
+	}
+
+	return samples;
+}
+
+// IQFrameUnpacker followed by the copy into the receiver blocks, as
+// DataProcessor::processInputBuffer does it now
+static int decodeUnpacker(IQFrameUnpacker &unpacker, const char *frame, int receivers, CPX *rx, float *mic) {
+
+	int samples = unpacker.unpack(frame + 8, receivers);
+
+	for (int r = 0; r < receivers; r++) {
+
+		const float *iBuf = unpacker.i(r);
+		const float *qBuf = unpacker.q(r);
+		cpx *dst = rx[r].data();
+
+		for (int j = 0; j < samples; j++) {
+
+			dst[j].re = iBuf[j];
+			dst[j].im = qBuf[j];
+		}
+	}
+
+	memcpy(mic, unpacker.mic(), samples * sizeof(float));
+
+	return samples;
+}
+
+
+class tst_IQFrameUnpacker : public QObject {
+
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+
+	void unpack_data();
+	void unpack();
+
+	void benchmark_data();
+	void benchmark();
+
+private:
+	// BENCH_FRAMES frames of random samples, each with USB_FRAME_OVERREAD
+	// bytes of padding behind it as in the IQ ring slots
+	QList<QByteArray>	m_frames;
+
+	CPX		m_rx[MAX_RECEIVERS];
+	float	m_mic[USB_FRAME_MAX_SAMPLES];
+};
+
+void tst_IQFrameUnpacker::initTestCase() {
+
+	qsrand(1);
+
+	for (int f = 0; f < BENCH_FRAMES; f++) {
+
+		QByteArray frame(USB_FRAME_SIZE + USB_FRAME_OVERREAD, 0);
+
+		frame[0] = frame[1] = frame[2] = SYNC;
+		for (int i = 3; i < USB_FRAME_SIZE; i++)
+			frame[i] = (char)(qrand() & 0xff);
+
+		// full scale values of both signs in the first samples
+		if (f == 0) {
+
+			frame[8] = 0x7f; frame[9] = (char) 0xff; frame[10] = (char) 0xff;
+			frame[11] = (char) 0x80; frame[12] = 0x00; frame[13] = 0x00;
+		}
+
+		m_frames.append(frame);
+	}
+
+	for (int r = 0; r < MAX_RECEIVERS; r++)
+		m_rx[r].resize(USB_FRAME_MAX_SAMPLES);
+
+	qDebug() << "unpacker code path:" << QtDSP::simdLevelName(QtDSP::simdLevel())
+			 << "on" << QtDSP::cpuModelName();
+}
+
+void tst_IQFrameUnpacker::unpack_data() {
+
+	QTest::addColumn<int>("receivers");
+
+	for (int r = 1; r <= MAX_RECEIVERS; r++)
+		QTest::newRow(qPrintable(QString("%1 rx").arg(r))) << r;
+}
+
+void tst_IQFrameUnpacker::unpack() {
+
+	QFETCH(int, receivers);
+
+	IQFrameUnpacker unpacker;
+
+	CPX ref[MAX_RECEIVERS];
+	for (int r = 0; r < MAX_RECEIVERS; r++)
+		ref[r].resize(USB_FRAME_MAX_SAMPLES);
+
+	float refMic[USB_FRAME_MAX_SAMPLES];
+
+	foreach (const QByteArray &frame, m_frames) {
+
+		int refSamples = decodeReference(frame, receivers, ref, refMic);
+		int samples = decodeUnpacker(unpacker, frame.constData(), receivers, m_rx, m_mic);
+
+		QCOMPARE(samples, refSamples);
+		QCOMPARE(samples, IQFrameUnpacker::samplesPerFrame(receivers));
+
+		// the unpacker multiplies by the reciprocal of the full scale value
+		for (int r = 0; r < receivers; r++) {
+
+			for (int j = 0; j < samples; j++) {
+
+				QVERIFY(qAbs(m_rx[r][j].re - ref[r][j].re) < 1e-6f);
+				QVERIFY(qAbs(m_rx[r][j].im - ref[r][j].im) < 1e-6f);
+			}
+		}
+
+		for (int j = 0; j < samples; j++)
+			QVERIFY(qAbs(m_mic[j] - refMic[j]) < 1e-6f);
+	}
+}
+
+// One iteration decodes BENCH_FRAMES frames, i.e. BENCH_FRAMES *
+// samplesPerFrame(receivers) * receivers I/Q samples.
+void tst_IQFrameUnpacker::benchmark_data() {
+
+	QTest::addColumn<int>("receivers");
+	QTest::addColumn<bool>("reference");
+
+	for (int r = 1; r <= MAX_RECEIVERS; r++) {
+
+		int samples = BENCH_FRAMES * IQFrameUnpacker::samplesPerFrame(r) * r;
+
+		QTest::newRow(qPrintable(QString("byte decoder, %1 rx (%2 samples)").arg(r).arg(samples))) << r << true;
+		QTest::newRow(qPrintable(QString("unpacker, %1 rx (%2 samples)").arg(r).arg(samples))) << r << false;
+	}
+}
+
+void tst_IQFrameUnpacker::benchmark() {
+
+	QFETCH(int, receivers);
+	QFETCH(bool, reference);
+
+	IQFrameUnpacker unpacker;
+
+	if (reference) {
+
+		QBENCHMARK {
+
+			for (int f = 0; f < BENCH_FRAMES; f++)
+				decodeReference(m_frames.at(f), receivers, m_rx, m_mic);
+		}
+	}
+	else {
+
+		QBENCHMARK {
+
+			for (int f = 0; f < BENCH_FRAMES; f++)
+				decodeUnpacker(unpacker, m_frames.at(f).constData(), receivers, m_rx, m_mic);
+		}
+	}
+}
+
+QTEST_MAIN(tst_IQFrameUnpacker)
+
+#include "tst_iqUnpacker.moc"
@@ -0,0 +1,7 @@
+TARGET = tst_iqUnpacker
+
+include(../tests.pri)
+
+SOURCES += \
+	tst_iqUnpacker.cpp \
+	$$CUSDR_ROOT/src/DataEngine/cusdr_iqUnpacker.cpp
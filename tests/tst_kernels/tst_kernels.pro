@@ -0,0 +1,7 @@
+TARGET = tst_kernels
+
+include(../tests.pri)
+
+SOURCES += \
+	tst_kernels.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_kernels.cpp
@@ -0,0 +1,257 @@
+/**
+* @file  tst_nco.cpp
+* @brief QNco spur level and phase continuity tests
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <QtTest/QtTest>
+
+#include "qtdsp_nco.h"
+
+#include <qmath.h>
+#include <complex>
+
+// FFT length of the spur measurement
+#define NCO_FFT_BITS	16
+#define NCO_FFT_SIZE	(1 << NCO_FFT_BITS)
+
+// bins either side of the carrier taken as its main lobe
+#define NCO_MAIN_LOBE	8
+
+typedef std::complex<double> dcomplex;
+
+
+// in place radix 2 FFT in double precision, so that its own rounding stays
+// far below the spurs of the oscillator
+static void fftDouble(QVector<dcomplex> &x) {
+
+	int n = x.size();
+
+	for (int i = 1, j = 0; i < n; i++) {
+
+		int bit = n >> 1;
+		for (; j & bit; bit >>= 1)
+			j ^= bit;
+		j ^= bit;
+
+		if (i < j)
+			std::swap(x[i], x[j]);
+	}
+
+	for (int len = 2; len <= n; len <<= 1) {
+
+		dcomplex w = std::polar(1.0, -2.0 * M_PI / len);
+
+		for (int i = 0; i < n; i += len) {
+
+			dcomplex wk = 1.0;
+			for (int k = 0; k < len / 2; k++) {
+
+				dcomplex u = x[i + k];
+				dcomplex v = x[i + k + len / 2] * wk;
+
+				x[i + k] = u + v;
+				x[i + k + len / 2] = u - v;
+				wk *= w;
+			}
+		}
+	}
+}
+
+// 7 term Blackman-Harris window, side lobes below -180 dB
+static double window(int i, int n) {
+
+	static const double a[7] = {
+		0.27105140069342, 0.43329793923448, 0.21812299954311, 0.06592544638803,
+		0.01081174209837, 0.00077658482522, 0.00001388721735 };
+
+	double x = 2.0 * M_PI * i / n;
+	double w = 0.0;
+
+	for (int k = 0; k < 7; k++)
+		w += ((k & 1) ? -a[k] : a[k]) * cos(k * x);
+
+	return w;
+}
+
+
+class tst_QNco : public QObject {
+
+	Q_OBJECT
+
+private slots:
+	void sfdr_data();
+	void sfdr();
+	void retune_data();
+	void retune();
+};
+
+// frequencies off the FFT bins and off round phase increments, so that the
+// truncated phase bits take all values
+void tst_QNco::sfdr_data() {
+
+	QTest::addColumn<double>("frequency");
+	QTest::addColumn<double>("sampleRate");
+
+	QTest::newRow("1234.5678 Hz at 48 kHz") << 1234.5678 << 48000.0;
+	QTest::newRow("-17001.3 Hz at 48 kHz") << -17001.3 << 48000.0;
+	QTest::newRow("-12345.678 Hz at 192 kHz") << -12345.678 << 192000.0;
+	QTest::newRow("37003.21 Hz at 384 kHz") << 37003.21 << 384000.0;
+	QTest::newRow("150111.7 Hz at 384 kHz") << 150111.7 << 384000.0;
+}
+
+// The spur free dynamic range is the carrier power over the strongest bin
+// outside its main lobe. QNco documents spurs near -120 dBc.
+void tst_QNco::sfdr() {
+
+	QFETCH(double, frequency);
+	QFETCH(double, sampleRate);
+
+	QNco nco;
+	nco.setFrequency(frequency, sampleRate);
+
+	QVector<cpx> in(NCO_FFT_SIZE);
+	QVector<cpx> out(NCO_FFT_SIZE);
+	for (int i = 0; i < NCO_FFT_SIZE; i++) {
+
+		in[i].re = 1.0f;
+		in[i].im = 0.0f;
+	}
+
+	// in blocks of the receiver size, the phase carried across the calls
+	for (int i = 0; i < NCO_FFT_SIZE; i += 1024)
+		nco.mix(in.constData() + i, out.data() + i, 1024);
+
+	QVector<dcomplex> x(NCO_FFT_SIZE);
+	for (int i = 0; i < NCO_FFT_SIZE; i++)
+		x[i] = dcomplex(out.at(i).re, out.at(i).im) * window(i, NCO_FFT_SIZE);
+
+	fftDouble(x);
+
+	int carrier = qRound(frequency / sampleRate * NCO_FFT_SIZE);
+	if (carrier < 0) carrier += NCO_FFT_SIZE;
+
+	double carrierPower = 0.0;
+	double spurPower = 0.0;
+
+	for (int k = 0; k < NCO_FFT_SIZE; k++) {
+
+		int d = qAbs(k - carrier);
+		d = qMin(d, NCO_FFT_SIZE - d);
+
+		double p = std::norm(x.at(k));
+		if (d <= NCO_MAIN_LOBE)
+			carrierPower += p;
+		else
+			spurPower = qMax(spurPower, p);
+	}
+
+	double sfdr = 10.0 * log10(carrierPower / spurPower);
+
+	qDebug() << "SFDR:" << sfdr << "dB";
+	QVERIFY(sfdr > 115.0);
+}
+
+void tst_QNco::retune_data() {
+
+	QTest::addColumn<double>("from");
+	QTest::addColumn<double>("to");
+
+	QTest::newRow("up") << 1000.0 << 23456.7;
+	QTest::newRow("down through zero") << 5000.0 << -7777.7;
+	QTest::newRow("small step") << 10000.0 << 10000.5;
+	QTest::newRow("to zero") << -20000.0 << 0.0;
+}
+
+// setFrequency() in the middle of a stream must only change the phase step:
+// the phase of every output sample matches the running sum of the increments
+// in effect, and the step across the retune is the old increment.
+void tst_QNco::retune() {
+
+	QFETCH(double, from);
+	QFETCH(double, to);
+
+	const double sampleRate = 48000.0;
+	const int blocks[4] = { 1024, 333, 1024, 77 };
+
+	QNco nco;
+	nco.setFrequency(from, sampleRate);
+
+	QVector<cpx> in(1024);
+	QVector<cpx> out(1024);
+	for (int i = 0; i < in.size(); i++) {
+
+		in[i].re = 1.0f;
+		in[i].im = 0.0f;
+	}
+
+	// the exact phase in turns, modulo 1
+	double phase = 0.0;
+	double worst = 0.0;
+	double lastStep = 0.0;
+	dcomplex last;
+
+	for (int b = 0; b < 4; b++) {
+
+		// retune after the first block and back after the third
+		if (b == 1)
+			nco.setFrequency(to, sampleRate);
+		else if (b == 3)
+			nco.setFrequency(from, sampleRate);
+
+		double step = nco.increment() / 4294967296.0;
+
+		nco.mix(in.constData(), out.data(), blocks[b]);
+
+		for (int i = 0; i < blocks[b]; i++) {
+
+			dcomplex z(out.at(i).re, out.at(i).im);
+
+			double error = qAbs(std::arg(z * std::polar(1.0, -2.0 * M_PI * phase)));
+			worst = qMax(worst, error);
+
+			QVERIFY(qAbs(std::abs(z) - 1.0) < 1e-5);
+
+			// no jump: the first sample of a block still moved by the
+			// increment of the one before
+			if (i == 0 && b > 0) {
+
+				double delta = std::arg(z * std::conj(last) * std::polar(1.0, -2.0 * M_PI * lastStep));
+				QVERIFY(qAbs(delta) < 1e-5);
+			}
+
+			phase += step;
+			phase -= floor(phase);
+		}
+
+		last = dcomplex(out.at(blocks[b] - 1).re, out.at(blocks[b] - 1).im);
+		lastStep = step;
+	}
+
+	qDebug() << "worst phase error:" << worst << "rad";
+	QVERIFY(worst < 1e-5);
+}
+
+QTEST_MAIN(tst_QNco)
+
+#include "tst_nco.moc"
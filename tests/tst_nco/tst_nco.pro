@@ -0,0 +1,7 @@
+TARGET = tst_nco
+
+include(../tests.pri)
+
+SOURCES += \
+	tst_nco.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_nco.cpp
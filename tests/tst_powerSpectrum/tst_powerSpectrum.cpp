@@ -0,0 +1,116 @@
+/**
+* @file  tst_powerSpectrum.cpp
+* @brief PowerSpectrum startup benchmark
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <QtTest/QtTest>
+
+#include "qtdsp_powerSpectrum.h"
+#include "qtdsp_dspEngine.h"
+
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+
+// resident set size in bytes, -1 where not available
+static qint64 residentBytes() {
+
+#if defined(Q_OS_LINUX)
+	QFile statm("/proc/self/statm");
+	if (!statm.open(QIODevice::ReadOnly)) return -1;
+
+	QList<QByteArray> fields = statm.readAll().split(' ');
+	if (fields.size() < 2) return -1;
+
+	return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+#else
+	return -1;
+#endif
+}
+
+
+/*
+	What a receiver costs at startup for its panadapter spectra. The
+	QDSPEngine constructor used to build all SPECTRUM_SIZES PowerSpectrum
+	objects (FFT sizes 4096 .. 262144, each planned with FFTW_MEASURE); it
+	now builds none and the plan thread builds the requested size. The FFTW
+	wisdom is dropped before each row, so every size is measured as on a
+	first start without a wisdom file.
+*/
+class tst_PowerSpectrum : public QObject {
+
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+
+	void startup_data();
+	void startup();
+};
+
+void tst_PowerSpectrum::initTestCase() {
+
+	Settings::instance();
+}
+
+void tst_PowerSpectrum::startup_data() {
+
+	QTest::addColumn<int>("sizes");
+
+	QTest::newRow("requested size only (now)") << 1;
+	QTest::newRow("all sizes (before)") << SPECTRUM_SIZES;
+}
+
+void tst_PowerSpectrum::startup() {
+
+	QFETCH(int, sizes);
+
+	fftwf_forget_wisdom();
+
+	qint64 rss = residentBytes();
+
+	QElapsedTimer timer;
+	timer.start();
+
+	// the sizes QDSPEngine hands to the plan thread for multiplier 1 << i
+	QList<PowerSpectrum *> spectra;
+	for (int i = 0; i < sizes; i++)
+		spectra.append(new PowerSpectrum(0, BUFFER_SIZE * (2 << i)));
+
+	qint64 elapsed = timer.elapsed();
+
+	if (rss >= 0)
+		qDebug() << QTest::currentDataTag() << ":" << elapsed << "ms," << (residentBytes() - rss) / 1024 << "kB resident";
+	else
+		qDebug() << QTest::currentDataTag() << ":" << elapsed << "ms";
+
+	qDeleteAll(spectra);
+
+	QTest::setBenchmarkResult(elapsed, QTest::WalltimeMilliseconds);
+}
+
+QTEST_MAIN(tst_PowerSpectrum)
+
+#include "tst_powerSpectrum.moc"
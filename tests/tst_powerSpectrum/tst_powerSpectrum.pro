@@ -0,0 +1,16 @@
+TARGET = tst_powerSpectrum
+
+include(../tests.pri)
+
+HEADERS += \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_fft.h \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_filter.h \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_powerSpectrum.h
+
+SOURCES += \
+	tst_powerSpectrum.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_fft.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_filter.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_kernels.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_powerAverager.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_powerSpectrum.cpp
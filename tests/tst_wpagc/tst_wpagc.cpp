@@ -0,0 +1,178 @@
+/**
+* @file  tst_wpagc.cpp
+* @brief QWPAGC recorded vector test and benchmark
+* @author cuSDR contributors
+* @version 0.1
+* @date 2026-10-17
+*/
+
+/*
+ *   Copyright 2026 cuSDR contributors
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU Library General Public License version 2 as
+ *   published by the Free Software Foundation
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU Library General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <QtTest/QtTest>
+
+#include "qtdsp_wpagc.h"
+
+#define AGC_BLOCK		1024
+#define AGC_BLOCKS		64
+
+
+/*
+	data/wpagc_in.bin and data/wpagc_out.bin hold AGC_BLOCKS blocks of
+	AGC_BLOCK samples as float re, im pairs, little endian. The input is a
+	carrier at 48 kHz whose amplitude steps every 2400 samples between a
+	steady 0.8, a weak 0.01 and a slowly modulated 0.3, plus noise, with 50
+	samples clipped to 1 + 1j in every seventh block (peaks that tie).
+
+	wpagc_out.bin was recorded with the scanning ProcessAGC() from before the
+	monotonic deque, built with gcc -O2 for x86-64 (SSE2 double qreal), and
+	the settings changed between blocks as in setupAgc() and vectors().
+*/
+class tst_QWPAGC : public QObject {
+
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+
+	void vectors();
+
+	void benchmark_data();
+	void benchmark();
+
+private:
+	CPX		m_in;
+	CPX		m_out;
+
+	void	setupAgc(QWPAGC &agc);
+	bool	readVector(const QString &name, CPX &vector);
+};
+
+bool tst_QWPAGC::readVector(const QString &name, CPX &vector) {
+
+	QFile file(QString(TST_WPAGC_DATA) + "/" + name);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	QByteArray data = file.readAll();
+	if (data.size() != AGC_BLOCKS * AGC_BLOCK * (int) sizeof(cpx))
+		return false;
+
+	vector.resize(AGC_BLOCKS * AGC_BLOCK);
+	memcpy(vector.data(), data.constData(), data.size());
+
+	return true;
+}
+
+void tst_QWPAGC::initTestCase() {
+
+	QVERIFY(readVector("wpagc_in.bin", m_in));
+	QVERIFY(readVector("wpagc_out.bin", m_out));
+}
+
+void tst_QWPAGC::setupAgc(QWPAGC &agc) {
+
+	agc.setSampleRate(0, 48000);
+	agc.setMode(agcMED);
+	agc.setMaximumGainDb(80);
+}
+
+// The deque must pick the same peaks as the rescan did, ties included, so
+// every output sample has to match the recording bit for bit.
+void tst_QWPAGC::vectors() {
+
+	QWPAGC agc(0, AGC_BLOCK);
+	setupAgc(agc);
+
+	CPX in(AGC_BLOCK);
+	CPX out(AGC_BLOCK);
+
+	for (int b = 0; b < AGC_BLOCKS; b++) {
+
+		if (b == 16) agc.setMode(agcSLOW);
+		if (b == 28) agc.setHangThresh(0.3);
+		if (b == 40) agc.setMode(agcFAST);
+		if (b == 52) agc.setVarGainDb(10);
+
+		memcpy(in.data(), m_in.constData() + b * AGC_BLOCK, AGC_BLOCK * sizeof(cpx));
+		agc.ProcessAGC(in, out, AGC_BLOCK);
+
+		const cpx *expected = m_out.constData() + b * AGC_BLOCK;
+
+		for (int i = 0; i < AGC_BLOCK; i++) {
+
+			if (memcmp(&out.at(i), &expected[i], sizeof(cpx)) != 0) {
+
+				QString msg = QString("block %1, sample %2: (%3, %4), recorded (%5, %6)")
+					.arg(b).arg(i)
+					.arg(out.at(i).re, 0, 'g', 9).arg(out.at(i).im, 0, 'g', 9)
+					.arg(expected[i].re, 0, 'g', 9).arg(expected[i].im, 0, 'g', 9);
+
+				QFAIL(qPrintable(msg));
+			}
+		}
+	}
+}
+
+// One iteration is one block of AGC_BLOCK samples. A constant carrier keeps
+// the peak at the far end of the attack window, the case the old rescan
+// handled worst.
+void tst_QWPAGC::benchmark_data() {
+
+	QTest::addColumn<bool>("carrier");
+
+	QTest::newRow("recorded vector") << false;
+	QTest::newRow("constant carrier") << true;
+}
+
+void tst_QWPAGC::benchmark() {
+
+	QFETCH(bool, carrier);
+
+	QWPAGC agc(0, AGC_BLOCK);
+	setupAgc(agc);
+
+	CPX in(AGC_BLOCK);
+	CPX out(AGC_BLOCK);
+
+	if (carrier) {
+
+		for (int i = 0; i < AGC_BLOCK; i++) {
+
+			in[i].re = 0.5f;
+			in[i].im = 0.0f;
+		}
+	}
+
+	int b = 0;
+
+	QBENCHMARK {
+
+		if (!carrier) {
+
+			memcpy(in.data(), m_in.constData() + b * AGC_BLOCK, AGC_BLOCK * sizeof(cpx));
+			b = (b + 1) % AGC_BLOCKS;
+		}
+
+		agc.ProcessAGC(in, out, AGC_BLOCK);
+	}
+}
+
+QTEST_MAIN(tst_QWPAGC)
+
+#include "tst_wpagc.moc"
@@ -0,0 +1,13 @@
+TARGET = tst_wpagc
+
+include(../tests.pri)
+
+# the recorded input and output vectors
+DEFINES += TST_WPAGC_DATA=\\\"$$PWD/data\\\"
+
+HEADERS += \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_wpagc.h
+
+SOURCES += \
+	tst_wpagc.cpp \
+	$$CUSDR_ROOT/src/QtDSP/qtdsp_wpagc.cpp